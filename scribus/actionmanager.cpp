@@ -821,6 +821,8 @@ void ActionManager::initToolsMenuActions()
 	scrActions->insert(name, new ScrAction("", defaultKey(name), mainWindow));
 	name="toolsInline";
 	scrActions->insert(name, new ScrAction("", defaultKey(name), mainWindow));
+	name="toolsLayoutProfile";
+	scrActions->insert(name, new ScrAction("", defaultKey(name), mainWindow));
 	name="toolsToolbarTools";
 	scrActions->insert(name, new ScrAction("", defaultKey(name), mainWindow));
 	name="toolsToolbarPDF";
@@ -912,6 +914,7 @@ void ActionManager::initToolsMenuActions()
 	(*scrActions)["toolsAlignDistribute"]->setShortcutContext(Qt::ApplicationShortcut);
 	(*scrActions)["toolsSymbols"]->setShortcutContext(Qt::ApplicationShortcut);
 	(*scrActions)["toolsInline"]->setShortcutContext(Qt::ApplicationShortcut);
+	(*scrActions)["toolsLayoutProfile"]->setShortcutContext(Qt::ApplicationShortcut);
 
 
 	(*scrActions)["toolsProperties"]->setToggleAction(true);
@@ -928,6 +931,7 @@ void ActionManager::initToolsMenuActions()
 	(*scrActions)["toolsAlignDistribute"]->setToggleAction(true);
 	(*scrActions)["toolsSymbols"]->setToggleAction(true);
 	(*scrActions)["toolsInline"]->setToggleAction(true);
+	(*scrActions)["toolsLayoutProfile"]->setToggleAction(true);
 	(*scrActions)["toolsToolbarTools"]->setToggleAction(true);
 	(*scrActions)["toolsToolbarPDF"]->setToggleAction(true);
 	(*scrActions)["toolsToolbarView"]->setToggleAction(true);
@@ -1694,6 +1698,7 @@ void ActionManager::languageChange()
 	(*scrActions)["toolsAlignDistribute"]->setTexts( tr("&Align and Distribute"));
 	(*scrActions)["toolsSymbols"]->setTexts( tr("Symbols"));
 	(*scrActions)["toolsInline"]->setTexts( tr("Inline Items"));
+	(*scrActions)["toolsLayoutProfile"]->setTexts( tr("Layout Profile"));
 	(*scrActions)["toolsToolbarTools"]->setTexts( tr("&Tools"));
 	(*scrActions)["toolsToolbarPDF"]->setTexts( tr("P&DF Tools"));
 	(*scrActions)["toolsToolbarView"]->setTexts( tr("&View Tools"));
@@ -2367,6 +2372,7 @@ void ActionManager::createDefaultMenus()
 		<< "toolsAlignDistribute"
 		<< "toolsSymbols"
 		<< "toolsInline"
+		<< "toolsLayoutProfile"
 		<< "toolsToolbarTools"
 		<< "toolsToolbarPDF"
 		<< "toolsToolbarView";
@@ -91,6 +91,12 @@ void DeferredTask::done()
 	emit finished();
 }
 
+void DeferredTask::setNextInterval(int msecs)
+{
+	if (m_timer->interval() != msecs)
+		m_timer->setInterval(msecs);
+}
+
 void DeferredTask::runUntilFinished()
 {
 	Q_ASSERT(m_status == Status_Running);
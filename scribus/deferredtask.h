@@ -116,6 +116,11 @@ protected:
 	calls from a signal can not be guaranteed. */
 	void done();
 
+	/*! \brief Change the time between calls of next() while running. 0, the
+	default, calls next() whenever the event loop is idle. A longer interval
+	lets a task wait for something without keeping the CPU busy. */
+	void setNextInterval(int msecs);
+
 private:
 	/*! \brief Status code indicating whether we're running, not yet started, failed,
 	etc. */
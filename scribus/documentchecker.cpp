@@ -95,6 +95,8 @@ bool DocumentChecker::checkDocument(ScribusDoc *currDoc, const QString& checkerP
 	currDoc->docItemErrors.clear();
 	currDoc->masterItemErrors.clear();
 	currDoc->docLayerErrors.clear();
+	// overflow and font checks need the layout of every frame
+	currDoc->layoutDeferredTextFrames();
 
 	checkPages(currDoc, checkerSettings);
 	checkLayers(currDoc, checkerSettings);
@@ -29,18 +29,91 @@ for which a new license (GPL+exception) is in place.
 #include <QCursor>
 #include <QCheckBox>
 #include <QByteArray>
+#include <QFile>
+#include <QPointer>
+#include <QThread>
+#include <QVector>
 
 #include "langmgr.h"
 #include "scpaths.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
+#include "text/layoutprofiler.h"
 #include "prefsfile.h"
 #include "prefsmanager.h"
 
+namespace
+{
+	// Words cached per dictionary before the cache is dropped
+	const int maxCachedWords = 50000;
+
+	// Returns the hnj hyphenation points of word, or a null array on failure
+	QByteArray computeHyphens(HyphenDict *dict, QTextCodec *codec, const QString& word)
+	{
+		LayoutProfileTimer profileTimer(LayoutProfiler::Hyphenation);
+		QByteArray te = codec->fromUnicode(word);
+		QByteArray hyphens(te.length() + 5, '\0');
+		char **rep = nullptr;
+		int *pos = nullptr;
+		int *cut = nullptr;
+		bool ok = false;
+		// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
+		if (!hnj_hyphen_hyphenate2(dict, te.data(), te.length(), hyphens.data(), nullptr, &rep, &pos, &cut))
+		{
+			// the spare bytes leave room for exceptions, see applySpecialWord()
+			hyphens[te.length()] = '\0';
+			ok = true;
+		}
+		if (rep)
+		{
+			for (int i = 0; i < te.length() - 1; ++i)
+				free(rep[i]);
+		}
+		free(rep);
+		free(pos);
+		free(cut);
+		return ok ? hyphens : QByteArray();
+	}
+}
+
+/*!
+Hyphenates the words of a story snapshot on a worker thread. The words and
+their dictionaries are collected by the GUI thread, the dictionaries stay
+loaded until the Hyphenator is destroyed, which waits for running jobs.
+*/
+class HyphenationJob : public QThread
+{
+public:
+	struct Word
+	{
+		int pos;
+		int length;
+		QString text;
+		QString lower;
+		Hyphenator::Dictionary *dictionary;
+		QByteArray hyphens;
+		bool cached;
+	};
+
+	QPointer<PageItem> item;
+	QString text;
+	QVector<Word> words;
+
+protected:
+	void run()
+	{
+		for (int i = 0; i < words.count(); ++i)
+		{
+			Word& word = words[i];
+			if (!word.cached)
+				word.hyphens = computeHyphens(word.dictionary->dict, word.dictionary->codec, word.lower);
+		}
+	}
+};
+
 Hyphenator::Hyphenator(QWidget* parent, ScribusDoc *dok) : QObject( parent ),
 	m_doc(dok),
-	m_hdict(nullptr),
-	m_codec(nullptr),
+	m_dictionary(nullptr),
 	m_automatic(m_doc->hyphAutomatic()),
 	AutoCheck(m_doc->hyphAutoCheck())
 {
@@ -52,36 +125,99 @@ Hyphenator::Hyphenator(QWidget* parent, ScribusDoc *dok) : QObject( parent ),
 
 Hyphenator::~Hyphenator()
 {
-	if (m_hdict)
-		hnj_hyphen_free(m_hdict);
+	for (HyphenationJob* job : m_jobs)
+	{
+		job->wait();
+		delete job;
+	}
+	for (Dictionary* dictionary : m_dictionaries)
+	{
+		if (dictionary)
+		{
+			hnj_hyphen_free(dictionary->dict);
+			delete dictionary;
+		}
+	}
 }
 
 bool Hyphenator::loadDict(const QString& name)
 {
-	if (LanguageManager::instance()->getHyphFilename(name).isEmpty())
-		return false;
-		
-	if (m_language != name)
+	if (m_language == name && m_dictionary != nullptr)
+		return true;
+	m_language = name;
+
+	// Switching languages used to reload the dictionary from disk, keep them all instead
+	QHash<QString, Dictionary*>::const_iterator it = m_dictionaries.constFind(name);
+	if (it != m_dictionaries.constEnd())
 	{
-		m_language = name;
+		m_dictionary = it.value();
+		return (m_dictionary != nullptr);
+	}
 
-		QFile file(LanguageManager::instance()->getHyphFilename(m_language));
-		
-		if (m_hdict != nullptr)
-			hnj_hyphen_free(m_hdict);
+	m_dictionary = nullptr;
+	QString fileName = LanguageManager::instance()->getHyphFilename(name);
+	if (fileName.isEmpty())
+		return false;
 
-		if (file.open(QIODevice::ReadOnly))
+	QFile file(fileName);
+	if (file.open(QIODevice::ReadOnly))
+	{
+		QTextCodec* codec = QTextCodec::codecForName(file.readLine());
+		file.close();
+		HyphenDict* dict = hnj_hyphen_load(file.fileName().toLocal8Bit().data());
+		if (codec && dict)
 		{
-			m_codec = QTextCodec::codecForName(file.readLine());
-			m_hdict = hnj_hyphen_load(file.fileName().toLocal8Bit().data());
-			file.close();
-			return true;
+			m_dictionary = new Dictionary;
+			m_dictionary->dict = dict;
+			m_dictionary->codec = codec;
+			m_dictionary->locale = QLocale(name);
 		}
-		m_hdict = nullptr;
-		return false;
+		else if (dict)
+			hnj_hyphen_free(dict);
 	}
+	m_dictionaries.insert(name, m_dictionary);
+	return (m_dictionary != nullptr);
+}
+
+QByteArray Hyphenator::hyphenate(const QString& wordLower)
+{
+	QHash<QString, QByteArray>::const_iterator it = m_dictionary->words.constFind(wordLower);
+	if (LayoutProfiler::isEnabled())
+		LayoutProfiler::instance().countLookup(LayoutProfiler::HyphenationLookup, it != m_dictionary->words.constEnd());
+	if (it != m_dictionary->words.constEnd())
+		return it.value();
+	QByteArray hyphens = computeHyphens(m_dictionary->dict, m_dictionary->codec, wordLower);
+	cacheWord(m_dictionary, wordLower, hyphens);
+	return hyphens;
+}
 
-	return (m_codec != nullptr && m_hdict != nullptr);
+void Hyphenator::cacheWord(Dictionary *dictionary, const QString& wordLower, const QByteArray& hyphens)
+{
+	if (hyphens.isNull())
+		return;
+	if (dictionary->words.count() >= maxCachedWords)
+		dictionary->words.clear();
+	dictionary->words.insert(wordLower, hyphens);
+}
+
+void Hyphenator::applySpecialWord(const QString& word, char* hyphens) const
+{
+	QHash<QString, QString>::const_iterator it = specialWords.constFind(word);
+	if (it == specialWords.constEnd())
+		return;
+	const QString& outs = it.value();
+	uint ii = 1;
+	for (int i = 1; i < outs.length()-1; ++i)
+	{
+		QChar cht = outs[i];
+		if (cht == '-')
+			hyphens[ii-1] = 1;
+		else
+		{
+			hyphens[ii] = 0;
+			++ii;
+		}
+	}
 }
 
 void Hyphenator::slotNewSettings(bool Autom, bool ACheck)
@@ -104,28 +240,9 @@ void Hyphenator::slotHyphenateWord(PageItem* it, const QString& text, int firstC
 	if (!ok)
 		return;
 
-	QByteArray te = m_codec->fromUnicode(text);
-	char *buffer = static_cast<char*>(malloc(te.length() + 5));
-	if (buffer == nullptr)
-		return;
-	char **rep = nullptr;
-	int *pos = nullptr;
-	int *cut = nullptr;
-	// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-	if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
-	{
-		buffer[te.length()] = '\0';
-		it->itemText.hyphenateWord(firstC, text.length(), buffer);
-	}
-	free(buffer);
-	if (rep)
-	{
-		for (int i = 0; i < te.length() - 1; ++i)
-			free(rep[i]);
-	}
-	free(rep);
-	free(pos);
-	free(cut);
+	QByteArray hyphens = hyphenate(text);
+	if (!hyphens.isNull())
+		it->itemText.hyphenateWord(firstC, text.length(), hyphens.constData());
 }
 
 void Hyphenator::slotHyphenate(PageItem* it)
@@ -163,27 +280,18 @@ void Hyphenator::slotHyphenate(PageItem* it)
 		if (countC > 0 && countC > style.hyphenWordMin() - 1)
 		{
 			QString word = text.mid(firstC, countC);
-			QString wordLower = QLocale(style.language()).toLower(word);
+			bool ok = loadDict(style.language());
+			QString wordLower = ok ? m_dictionary->locale.toLower(word) : QLocale(style.language()).toLower(word);
 			if (wordLower.contains(SpecialChars::SHYPHEN))
 				break;
-
-			bool ok = loadDict(style.language());
 			if (!ok)
 				continue;
 
-			QByteArray te = m_codec->fromUnicode(wordLower);
-			char *buffer = static_cast<char*>(malloc(te.length() + 5));
-			if (buffer == nullptr)
-				break;
-
-			char **rep = nullptr;
-			int *pos = nullptr;
-			int *cut = nullptr;
-			// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-			if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
+			QByteArray hyphens = hyphenate(wordLower);
+			if (!hyphens.isNull())
 			{
+				char *buffer = hyphens.data();
 	  			int i = 0;
-				buffer[te.length()] = '\0';
 				bool hasHyphen = false;
 				for (i = 1; i < wordLower.length()-1; ++i)
 				{
@@ -210,42 +318,12 @@ void Hyphenator::slotHyphenate(PageItem* it)
 						it->itemText.hyphenateWord(startC + firstC, wordLower.length(), nullptr);
 					else if (m_automatic)
 					{
-						if (specialWords.contains(word))
-						{
-							outs = specialWords.value(word);
-							uint ii = 1;
-							for (i = 1; i < outs.length()-1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii-1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-						}
+						applySpecialWord(word, buffer);
 						it->itemText.hyphenateWord(startC + firstC, wordLower.length(), buffer);
 					}
 					else
 					{
-						if (specialWords.contains(word))
-						{
-							outs = specialWords.value(word);
-							uint ii = 1;
-							for (i = 1; i < outs.length()-1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii-1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-						}
+						applySpecialWord(word, buffer);
 						if (rememberedWords.contains(input))
 						{
 							outs = rememberedWords.value(input);
@@ -304,8 +382,6 @@ void Hyphenator::slotHyphenate(PageItem* it)
 							}
 							else
 							{
-								free(buffer);
-								buffer = nullptr;
 								prefs->set("Xposition", dia->xpos);
 								prefs->set("Yposition", dia->ypos);
 								delete dia;
@@ -319,15 +395,6 @@ void Hyphenator::slotHyphenate(PageItem* it)
 					}
 				}
 			}
-			free(buffer);
-			if (rep)
-			{
-				for (int i = 0; i < te.length() - 1; ++i)
-					free(rep[i]);
-			}
-			free(rep);
-			free(pos);
-			free(cut);
 		}
 	}
 	qApp->restoreOverrideCursor();
@@ -335,6 +402,95 @@ void Hyphenator::slotHyphenate(PageItem* it)
 	rememberedWords.clear();
 }
 
+void Hyphenator::hyphenateInBackground(PageItem* it)
+{
+	if (!(it->asTextFrame()) || (it->itemText.length() == 0))
+		return;
+	if (!m_automatic)
+	{
+		slotHyphenate(it);
+		return;
+	}
+
+	HyphenationJob* job = new HyphenationJob();
+	job->item = it;
+	job->text = it->itemText.text(0, it->itemText.length());
+
+	// Word boundaries, styles and dictionaries are only safe to query here
+	BreakIterator* bi = StoryText::getWordIterator();
+	bi->setText((const UChar*) job->text.utf16());
+	int pos = bi->first();
+	while (pos != BreakIterator::DONE)
+	{
+		int firstC = pos;
+		pos = bi->next();
+		int countC = pos - firstC;
+
+		const CharStyle& style = it->itemText.charStyle(firstC);
+		if (countC <= 0 || countC <= style.hyphenWordMin() - 1)
+			continue;
+		if (!loadDict(style.language()))
+			continue;
+		HyphenationJob::Word word;
+		word.pos = firstC;
+		word.length = countC;
+		word.text = job->text.mid(firstC, countC);
+		word.lower = m_dictionary->locale.toLower(word.text);
+		if (word.lower.contains(SpecialChars::SHYPHEN))
+			break;
+		word.dictionary = m_dictionary;
+		QHash<QString, QByteArray>::const_iterator cached = m_dictionary->words.constFind(word.lower);
+		word.cached = (cached != m_dictionary->words.constEnd());
+		if (LayoutProfiler::isEnabled())
+			LayoutProfiler::instance().countLookup(LayoutProfiler::HyphenationLookup, word.cached);
+		if (word.cached)
+			word.hyphens = cached.value();
+		job->words.append(word);
+	}
+
+	connect(job, &QThread::finished, this, [this, job]() { finishBackgroundHyphenation(job); });
+	m_jobs.append(job);
+	job->start(QThread::LowPriority);
+}
+
+void Hyphenator::finishBackgroundHyphenation(HyphenationJob *job)
+{
+	m_jobs.removeAll(job);
+	PageItem* it = job->item;
+	if (it && it->itemText.text(0, it->itemText.length()) == job->text)
+	{
+		for (int i = 0; i < job->words.count(); ++i)
+		{
+			HyphenationJob::Word& word = job->words[i];
+			if (word.hyphens.isNull() || ignoredWords.contains(word.text))
+				continue;
+			if (!word.cached)
+				cacheWord(word.dictionary, word.lower, word.hyphens);
+			char *buffer = word.hyphens.data();
+			bool hasHyphen = false;
+			for (int j = 1; j < word.lower.length()-1; ++j)
+			{
+				if (buffer[j] & 1)
+				{
+					hasHyphen = true;
+					break;
+				}
+			}
+			if (hasHyphen)
+			{
+				applySpecialWord(word.text, buffer);
+				it->itemText.hyphenateWord(word.pos, word.lower.length(), buffer);
+			}
+			else
+				it->itemText.hyphenateWord(word.pos, word.lower.length(), nullptr);
+		}
+		for (PageItem* frame = it->firstInChain(); frame; frame = frame->nextInChain())
+			frame->invalidateLayout();
+		m_doc->regionsChanged()->update(QRectF());
+	}
+	delete job;
+}
+
 void Hyphenator::slotDeHyphenate(PageItem* it)
 {
 	if (!(it->asTextFrame()) || (it ->itemText.length() == 0))
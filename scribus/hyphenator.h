@@ -10,6 +10,8 @@ for which a new license (GPL+exception) is in place.
 #include <QObject>
 #include <QTextCodec>
 #include <QHash>
+#include <QList>
+#include <QLocale>
 #include <QSet>
 
 #include "scribusapi.h"
@@ -18,6 +20,7 @@ for which a new license (GPL+exception) is in place.
 class ScribusDoc;
 class ScribusMainWindow;
 class PageItem;
+class HyphenationJob;
 
 /*!
 This class is the core of the Scribus hyphenation system.
@@ -46,12 +49,24 @@ public:
 	
 private:
 
+	/*! A loaded dictionary with the words already hyphenated with it. */
+	struct Dictionary
+	{
+		HyphenDict *dict;
+		QTextCodec *codec;
+		QLocale locale;
+		/*! Hyphenation points of lower case words as returned by hnj_hyphen_hyphenate2 */
+		QHash<QString, QByteArray> words;
+	};
+
 	/*! Embedded reference to the \see ScribusDoc filled by \a dok */
 	ScribusDoc *m_doc;
-	/*! Reference to the hyphen dictionary structure. */
-	HyphenDict *m_hdict;
-	/*! Qt text codec which handles local characters. */
-	QTextCodec *m_codec;
+	/*! Dictionaries by language, loaded once. Languages without dictionary map to nullptr. */
+	QHash<QString, Dictionary*> m_dictionaries;
+	/*! Dictionary of the language in use */
+	Dictionary *m_dictionary;
+	/*! Stories being hyphenated in background */
+	QList<HyphenationJob*> m_jobs;
 	/*! Language in use */
 	QString m_language;
 
@@ -59,12 +74,25 @@ private:
 	bool m_automatic;
 
 	/*!
-		\brief Loads dictionary and fills parameters like \a m_codec, \a m_hdict.
+		\brief Makes the dictionary of a language current, loading it on first use.
 	 \date
 	 \author Franz Schmid
 	 \param name is the name of specified language.
 	 */
 	bool loadDict(const QString& name);
+	/*!
+		\brief Returns the hyphenation points of a lower case word with the current dictionary.
+		Results are cached, a null array is returned if the word can't be hyphenated.
+	 */
+	QByteArray hyphenate(const QString& wordLower);
+	/*! Stores hyphenation points computed in background for later use */
+	void cacheWord(Dictionary *dictionary, const QString& wordLower, const QByteArray& hyphens);
+	/*! Overrides hyphenation points with the user's exception for word, if any */
+	void applySpecialWord(const QString& word, char* hyphens) const;
+	/*! Applies the result of hyphenateInBackground() if the story did not change meanwhile */
+	void finishBackgroundHyphenation(HyphenationJob *job);
+
+	friend class HyphenationJob;
 	
 public:
 	/*! Flag - obsolete? */
@@ -101,6 +129,14 @@ public slots:
 	*/
 	void slotHyphenate(PageItem *it);
 	/*!
+	\brief Hyphenates the whole story of \a it on a worker thread.
+	The hyphenation points are applied to the story at once when done, unless the
+	text was changed meanwhile. If hyphenation is not automatic, the user is asked
+	for each word and this is the same as \see slotHyphenate.
+	\param it references \see PageItem - text frame.
+	*/
+	void hyphenateInBackground(PageItem *it);
+	/*!
 	\fn void Hyphenator::slotDeHyphenate(PageItem* it)
 	\brief Removes hyphenation either for the whole text frame or the selected text if there is a selection.
 	\date
@@ -935,11 +935,13 @@ bool ScImgDataLoader_PSD::loadLayerChannels( QDataStream & s, const PSDHeader &
 		}
 	}
 	s.device()->seek( base2 );
+	// Layer thumbnails are only 40 pixels wide, so avoid converting the whole
+	// layer to a QImage and work on a reduced copy instead
 	QImage tmpImg2;
 	if (header.color_mode == CM_CMYK)
-		tmpImg2 = r2_image.convertToQImage(true);
+		tmpImg2 = r2_image.subsampled(160).convertToQImage(true);
 	else
-		tmpImg2 = r2_image.convertToQImage(false);
+		tmpImg2 = r2_image.subsampled(160).convertToQImage(false);
 	QImage imt;
 	double sx = tmpImg2.width() / 40.0;
 	double sy = tmpImg2.height() / 40.0;
@@ -950,7 +952,7 @@ bool ScImgDataLoader_PSD::loadLayerChannels( QDataStream & s, const PSDHeader &
 	{
 		QImage imt2;
 		QImage tmpImg;
-		tmpImg = mask.convertToQImage(true);
+		tmpImg = mask.subsampled(160).convertToQImage(true);
 		double sx = tmpImg.width() / 40.0;
 		double sy = tmpImg.height() / 40.0;
 		imt2 = sy < sx ?  tmpImg.scaled(qRound(tmpImg.width() / sx), qRound(tmpImg.height() / sx), Qt::IgnoreAspectRatio, Qt::SmoothTransformation) :
@@ -9,6 +9,8 @@ for which a new license (GPL+exception) is in place.
 #include <QObject>
 #include <QList>
 
+#include <climits>
+
 #include "scconfig.h"
 #include "colormgmt/sccolormgmtengine.h"
 #include "scimgdataloader_tiff.h"
@@ -24,10 +26,14 @@ static void TagExtender(TIFF *tiff)
 	TIFFMergeFieldInfo(tiff, xtiffFieldInfo, sizeof (xtiffFieldInfo) / sizeof (xtiffFieldInfo[0]));
 }
 
+// Largest raster a RawImage can hold, bigger scans are loaded at a reduced resolution
+static const qint64 maxRasterBytes = INT_MAX;
+
 ScImgDataLoader_TIFF::ScImgDataLoader_TIFF()
 {
 	m_photometric = PHOTOMETRIC_MINISBLACK;
 	m_samplesperpixel = 72;
+	m_reduction = 1;
 
 	initSupportedFormatList();
 }
@@ -264,7 +270,12 @@ bool ScImgDataLoader_TIFF::getImageData(TIFF* tif, RawImage *image, uint widtht,
 		}
 		else
 		{
-			if (TIFFIsTiled(tif))
+			if (TIFFIsTiled(tif) && (m_reduction > 1))
+			{
+				if (!getImageData_ReducedTiles(tif, image, widtht, heightt))
+					return false;
+			}
+			else if (TIFFIsTiled(tif))
 			{
 				uint32 columns, rows;
 				uint32 *tile_buf;
@@ -330,7 +341,7 @@ bool ScImgDataLoader_TIFF::getImageData(TIFF* tif, RawImage *image, uint widtht,
 								}
 							}
 							else */
-								memcpy(image->scanLine(y), bits, chans * widtht);
+								storeRow(image, y, 0, (const uchar*) bits, widtht, chans);
 						}
 					}
 					_TIFFfree(bits);
@@ -354,44 +365,227 @@ bool ScImgDataLoader_TIFF::getImageData(TIFF* tif, RawImage *image, uint widtht,
 bool ScImgDataLoader_TIFF::getImageData_RGBA(TIFF* tif, RawImage *image, uint widtht, uint heightt, uint size, uint16 bitspersample, uint16 samplesperpixel)
 {
 	bool gotData = false;
-	uint32* bits = (uint32 *) _TIFFmalloc(size * sizeof(uint32));
 	uint16  extrasamples(0), *extratypes(nullptr);
 	if (!TIFFGetField (tif, TIFFTAG_EXTRASAMPLES, &extrasamples, &extratypes))
 		extrasamples = 0;
-	if (bits)
+	// Decode line by line, strip by strip or tile by tile so that the temporary
+	// RGBA buffer stays small, huge scans would otherwise need twice their size in memory
+	if (TIFFIsTiled(tif))
+		gotData = getImageData_RGBATiles(tif, image, widtht, heightt);
+	else
+	{
+		gotData = getImageData_Scanlines(tif, image, widtht, heightt, bitspersample, samplesperpixel, extrasamples);
+		if (!gotData)
+			gotData = getImageData_RGBAStrips(tif, image, widtht, heightt);
+	}
+	// The whole image read needs a full size buffer, which is what reduced images avoid
+	if (!gotData && (m_reduction == 1))
 	{
-		if (TIFFReadRGBAImage(tif, widtht, heightt, bits, 0))
+		uint32* bits = (uint32 *) _TIFFmalloc(size * sizeof(uint32));
+		if (bits)
 		{
-			for (unsigned int y = 0; y < heightt; y++)
+			if (TIFFReadRGBAImage(tif, widtht, heightt, bits, 0))
 			{
-				memcpy(image->scanLine(heightt - 1 - y), bits + y * widtht, widtht * image->channels());
-				if (QSysInfo::ByteOrder==QSysInfo::BigEndian)
-				{
-					unsigned char *s = image->scanLine( heightt - 1 - y );
-					unsigned char r, g, b, a;
-					for (uint xi=0; xi < widtht; ++xi)
-					{
-						r = s[0];
-						g = s[1];
-						b = s[2];
-						a = s[3];
-						s[0] = a;
-						s[1] = b;
-						s[2] = g;
-						s[3] = r;
-						s += image->channels();
-					}
-				}
+				for (unsigned int y = 0; y < heightt; y++)
+					copyRGBARow(image, heightt - 1 - y, 0, bits + y * widtht, widtht);
+				gotData = true;
 			}
-			if (extrasamples > 0 && extratypes[0] == EXTRASAMPLE_ASSOCALPHA)
-				unmultiplyRGBA(image);
-			gotData = true;
+			_TIFFfree(bits);
+		}
+	}
+	if (gotData && extrasamples > 0 && extratypes[0] == EXTRASAMPLE_ASSOCALPHA)
+		unmultiplyRGBA(image);
+	return gotData;
+}
+
+bool ScImgDataLoader_TIFF::getImageData_RGBAStrips(TIFF* tif, RawImage *image, uint widtht, uint heightt)
+{
+	uint32 rowsPerStrip = 0;
+	TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+	rowsPerStrip = qMin(qMax(rowsPerStrip, (uint32) 1), (uint32) heightt);
+	uint32* bits = (uint32 *) _TIFFmalloc((tsize_t) widtht * rowsPerStrip * sizeof(uint32));
+	if (!bits)
+		return false;
+	bool gotData = true;
+	for (uint32 row = 0; row < heightt; row += rowsPerStrip)
+	{
+		if (!TIFFReadRGBAStrip(tif, row, bits))
+		{
+			gotData = false;
+			break;
+		}
+		// Strips are returned with their origin at the lower left corner
+		uint32 rows = qMin(rowsPerStrip, heightt - row);
+		for (uint32 y = 0; y < rows; ++y)
+			copyRGBARow(image, row + y, 0, bits + (rows - 1 - y) * widtht, widtht);
+	}
+	_TIFFfree(bits);
+	return gotData;
+}
+
+bool ScImgDataLoader_TIFF::getImageData_RGBATiles(TIFF* tif, RawImage *image, uint widtht, uint heightt)
+{
+	uint32 tileWidth = 0, tileHeight = 0;
+	TIFFGetField(tif, TIFFTAG_TILEWIDTH,  &tileWidth);
+	TIFFGetField(tif, TIFFTAG_TILELENGTH, &tileHeight);
+	if ((tileWidth == 0) || (tileHeight == 0))
+		return false;
+	uint32* bits = (uint32 *) _TIFFmalloc((tsize_t) tileWidth * tileHeight * sizeof(uint32));
+	if (!bits)
+		return false;
+	bool gotData = true;
+	for (uint32 yt = 0; (yt < heightt) && gotData; yt += tileHeight)
+	{
+		uint32 rows = qMin(tileHeight, heightt - yt);
+		for (uint32 xt = 0; xt < widtht; xt += tileWidth)
+		{
+			if (!TIFFReadRGBATile(tif, xt, yt, bits))
+			{
+				gotData = false;
+				break;
+			}
+			// Tiles are returned with their origin at the lower left corner,
+			// partial tiles being moved to the top of the buffer
+			uint32 columns = qMin(tileWidth, widtht - xt);
+			for (uint32 y = 0; y < rows; ++y)
+				copyRGBARow(image, yt + y, xt, bits + (tileHeight - 1 - y) * tileWidth, columns);
+		}
+	}
+	_TIFFfree(bits);
+	return gotData;
+}
+
+bool ScImgDataLoader_TIFF::getImageData_ReducedTiles(TIFF* tif, RawImage *image, uint widtht, uint heightt)
+{
+	uint32 tileWidth = 0, tileHeight = 0;
+	TIFFGetField(tif, TIFFTAG_TILEWIDTH,  &tileWidth);
+	TIFFGetField(tif, TIFFTAG_TILELENGTH, &tileHeight);
+	tsize_t tileSize = TIFFTileSize(tif);
+	int chans = image->channels();
+	if ((tileWidth == 0) || (tileHeight == 0) || (tileSize < (tsize_t) (tileWidth * tileHeight * chans)))
+		return false;
+	uchar* tile = (uchar*) _TIFFmalloc(tileSize);
+	if (tile == nullptr)
+		return false;
+	// only one tile is held at a time, its rows and columns are subsampled into the image
+	for (uint32 yt = 0; yt < heightt; yt += tileHeight)
+	{
+		uint32 rows = qMin(tileHeight, heightt - yt);
+		for (uint32 xt = 0; xt < widtht; xt += tileWidth)
+		{
+			if (TIFFReadTile(tif, tile, xt, yt, 0, 0) < 0)
+				continue;
+			uint32 columns = qMin(tileWidth, widtht - xt);
+			for (uint32 y = 0; y < rows; ++y)
+				storeRow(image, yt + y, xt, tile + y * tileWidth * chans, columns, chans);
 		}
-		_TIFFfree(bits);
 	}
+	_TIFFfree(tile);
+	return true;
+}
+
+bool ScImgDataLoader_TIFF::getImageData_Scanlines(TIFF* tif, RawImage *image, uint widtht, uint heightt, uint16 bitspersample, uint16 samplesperpixel, uint16 extrasamples)
+{
+	// Only plain 8 bit RGB and gray scans, for which the RGBA interface does nothing
+	// but copy samples. Single strip files are common there and the RGBA interface
+	// would need a buffer for the whole strip.
+	uint16 planar = PLANARCONFIG_CONTIG, orientation = ORIENTATION_TOPLEFT;
+	TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planar);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, &orientation);
+	if ((bitspersample != 8) || (extrasamples != 0) || (planar != PLANARCONFIG_CONTIG) || (orientation != ORIENTATION_TOPLEFT))
+		return false;
+	bool rgb = (m_photometric == PHOTOMETRIC_RGB) && (samplesperpixel == 3);
+	bool gray = ((m_photometric == PHOTOMETRIC_MINISBLACK) || (m_photometric == PHOTOMETRIC_MINISWHITE)) && (samplesperpixel == 1);
+	if (!rgb && !gray)
+		return false;
+	uchar* line = (uchar *) _TIFFmalloc(TIFFScanlineSize(tif));
+	uint32* bits = (uint32 *) _TIFFmalloc(widtht * sizeof(uint32));
+	bool gotData = (line != nullptr) && (bits != nullptr);
+	for (uint32 y = 0; (y < heightt) && gotData; ++y)
+	{
+		if (TIFFReadScanline(tif, line, y, 0) < 0)
+		{
+			gotData = false;
+			break;
+		}
+		if ((y % m_reduction) != 0)
+			continue;
+		const uchar* s = line;
+		for (uint32 x = 0; x < widtht; ++x)
+		{
+			if (rgb)
+			{
+				bits[x] = ((uint32) s[0]) | ((uint32) s[1] << 8) | ((uint32) s[2] << 16) | 0xff000000;
+				s += 3;
+			}
+			else
+			{
+				uint32 v = (m_photometric == PHOTOMETRIC_MINISWHITE) ? 255 - *s : *s;
+				bits[x] = v | (v << 8) | (v << 16) | 0xff000000;
+				++s;
+			}
+		}
+		copyRGBARow(image, y, 0, bits, widtht);
+	}
+	if (line)
+		_TIFFfree(line);
+	if (bits)
+		_TIFFfree(bits);
 	return gotData;
 }
 
+void ScImgDataLoader_TIFF::copyRGBARow(RawImage *image, uint32 y, uint32 x, uint32* src, uint count)
+{
+	// Pixels are packed as by TIFFReadRGBAImage, swap them to R, G, B, A bytes
+	if (QSysInfo::ByteOrder == QSysInfo::BigEndian)
+	{
+		unsigned char *s = (unsigned char *) src;
+		unsigned char r, g, b, a;
+		for (uint xi = 0; xi < count; ++xi)
+		{
+			r = s[0];
+			g = s[1];
+			b = s[2];
+			a = s[3];
+			s[0] = a;
+			s[1] = b;
+			s[2] = g;
+			s[3] = r;
+			s += 4;
+		}
+	}
+	storeRow(image, y, x, (const uchar*) src, count, 4);
+}
+
+void ScImgDataLoader_TIFF::storeRow(RawImage *image, uint32 y, uint32 x, const uchar* src, uint count, int srcPixelBytes)
+{
+	int chans = image->channels();
+	if (m_reduction == 1)
+	{
+		if (srcPixelBytes == chans)
+			memcpy(image->scanLine(y) + x * chans, src, count * chans);
+		else
+		{
+			uchar* dst = image->scanLine(y) + x * chans;
+			for (uint i = 0; i < count; ++i)
+				memcpy(dst + i * chans, src + i * srcPixelBytes, chans);
+		}
+		return;
+	}
+	// Reduced images keep every m_reduction-th pixel of every m_reduction-th row
+	if ((y % m_reduction) != 0)
+		return;
+	uchar* dst = image->scanLine(y / m_reduction);
+	uint32 first = ((x + m_reduction - 1) / m_reduction) * m_reduction;
+	for (uint32 sx = first; sx < x + count; sx += m_reduction)
+	{
+		int dx = sx / m_reduction;
+		if (dx >= image->width())
+			break;
+		memcpy(dst + dx * chans, src + (sx - x) * srcPixelBytes, chans);
+	}
+}
+
 void ScImgDataLoader_TIFF::blendOntoTarget(RawImage *tmp, int layOpa, const QString& layBlend, bool cmyk, bool useMask)
 {
 	if (layBlend == "diss")
@@ -674,6 +868,7 @@ bool ScImgDataLoader_TIFF::loadPicture(const QString& fn, int page, int res, boo
 	}
 
 	initialize();
+	m_reduction = 1;
 
 	int test;
 	bool valid = m_imageInfoRecord.isRequest;
@@ -824,7 +1019,11 @@ bool ScImgDataLoader_TIFF::loadPicture(const QString& fn, int page, int res, boo
 	unsigned int PhotoshopLen2 = 0;
 	unsigned char* PhotoshopBuffer2;
 	int gotField = TIFFGetField(tif, 37724, &PhotoshopLen2, &PhotoshopBuffer2);
-	if (gotField && (PhotoshopLen2 > 40))
+	// Photoshop layers are decoded and composited at full size, images too big
+	// for that are loaded from their flattened image, which can be reduced
+	int layerChans = (m_photometric == PHOTOMETRIC_SEPARATED) ? 5 : 4;
+	bool layersFit = ((qint64) widtht * heightt * layerChans <= maxRasterBytes);
+	if (gotField && (PhotoshopLen2 > 40) && layersFit)
 	{
 		m_imageInfoRecord.layerInfo.clear();
 		QByteArray arrayPhot = QByteArray::fromRawData((const char*)PhotoshopBuffer2, PhotoshopLen2);
@@ -903,7 +1102,13 @@ bool ScImgDataLoader_TIFF::loadPicture(const QString& fn, int page, int res, boo
 		}
 		else
 			chans = 4;
-		if (!r_image.create(widtht, heightt, chans))
+		// Scans too big for a raster are loaded with every n-th pixel only,
+		// the resolution is reduced accordingly so that the image keeps its size
+		while ((qint64) ((widtht + m_reduction - 1) / m_reduction) * ((heightt + m_reduction - 1) / m_reduction) * chans > maxRasterBytes)
+			++m_reduction;
+		int imageWidth = (widtht + m_reduction - 1) / m_reduction;
+		int imageHeight = (heightt + m_reduction - 1) / m_reduction;
+		if (!r_image.create(imageWidth, imageHeight, chans))
 		{
 			TIFFClose(tif);
 			return false;
@@ -913,7 +1118,7 @@ bool ScImgDataLoader_TIFF::loadPicture(const QString& fn, int page, int res, boo
 		do
 		{
 			RawImage tmpImg;
-			if (!tmpImg.create(widtht, heightt, chans))
+			if (!tmpImg.create(imageWidth, imageHeight, chans))
 			{
 				TIFFClose(tif);
 				return false;
@@ -946,9 +1151,9 @@ bool ScImgDataLoader_TIFF::loadPicture(const QString& fn, int page, int res, boo
 			}
 			//JG Copy should not be necessary as QImage is implicitly shared in Qt4
 			QImage imt; //QImage imt = tmpImg.copy();
-			double sx = tmpImg.width() / 40.0;
-			double sy = tmpImg.height() / 40.0;
-			imt = tmpImg.convertToQImage(chans > 4);
+			imt = tmpImg.subsampled(160).convertToQImage(chans > 4);
+			double sx = imt.width() / 40.0;
+			double sy = imt.height() / 40.0;
 			imt = sy < sx ?	imt.scaled(qRound(imt.width() / sx), qRound(imt.height() / sx), Qt::IgnoreAspectRatio, Qt::SmoothTransformation) :
 										imt.scaled(qRound(imt.width() / sy), qRound(imt.height() / sy), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
 			m_imageInfoRecord.layerInfo[layerNum].thumb = imt.copy();
@@ -982,6 +1187,8 @@ bool ScImgDataLoader_TIFF::loadPicture(const QString& fn, int page, int res, boo
 		}
 		while (test == 1);
 		TIFFClose(tif);
+		xres /= m_reduction;
+		yres /= m_reduction;
 	}
 	if (resolutionunit == RESUNIT_INCH)
 	{
@@ -997,6 +1204,14 @@ bool ScImgDataLoader_TIFF::loadPicture(const QString& fn, int page, int res, boo
 		m_imageInfoRecord.xres = qRound(xres*2.54);
 		m_imageInfoRecord.yres = qRound(yres*2.54);
 	}
+	else if (m_reduction > 1)
+	{
+		// Without resolution unit images are 72 dpi, reduced ones must keep their size
+		m_image.setDotsPerMeterX ((int) (xres / 0.0254));
+		m_image.setDotsPerMeterY ((int) (yres / 0.0254));
+		m_imageInfoRecord.xres = qMax(1, qRound(xres));
+		m_imageInfoRecord.yres = qMax(1, qRound(yres));
+	}
 	if (isCMYK)
 	{
 		m_imageInfoRecord.colorspace = ColorSpaceCMYK;
@@ -1415,11 +1630,13 @@ bool ScImgDataLoader_TIFF::loadLayerChannels( QDataStream & s, const PSDHeader &
 		base2 += layerInfo[layer].channelLen[channel];
 	}
 	s.device()->seek( base2 );
+	// Layer thumbnails are only 40 pixels wide, so avoid converting the whole
+	// layer to a QImage and work on a reduced copy instead
 	QImage tmpImg2;
 	if (header.color_mode == CM_CMYK)
-		tmpImg2 = r2_image.convertToQImage(true);
+		tmpImg2 = r2_image.subsampled(160).convertToQImage(true);
 	else
-		tmpImg2 = r2_image.convertToQImage(false);
+		tmpImg2 = r2_image.subsampled(160).convertToQImage(false);
 	QImage imt;
 	double sx = tmpImg2.width() / 40.0;
 	double sy = tmpImg2.height() / 40.0;
@@ -1430,7 +1647,7 @@ bool ScImgDataLoader_TIFF::loadLayerChannels( QDataStream & s, const PSDHeader &
 	{
 		QImage imt2;
 		QImage tmpImg;
-		tmpImg = mask.convertToQImage(true);
+		tmpImg = mask.subsampled(160).convertToQImage(true);
 		double sx = tmpImg.width() / 40.0;
 		double sy = tmpImg.height() / 40.0;
 		imt2 = sy < sx ?  tmpImg.scaled(qRound(tmpImg.width() / sx), qRound(tmpImg.height() / sx), Qt::IgnoreAspectRatio, Qt::SmoothTransformation) :
@@ -31,6 +31,13 @@ protected:
 	int  getLayers(const QString& fn, int page);
 	bool getImageData(TIFF* tif, RawImage *image, uint widtht, uint heightt, uint size, uint16 m_photometric, uint16 bitspersample, uint16 m_samplesperpixel, bool &bilevel, bool &isCMYK);
 	bool getImageData_RGBA(TIFF* tif, RawImage *image, uint widtht, uint heightt, uint size, uint16 bitspersample, uint16 m_samplesperpixel);
+	bool getImageData_RGBAStrips(TIFF* tif, RawImage *image, uint widtht, uint heightt);
+	bool getImageData_RGBATiles(TIFF* tif, RawImage *image, uint widtht, uint heightt);
+	bool getImageData_ReducedTiles(TIFF* tif, RawImage *image, uint widtht, uint heightt);
+	bool getImageData_Scanlines(TIFF* tif, RawImage *image, uint widtht, uint heightt, uint16 bitspersample, uint16 samplesperpixel, uint16 extrasamples);
+	void copyRGBARow(RawImage *image, uint32 y, uint32 x, uint32* src, uint count);
+	//! \brief Store count source pixels at column x of row y, taking m_reduction into account
+	void storeRow(RawImage *image, uint32 y, uint32 x, const uchar* src, uint count, int srcPixelBytes);
 	void blendOntoTarget(RawImage *tmp, int layOpa, const QString& layBlend, bool cmyk, bool useMask);
 	QString getLayerString(QDataStream & s);
 	bool loadChannel( QDataStream & s, const PSDHeader & header, QList<PSDLayer> &layerInfo, uint layer, int channel, int component, RawImage &tmpImg);
@@ -42,6 +49,8 @@ protected:
 
 	int    m_random_table[4096];
 	uint16 m_photometric, m_samplesperpixel;
+	//! \brief Only every m_reduction-th pixel of huge scans is loaded
+	int    m_reduction;
 
 public:
 	ScImgDataLoader_TIFF();
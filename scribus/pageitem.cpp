@@ -372,6 +372,7 @@ PageItem::PageItem(const PageItem & other)
 		++nameNum;
 		m_itemName = oldName + tmp.setNum(nameNum);
 	}
+	m_Doc->registerItemName(m_itemName);
 	
 	uniqueNr = m_Doc->TotalItems;
 	invalid = true;
@@ -632,6 +633,7 @@ PageItem::PageItem(ScribusDoc *pa, ItemType newType, double x, double y, double
 		++nameNum;
 		m_itemName = oldName + tmp.setNum(nameNum);
 	}
+	m_Doc->registerItemName(m_itemName);
 	
 	uniqueNr = m_Doc->TotalItems;
 	AutoName = true;
@@ -2586,6 +2588,7 @@ void PageItem::setItemName(const QString& newName)
 		return;
 	QString oldName = m_itemName;
 	m_itemName = generateUniqueCopyName(newName);
+	m_Doc->registerItemName(m_itemName);
 	AutoName=false;
 	if (UndoManager::undoEnabled())
 	{
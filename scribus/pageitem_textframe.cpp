@@ -30,6 +30,7 @@ for which a new license (GPL+exception) is in place.
 #include <QPoint>
 #include <QPolygon>
 #include <QRegion>
+#include <QSet>
 #include <cairo.h>
 #include <cassert>
 
@@ -51,15 +52,18 @@ for which a new license (GPL+exception) is in place.
 #include "scpaths.h"
 #include "scraction.h"
 #include "scribus.h"
+#include "scribuscore.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "scribusstructs.h"
 #include "selection.h"
 #include "text/boxes.h"
+#include "text/layoutprofiler.h"
 #include "text/screenpainter.h"
 #include "text/textshaper.h"
 #include "text/shapedtext.h"
 #include "text/shapedtextfeed.h"
+#include "text/totalfitbreakcache.h"
 #include "ui/guidemanager.h"
 #include "ui/marksmanager.h"
 #include "undomanager.h"
@@ -85,6 +89,11 @@ PageItem_TextFrame::PageItem_TextFrame(const PageItem & p) : PageItem(p)
 	m_notesFramesMap.clear();
 }
 
+PageItem_TextFrame::~PageItem_TextFrame()
+{
+	LayoutProfiler::instance().removeFrame(this);
+}
+
 void PageItem_TextFrame::init()
 {
 	invalid = true;
@@ -1097,6 +1106,7 @@ struct LineControl {
 
 	LineBox* createLineBox()
 	{
+		LayoutProfileTimer profileTimer(LayoutProfiler::Boxes);
 		LineBox* result = new LineBox();
 		result->moveTo(lineData.x - colLeft, lineData.y - lineData.ascent);
 		result->setWidth(lineData.width);
@@ -1194,6 +1204,80 @@ static double nextAutoTab (const LineControl &current, PageItem *item)
 	return res;
 }
 
+/// records a layout of a frame with LayoutProfiler
+class LayoutProfileScope
+{
+public:
+	explicit LayoutProfileScope(PageItem_TextFrame* frame) : m_frame(frame), m_active(LayoutProfiler::isEnabled())
+	{
+		if (m_active)
+			LayoutProfiler::instance().beginFrame(frame, frame->itemName(), frame->OwnPage + 1);
+	}
+
+	~LayoutProfileScope()
+	{
+		if (m_active)
+			LayoutProfiler::instance().endFrame(m_frame->textLayout.lines());
+	}
+
+private:
+	PageItem_TextFrame* m_frame;
+	bool m_active;
+};
+
+/// describes the paragraph from glyph cluster first on for TotalFitBreaker,
+/// chars holds the last char of the break at each item or -1
+static bool totalFitItems(ShapedTextFeed& shapedText, QList<GlyphCluster>& glyphClusters, int first, const StoryText& itemText, const ParagraphStyle& style,
+						  QVector<TotalFitBreaker::Item>& items, QVector<int>& chars)
+{
+	items.clear();
+	chars.clear();
+	for (int j = first; shapedText.haveMoreText(j, glyphClusters); ++j)
+	{
+		int last = glyphClusters.at(j).lastChar();
+		double wide = glyphClusters.at(j).width();
+		bool hyphenation = glyphClusters.at(j).hasFlag(ScLayout_HyphenationPossible);
+		QChar ch = itemText.text(last);
+		if (ch == SpecialChars::PARSEP)
+			break;
+		// widths of tabs and lines ended by hand are left to the greedy layout
+		if (ch == SpecialChars::TAB || SpecialChars::isBreak(ch, true))
+			return false;
+		if (SpecialChars::isExpandingSpace(ch))
+		{
+			items.append(TotalFitBreaker::glue(wide, wide, (1 - style.minWordTracking()) * wide));
+			chars.append(last);
+			continue;
+		}
+		items.append(TotalFitBreaker::box(wide));
+		chars.append(-1);
+		if (hyphenation || ch == SpecialChars::SHYPHEN)
+		{
+			const CharStyle& charStyle = itemText.computedCharStyle(last);
+			double hyphWidth = charStyle.font().hyphenWidth(charStyle, charStyle.fontSize() / 10.0) * (charStyle.scaleH() / 1000.0);
+			items.append(TotalFitBreaker::penalty(hyphWidth, 50.0, true));
+			chars.append(last);
+		}
+		else if (ch == '-')
+		{
+			items.append(TotalFitBreaker::penalty(0.0, 50.0, true));
+			chars.append(last);
+		}
+		else if (shapedText.haveMoreText(j + 1, glyphClusters) && glyphClusters.at(j + 1).hasFlag(ScLayout_LineBoundary)
+				 && !SpecialChars::isExpandingSpace(itemText.text(glyphClusters.at(j + 1).firstChar())))
+		{
+			items.append(TotalFitBreaker::penalty(0.0, 0.0));
+			chars.append(last);
+		}
+	}
+	// the last line is not justified
+	items.append(TotalFitBreaker::glue(0.0, TotalFitBreaker::Infinity, 0.0));
+	chars.append(-1);
+	items.append(TotalFitBreaker::penalty(0.0, -TotalFitBreaker::Infinity));
+	chars.append(-1);
+	return true;
+}
+
 //cezaryece: I remove static statement as this function is used also by PageItem_NoteFrame
 double calculateLineSpacing (const ParagraphStyle &style, PageItem *item)
 {
@@ -1335,6 +1419,7 @@ void PageItem_TextFrame::layout()
 	if (invalid && BackBox == nullptr)
 		firstChar = 0;
 
+	LayoutProfileScope profileScope(this);
 //	qDebug() << QString("textframe(%1,%2): len=%3, start relayout at %4").arg(m_xPos).arg(m_yPos).arg(itemText.length()).arg(firstInFrame());
 	QPoint pt1, pt2;
 	QRect pt;
@@ -1517,6 +1602,13 @@ void PageItem_TextFrame::layout()
 		int regionMinY = 0, regionMaxY= 0;
 
 		double autoLeftIndent = 0.0;
+
+		// breaks of justified paragraphs chosen by TotalFitBreaker, as last chars of lines
+		bool totalFit = (context->typographicPrefs().lineBreakMode == TypoPrefs::TotalFitLineBreaking);
+		QSet<int> optimalBreaks, optimalLineStarts;
+		QVector<TotalFitBreaker::Item> fitItems;
+		QVector<int> fitChars, fitBreaks;
+
 		for (int i = 0; shapedText.haveMoreText(i, glyphClusters); ++i)
 		{
 			int currentIndex = i - current.lineData.firstCluster;
@@ -1557,6 +1649,37 @@ void PageItem_TextFrame::layout()
 				}
 			}
 
+			if (LayoutProfiler::isEnabled() && (i == 0 || itemText.isBlockStart(a)))
+				LayoutProfiler::instance().beginParagraph(a);
+
+			if (totalFit && (i == 0 || itemText.isBlockStart(a)))
+			{
+				optimalBreaks.clear();
+				optimalLineStarts.clear();
+				if (style.alignment() == ParagraphStyle::Justified && !style.hasBullet() && !style.hasNum() && !style.hasDropCap()
+					&& totalFitItems(shapedText, glyphClusters, i, itemText, style, fitItems, fitChars))
+				{
+					// a paragraph continued from the previous frame starts with a full line
+					double lineWidth = current.colRight - current.colLeft - style.leftMargin() - style.rightMargin();
+					double firstLineWidth = itemText.isBlockStart(a) ? lineWidth - style.firstIndent() : lineWidth;
+					TotalFitBreaker breaker(firstLineWidth, lineWidth);
+					if (TotalFitBreakCache::instance()->breaks(breaker, fitItems, fitBreaks, !ScCore->usingGUI()))
+					{
+						optimalLineStarts.insert(a);
+						for (int b = 0; b < fitBreaks.count(); ++b)
+						{
+							int last = fitChars.at(fitBreaks.at(b));
+							if (last < 0)
+								continue;
+							optimalBreaks.insert(last);
+							optimalLineStarts.insert(last + 1);
+						}
+					}
+					else // greedy layout until the breaks are known
+						connect(TotalFitBreakCache::instance(), SIGNAL(breaksReady()), this, SLOT(slotTotalFitBreaksReady()), Qt::UniqueConnection);
+				}
+			}
+
 			if (current.isEmpty)
 				opticalMargins = style.opticalMargins();
 			//-->#13490
@@ -1667,7 +1790,7 @@ void PageItem_TextFrame::layout()
 				//text height, width, ascent and descent should be calculated for whole text provided by ScText in current position
 				//and that may be more than one char (variable text for example)
 				double realCharHeight = 0.0, realCharAscent = 0.0;
-				const QList<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
+				const QVector<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
 				for (const GlyphLayout& gl : glyphs) {
 					GlyphMetrics gm = font.glyphBBox(gl.glyph, style.charStyle().fontSize() / 10.0);
 					realCharHeight = qMax(realCharHeight, gm.ascent + gm.descent);
@@ -1748,7 +1871,7 @@ void PageItem_TextFrame::layout()
 				{
 					double realCharHeight = 0.0, realCharAscent = 0.0;
 					wide = 0.0; realAsce = 0.0;
-					const QList<GlyphLayout>& glyphs = glyphCluster.glyphs();
+					const QVector<GlyphLayout>& glyphs = glyphCluster.glyphs();
 					for (const GlyphLayout& gl : glyphs) {
 						GlyphMetrics gm = font.glyphBBox(gl.glyph, charStyle.fontSize() / 10.0);
 						realCharHeight = qMax(realCharHeight, gm.ascent + gm.descent);
@@ -1790,7 +1913,7 @@ void PageItem_TextFrame::layout()
 				{
 					if (itemText.text(a) != SpecialChars::OBJECT)
 					{
-						const QList<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
+						const QVector<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
 						for (const GlyphLayout& gl : glyphs)
 						{
 							GlyphMetrics gm = font.glyphBBox(gl.glyph, hlcsize10);
@@ -1815,7 +1938,7 @@ void PageItem_TextFrame::layout()
 						realAsce = asce * scaleV + offset;
 					else
 					{
-						const QList<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
+						const QVector<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
 						for (const GlyphLayout& gl : glyphs)
 							realAsce = qMax(realAsce, font.glyphBBox(gl.glyph, hlcsize10).ascent * scaleV + offset);
 					}
@@ -2206,7 +2329,7 @@ void PageItem_TextFrame::layout()
 			if (DropCmode)
 			{
 				double yoffset = 0.0;
-				const QList<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
+				const QVector<GlyphLayout>& glyphs = current.glyphs[currentIndex].glyphs();
 				for (const GlyphLayout& gl : glyphs)
 					yoffset = qMax(yoffset, font.glyphBBox(gl.glyph, chsd / 10.0).descent);
 				current.glyphs[currentIndex].yoffset -= yoffset;
@@ -2536,6 +2659,21 @@ void PageItem_TextFrame::layout()
 					current.recalculateY = false;
 				}
 			}
+			// follow the optimal breaks as long as lines start where planned,
+			// otherwise the greedy layout takes over for the rest of the paragraph
+			if (!outs && optimalBreaks.contains(current.glyphs[currentIndex].lastChar())
+				&& optimalLineStarts.contains(glyphClusters.at(current.lineData.firstCluster).firstChar()))
+			{
+				if (current.breakIndex != i && hyphWidth == 0.0 && itemText.text(a) != '-')
+					current.breakLine(i);
+				if (current.breakIndex == i)
+				{
+					outs = true;
+					current.addLine = true;
+					current.lastInRowLine = true;
+					current.rightMargin = style.rightMargin();
+				}
+			}
 			// end of line
 			if (outs)
 			{
@@ -3104,6 +3242,13 @@ void PageItem_TextFrame::invalidateLayout(bool wholeChain)
 	}
 }
 
+void PageItem_TextFrame::slotTotalFitBreaksReady()
+{
+	disconnect(TotalFitBreakCache::instance(), SIGNAL(breaksReady()), this, SLOT(slotTotalFitBreaksReady()));
+	slotInvalidateLayout(firstInFrame(), itemText.length());
+	m_Doc->regionsChanged()->update(QRectF());
+}
+
 void PageItem_TextFrame::slotInvalidateLayout(int firstItem, int endItem)
 {
 	PageItem* firstFrame = firstInChain();
@@ -49,7 +49,7 @@ class SCRIBUS_API PageItem_TextFrame : public PageItem
 public:
 	PageItem_TextFrame(ScribusDoc *pa, double x, double y, double w, double h, double w2, const QString& fill, const QString& outline);
 	PageItem_TextFrame(const PageItem & p);
-	~PageItem_TextFrame() {}
+	~PageItem_TextFrame();
 
 	void init();
 
@@ -122,6 +122,7 @@ private:
 	
 private slots:
 	void slotInvalidateLayout(int firstItem, int endItem);
+	void slotTotalFitBreaksReady();
 
 public:
 	//for footnotes/endnotes
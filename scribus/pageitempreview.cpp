@@ -14,40 +14,53 @@
 #include "pageitem.h"
 
 #include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+
+class PageItemPreviewJob : public QRunnable
+{
+	public:
+		PageItemPreviewJob(const QSharedPointer<PageItemPreview::State>& state) : m_state(state) {}
+
+		void run()
+		{
+			QMutexLocker locker(&m_state->mutex);
+			// The preview has been deleted before the job could start
+			if (!m_state->pageitem)
+				return;
+			m_state->image = m_state->pageitem->DrawObj_toImage(100);
+			m_state->completed = true;
+		}
+
+	private:
+		QSharedPointer<PageItemPreview::State> m_state;
+};
 
 PageItemPreview::PageItemPreview(PageItem * pi)
-	:m_pageitem(pi), m_completed(false)
+	: m_state(new State(pi))
 {
-	start();
+	QThreadPool::globalInstance()->start(new PageItemPreviewJob(m_state));
 }
 
 PageItemPreview::~ PageItemPreview()
 {
+	// Waits for a running job, a queued one will see the item is gone
+	QMutexLocker locker(&m_state->mutex);
+	m_state->pageitem = 0;
 }
 
 bool PageItemPreview::isReady() const
 {
-	return m_completed;
+	return m_state->completed;
 }
 
 QImage * PageItemPreview::getImage()
 {
-	if(m_mutex.tryLock())
+	if (m_state->mutex.tryLock())
 	{
-		m_mutex.unlock();
-		if(m_completed)
-		{
-			return &m_image;
-		}
+		m_state->mutex.unlock();
+		if (m_state->completed)
+			return &m_state->image;
 	}
 	return 0;
 }
-
-void PageItemPreview::run()
-{
-	QMutexLocker locker(&m_mutex);
-	
-	m_image = m_pageitem->DrawObj_toImage(100);
-	m_completed = true;
-	
-}
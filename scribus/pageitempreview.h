@@ -13,12 +13,18 @@
 #ifndef PAGEITEMPREVIEW_H
 #define PAGEITEMPREVIEW_H
 
-#include <QThread>
 #include <QMutex>
 #include <QImage>
+#include <QSharedPointer>
 
 class PageItem;
-class PageItemPreview : public QThread
+
+/**
+ * Renders an item to an image in the background. Rendering is queued on the
+ * global thread pool shared with the other background jobs instead of
+ * running in a dedicated thread per item.
+ */
+class PageItemPreview
 {
 	public:
 		PageItemPreview(PageItem* pi);
@@ -28,13 +34,17 @@ class PageItemPreview : public QThread
 		QImage * getImage();
 		
 	private:
-		PageItem * m_pageitem;
-		bool m_completed;
-		QImage m_image;
-		
-		QMutex m_mutex;
-		
-		void run();
+		struct State
+		{
+			State(PageItem* pi) : pageitem(pi), completed(false) {}
+			PageItem * pageitem;
+			bool completed;
+			QImage image;
+			QMutex mutex;
+		};
+		QSharedPointer<State> m_state;
+
+		friend class PageItemPreviewJob;
 };
 
 #endif // PAGEITEMPREVIEW_H
@@ -72,6 +72,7 @@ for which a new license (GPL+exception) is in place.
 #include "text/textlayoutpainter.h"
 #include "fonts/cff.h"
 #include "fonts/sfnt.h"
+#include "scoperatorstream.h"
 #include "scpage.h"
 #include "scpaths.h"
 #include "scpattern.h"
@@ -105,10 +106,53 @@ using namespace TableUtils;
 
 static inline QByteArray FToStr(double c)
 {
-	double v = c;
-	if (fabs(c) < 0.0000001)
-		v = 0.0;
-	return QByteArray::number(v, 'f', 5);
+	return ScOperatorStream::number(c);
+}
+
+// Append a path as PDF path construction operators
+static void appendPathOperators(ScOperatorStream& out, const FPointArray& path, bool poly)
+{
+	FPoint np, np1, np2, np3, np4, firstP;
+	bool nPath = true;
+	bool first = true;
+	if (path.size() <= 3)
+		return;
+
+	for (int poi=0; poi<path.size()-3; poi += 4)
+	{
+		if (path.isMarker(poi))
+		{
+			nPath = true;
+			continue;
+		}
+		if (nPath)
+		{
+			np = path.point(poi);
+			if ((!first) && (poly) && (np4 == firstP))
+				out.op("h");
+			out << np.x() << -np.y();
+			out.op("m");
+			nPath = false;
+			first = false;
+			firstP = np;
+			np4 = np;
+		}
+		np = path.point(poi);
+		np1 = path.point(poi+1);
+		np2 = path.point(poi+3);
+		np3 = path.point(poi+2);
+		if ((np == np1) && (np2 == np3))
+		{
+			out << np3.x() << -np3.y();
+			out.op("l");
+		}
+		else
+		{
+			out << np1.x() << -np1.y() << np2.x() << -np2.y() << np3.x() << -np3.y();
+			out.op("c");
+		}
+		np4 = np3;
+	}
 }
 
 class PdfPainter: public TextLayoutPainter
@@ -126,7 +170,10 @@ class PdfPainter: public TextLayoutPainter
 
 	QByteArray transformToStr(const QTransform& tr)
 	{
-		return FToStr(tr.m11()) + " " + FToStr(-tr.m12()) + " " + FToStr(-tr.m21()) + " " + FToStr(tr.m22()) + " " + FToStr(tr.dx()) + " " + FToStr(-tr.dy());
+		ScOperatorStream out;
+		out << tr.m11() << -tr.m12() << -tr.m21() << tr.m22() << tr.dx();
+		out.appendNumber(-tr.dy());
+		return out.take();
 	}
 
 public:
@@ -4210,48 +4257,68 @@ QByteArray PDFLibCore::PDF_PutSoftShadow(PageItem* ite)
 	QImage imgA = ite->DrawObj_toImage(maxSize, PageItem::NoRotation);
 	ite->setFillTransparency(transF);
 	ite->setLineTransparency(transS);
-	QImage imgC = imgA.copy(-pixelRadius, -pixelRadius, imgA.width() + 2 * pixelRadius, imgA.height() + 2 * pixelRadius); // Add border
-	ScPainter *p = new ScPainter(&imgC, imgC.width(), imgC.height(), 1, 0);
-	p->setZoomFactor(softShadowDPI / 72.0);
-	p->save();
-	p->blur(pixelRadius);
-	p->restore();
-	p->end();
-	delete p;
+
+	// Items sharing the same shape, size and shadow settings render the same
+	// mask, blur and write it only once and reference the existing image then
+	QCryptographicHash shadowHash(QCryptographicHash::Md5);
+	shadowHash.addData(reinterpret_cast<const char*>(imgA.constBits()), imgA.byteCount());
+	QByteArray shadowKey = shadowHash.result();
+	shadowKey += Pdf::toPdf(imgA.width()) + " " + Pdf::toPdf(imgA.height()) + " " + Pdf::toPdf(pixelRadius);
 	if (ite->softShadowErasedByObject())
+		shadowKey += " " + FToStr(ite->softShadowXOffset()) + " " + FToStr(ite->softShadowYOffset());
+
+	PdfId maskObj = SoftShadowMasks.value(shadowKey, 0);
+	if (maskObj != 0)
 	{
+		ite->doc()->guidesPrefs().showControls = saveControl;
+		ite->setHasSoftShadow(savedShadow);
+	}
+	else
+	{
+		QImage imgC = imgA.copy(-pixelRadius, -pixelRadius, imgA.width() + 2 * pixelRadius, imgA.height() + 2 * pixelRadius); // Add border
 		ScPainter *p = new ScPainter(&imgC, imgC.width(), imgC.height(), 1, 0);
-		p->translate(pixelRadius, pixelRadius);
-		p->translate(-ite->softShadowXOffset() * (softShadowDPI / 72.0), -ite->softShadowYOffset() * (softShadowDPI / 72.0));
-		p->beginLayer(1.0, 18);
-		p->drawImage(&imgA);
-		p->endLayer();
+		p->setZoomFactor(softShadowDPI / 72.0);
+		p->save();
+		p->blur(pixelRadius);
+		p->restore();
 		p->end();
 		delete p;
+		if (ite->softShadowErasedByObject())
+		{
+			ScPainter *p = new ScPainter(&imgC, imgC.width(), imgC.height(), 1, 0);
+			p->translate(pixelRadius, pixelRadius);
+			p->translate(-ite->softShadowXOffset() * (softShadowDPI / 72.0), -ite->softShadowYOffset() * (softShadowDPI / 72.0));
+			p->beginLayer(1.0, 18);
+			p->drawImage(&imgA);
+			p->endLayer();
+			p->end();
+			delete p;
+		}
+
+		ite->doc()->guidesPrefs().showControls = saveControl;
+		ite->setHasSoftShadow(savedShadow);
+		ScImage img = imgC.alphaChannel().convertToFormat(QImage::Format_RGB32);
+
+		maskObj = writer.newObject();
+		writer.startObj(maskObj);
+		PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
+		PutDoc("/Width "+Pdf::toPdf(img.width())+"\n");
+		PutDoc("/Height "+Pdf::toPdf(img.height())+"\n");
+		PutDoc("/ColorSpace /DeviceGray\n");
+		PutDoc("/BitsPerComponent 8\n");
+		uint lengthObj = writer.newObject();
+		PutDoc("/Length "+Pdf::toPdf(lengthObj)+" 0 R\n");
+		PutDoc("/Filter /FlateDecode\n");
+		PutDoc(">>\nstream\n");
+		int bytesWritten = WriteFlateImageToStream(img, maskObj, ColorSpaceGray, false);
+		PutDoc("\nendstream");
+		writer.endObj(maskObj);
+		writer.startObj(lengthObj);
+		PutDoc("    " + Pdf::toPdf(bytesWritten));
+		writer.endObj(lengthObj);
+		SoftShadowMasks.insert(shadowKey, maskObj);
 	}
 
-	ite->doc()->guidesPrefs().showControls = saveControl;
-	ite->setHasSoftShadow(savedShadow);
-	ScImage img = imgC.alphaChannel().convertToFormat(QImage::Format_RGB32);
-
-	PdfId maskObj = writer.newObject();
-	writer.startObj(maskObj);
-	PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-	PutDoc("/Width "+Pdf::toPdf(img.width())+"\n");
-	PutDoc("/Height "+Pdf::toPdf(img.height())+"\n");
-	PutDoc("/ColorSpace /DeviceGray\n");
-	PutDoc("/BitsPerComponent 8\n");
-	uint lengthObj = writer.newObject();
-	PutDoc("/Length "+Pdf::toPdf(lengthObj)+" 0 R\n");
-	PutDoc("/Filter /FlateDecode\n");
-	PutDoc(">>\nstream\n");
-	int bytesWritten = WriteFlateImageToStream(img, maskObj, ColorSpaceGray, false);
-	PutDoc("\nendstream");
-	writer.endObj(maskObj);
-	writer.startObj(lengthObj);
-	PutDoc("    " + Pdf::toPdf(bytesWritten));
-	writer.endObj(lengthObj);
-
 	const ScColor& shadowColor = doc.PageColors[ite->softShadowColor()];
 	QByteArray colstr = SetColor(ite->softShadowColor(), ite->softShadowShade());
 	int colCompCount = colstr.split(' ').count();
@@ -6016,104 +6083,28 @@ QByteArray PDFLibCore::SetGradientColor(const QString& farbe, double Shade)
 
 QByteArray PDFLibCore::SetClipPath(PageItem *ite, bool poly)
 {
-	QByteArray tmp;
-	FPoint np, np1, np2, np3, np4, firstP;
-	bool nPath = true;
-	bool first = true;
-	if (ite->PoLine.size() <= 3)
-		return tmp;
-
-	for (int poi=0; poi<ite->PoLine.size()-3; poi += 4)
-	{
-		if (ite->PoLine.isMarker(poi))
-		{
-			nPath = true;
-			continue;
-		}
-		if (nPath)
-		{
-			np = ite->PoLine.point(poi);
-			if ((!first) && (poly) && (np4 == firstP))
-				tmp += "h\n";
-			tmp += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
-			nPath = false;
-			first = false;
-			firstP = np;
-			np4 = np;
-		}
-		np = ite->PoLine.point(poi);
-		np1 = ite->PoLine.point(poi+1);
-		np2 = ite->PoLine.point(poi+3);
-		np3 = ite->PoLine.point(poi+2);
-		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" l\n";
-		else
-		{
-			tmp += FToStr(np1.x())+" "+FToStr(-np1.y())+" ";
-			tmp += FToStr(np2.x())+" "+FToStr(-np2.y())+" ";
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" c\n";
-		}
-		np4 = np3;
-	}
-	return tmp;
+	return SetClipPathArray(&ite->PoLine, poly);
 }
 
 QByteArray PDFLibCore::SetClipPathArray(FPointArray *ite, bool poly)
 {
-	QByteArray tmp;
-	FPoint np, np1, np2, np3, np4, firstP;
-	bool nPath = true;
-	bool first = true;
-	if (ite->size() <= 3)
-		return tmp;
-
-	for (int poi=0; poi<ite->size()-3; poi += 4)
-	{
-		if (ite->isMarker(poi))
-		{
-			nPath = true;
-			continue;
-		}
-		if (nPath)
-		{
-			np = ite->point(poi);
-			if ((!first) && (poly) && (np4 == firstP))
-				tmp += "h\n";
-			tmp += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
-			nPath = false;
-			first = false;
-			firstP = np;
-			np4 = np;
-		}
-		np = ite->point(poi);
-		np1 = ite->point(poi+1);
-		np2 = ite->point(poi+3);
-		np3 = ite->point(poi+2);
-		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" l\n";
-		else
-		{
-			tmp += FToStr(np1.x())+" "+FToStr(-np1.y())+" ";
-			tmp += FToStr(np2.x())+" "+FToStr(-np2.y())+" ";
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" c\n";
-		}
-		np4 = np3;
-	}
-	return tmp;
+	ScOperatorStream out;
+	appendPathOperators(out, *ite, poly);
+	return out.take();
 }
 
 QByteArray PDFLibCore::SetClipPathImage(PageItem *ite)
 {
-	QByteArray tmp;
+	ScOperatorStream out;
 	if (ite->imageClip.size() <= 3)
-		return tmp;
+		return out.take();
 
 	bool nPath = true;
 	for (int poi=0; poi<ite->imageClip.size()-3; poi += 4)
 	{
 		if (ite->imageClip.isMarker(poi))
 		{
-			tmp += "h\n";
+			out.op("h");
 			nPath = true;
 			continue;
 		}
@@ -6121,7 +6112,8 @@ QByteArray PDFLibCore::SetClipPathImage(PageItem *ite)
 		if (nPath)
 		{
 			np = ite->imageClip.point(poi);
-			tmp += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
+			out << np.x() << -np.y();
+			out.op("m");
 			nPath = false;
 		}
 		np = ite->imageClip.point(poi);
@@ -6129,15 +6121,17 @@ QByteArray PDFLibCore::SetClipPathImage(PageItem *ite)
 		np2 = ite->imageClip.point(poi+3);
 		np3 = ite->imageClip.point(poi+2);
 		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" l\n";
+		{
+			out << np3.x() << -np3.y();
+			out.op("l");
+		}
 		else
 		{
-			tmp += FToStr(np1.x())+" "+FToStr(-np1.y())+" ";
-			tmp += FToStr(np2.x())+" "+FToStr(-np2.y())+" ";
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" c\n";
+			out << np1.x() << -np1.y() << np2.x() << -np2.y() << np3.x() << -np3.y();
+			out.op("c");
 		}
 	}
-	return tmp;
+	return out.take();
 }
 
 QByteArray PDFLibCore::SetImagePathAndClip(PageItem *item)
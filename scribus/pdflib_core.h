@@ -256,6 +256,7 @@ private:
 	BookMView* Bvie;
 	//int Dokument;
 	QMap<QString,ShIm> SharedImages;
+	QHash<QByteArray, PdfId> SoftShadowMasks; // blurred shadow mask images, keyed by content digest
 	QList<PdfDest> NamedDest;
 	QList<PdfId> CalcFields;
 	Pdf::ResourceMap Patterns;
@@ -9,6 +9,7 @@ for which a new license (GPL+exception) is in place.
 
 #include "pdfwriter.h"
 #include "rc4.h"
+#include "scoperatorstream.h"
 #include "scstreamfilter_rc4.h"
 #include "util.h"
 
@@ -331,7 +332,7 @@ namespace Pdf
 	
 	QByteArray toPdf(double v)
 	{
-		return QByteArray::number(v, 'f');
+		return ScOperatorStream::number(v);
 	}
 	
 	QByteArray toObjRef(PdfId id)
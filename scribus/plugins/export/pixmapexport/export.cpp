@@ -10,7 +10,9 @@ for which a new license (GPL+exception) is in place.
 #include <QCursor>
 #include <QDir>
 #include <QMessageBox>
+#include <QMutexLocker>
 #include <QPixmap>
+#include <QRunnable>
 #include <QString>
 #include <QSharedPointer>
 
@@ -23,6 +25,48 @@ for which a new license (GPL+exception) is in place.
 #include "commonstrings.h"
 #include "scpaths.h"
 
+namespace
+{
+	//! Memory images waiting to be written may take, in KiB
+	const int writerBudgetKiB = 512 * 1024;
+}
+
+/*! \brief Encodes and writes one exported page on a worker thread */
+class ExportBitmapWriter : public QRunnable
+{
+public:
+	ExportBitmapWriter(ExportBitmap* exporter, const QImage& image, const QString& fileName, int cost)
+		: m_exporter(exporter),
+		  m_image(image),
+		  m_fileName(fileName),
+		  m_format(exporter->bitmapType.toLocal8Bit()),
+		  m_quality(exporter->quality),
+		  m_cost(cost)
+	{
+	}
+
+	void run() override
+	{
+		bool saved = m_image.save(m_fileName, m_format.constData(), m_quality);
+		// Free the image before giving back its share of the budget
+		m_image = QImage();
+		if (!saved)
+		{
+			QMutexLocker locker(&m_exporter->m_writerMutex);
+			m_exporter->m_failedFiles.append(m_fileName);
+		}
+		m_exporter->m_writerBudget.release(m_cost);
+	}
+
+private:
+	ExportBitmap* m_exporter;
+	QImage m_image;
+	QString m_fileName;
+	QByteArray m_format;
+	int m_quality;
+	int m_cost;
+};
+
 int scribusexportpixmap_getPluginAPIVersion()
 {
 	return PLUGIN_API_VERSION;
@@ -156,6 +200,7 @@ bool PixmapExportPlugin::run(ScribusDoc* doc, const QString& target)
 
 
 ExportBitmap::ExportBitmap()
+	: m_writerBudget(writerBudgetKiB)
 {
 	pageDPI = 72;
 	quality = -1;
@@ -172,18 +217,37 @@ QString ExportBitmap::getFileName(ScribusDoc* doc, uint pageNr)
 
 ExportBitmap::~ExportBitmap()
 {
+	m_writerPool.waitForDone();
 }
 
 bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single = true)
 {
 	uint over   = 0;
-	bool saved = false, doFileSave = true;
 	QString fileName(getFileName(doc, pageNr));
 
 	if (!doc->Pages->at(pageNr))
 		return false;
 	ScPage* page = doc->Pages->at(pageNr);
 
+	// Ask before rendering, the page is not rendered at all if the user refuses
+	if (QFile::exists(fileName) && !overwrite)
+	{
+		QString fn = QDir::toNativeSeparators(fileName);
+//		QApplication::restoreOverrideCursor();
+		QApplication::changeOverrideCursor(Qt::ArrowCursor);
+		over = ScMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
+				fn +"\n"+ tr("exists already. Overwrite?"),
+				// hack for multiple overwriting (petr) 
+				(single) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll,
+				QMessageBox::NoButton,	// GUI default
+				QMessageBox::YesToAll);	// batch default
+		QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
+		if (over == QMessageBox::YesToAll)
+			overwrite = true;
+		if (over != QMessageBox::Yes && over != QMessageBox::YesToAll)
+			return false;
+	}
+
 	/* a little magic here - I need to compute the "maxGr" value...
 	* We need to know the right size of the page for landscape,
 	* portrait and user defined sizes.
@@ -202,47 +266,48 @@ bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, boo
 	int dpm = qRound(100.0 / 2.54 * pageDPI);
 	im.setDotsPerMeterY(dpm);
 	im.setDotsPerMeterX(dpm);
-	if (QFile::exists(fileName) && !overwrite)
-	{
-		doFileSave = false;
-		QString fn = QDir::toNativeSeparators(fileName);
-//		QApplication::restoreOverrideCursor();
-		QApplication::changeOverrideCursor(Qt::ArrowCursor);
-		over = ScMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
-				fn +"\n"+ tr("exists already. Overwrite?"),
-				// hack for multiple overwriting (petr) 
-				(single) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll,
-				QMessageBox::NoButton,	// GUI default
-				QMessageBox::YesToAll);	// batch default
-		QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
-		if (over == QMessageBox::Yes || over == QMessageBox::YesToAll)
-			doFileSave = true;
-		if (over == QMessageBox::YesToAll)
-			overwrite = true;
-	}
-	if (doFileSave)
-		saved = im.save(fileName, bitmapType.toLocal8Bit().constData(), quality);
-	if (!saved && doFileSave)
-	{
-		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
-		doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
-	}
-	return saved;
+	queueImage(im, fileName);
+	return true;
+}
+
+void ExportBitmap::queueImage(const QImage& image, const QString& fileName)
+{
+	int cost = qBound(1, image.byteCount() / 1024, writerBudgetKiB);
+	m_writerBudget.acquire(cost);
+	m_writerPool.start(new ExportBitmapWriter(this, image, fileName, cost));
+}
+
+bool ExportBitmap::waitForWriters(ScribusDoc* doc)
+{
+	m_writerPool.waitForDone();
+	QMutexLocker locker(&m_writerMutex);
+	if (m_failedFiles.isEmpty())
+		return true;
+	m_failedFiles.clear();
+	locker.unlock();
+	ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
+	doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
+	return false;
 }
 
 bool ExportBitmap::exportCurrent(ScribusDoc* doc,  bool background)
 {
-	return exportPage(doc, doc->currentPageNumber(), background, true);
+	bool res = exportPage(doc, doc->currentPageNumber(), background, true);
+	return waitForWriters(doc) && res;
 }
 
 bool ExportBitmap::exportInterval(ScribusDoc* doc, std::vector<int> &pageNs, bool background)
 {
+	bool res = true;
 	doc->scMW()->mainWindowProgressBar->setMaximum(pageNs.size());
 	for (uint a = 0; a < pageNs.size(); ++a)
 	{
 		doc->scMW()->mainWindowProgressBar->setValue(a);
 		if (!exportPage(doc, pageNs[a]-1, background, false))
-			return false;
+		{
+			res = false;
+			break;
+		}
 	}
-	return true;
+	return waitForWriters(doc) && res;
 }
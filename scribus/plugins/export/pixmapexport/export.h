@@ -8,7 +8,12 @@ for which a new license (GPL+exception) is in place.
 #define _SCRIBUS_PIXMAPEXPORT_H_
 
 #include <QString>
+#include <QStringList>
 #include <QFileDialog>
+#include <QImage>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <pluginapi.h>
 #include <loadsaveplugin.h>
 #include <vector>
@@ -39,14 +44,20 @@ extern "C" PLUGIN_API void scribusexportpixmap_freePlugin(ScPlugin* plugin);
 
 
 
-/*! \brief Handles export. */
+/*! \brief Handles export.
+Pages are rendered one after the other as rendering needs the document and
+its view, the rendered images are encoded and written by a pool of worker
+threads meanwhile. */
 class ExportBitmap: public QObject
 {
 	Q_OBJECT
+
+	friend class ExportBitmapWriter;
+
 public:
 	/*! \brief Initializing the default export variables and attributes */
 	ExportBitmap();
-	/*! \brief nothing doing destructor. */
+	/*! \brief Waits for images still being written. */
 	~ExportBitmap();
 
 	/*! \brief Type of the exported image */
@@ -80,6 +91,20 @@ private:
 	\retval bool true on success
 	*/
 	bool exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single);
+	/*! \brief Queue an image for being written by a worker thread.
+	Blocks while the images waiting to be written exceed the memory budget. */
+	void queueImage(const QImage& image, const QString& fileName);
+	/*! \brief Wait until all queued images are written
+	\retval bool true if all of them were written successfully */
+	bool waitForWriters(ScribusDoc* doc);
+
+	/*! \brief Memory taken by images waiting to be written, in KiB */
+	QSemaphore m_writerBudget;
+	QMutex m_writerMutex;
+	/*! \brief Files which could not be written, guarded by m_writerMutex */
+	QStringList m_failedFiles;
+	/*! \brief Declared last so running writers finish before the members above go away */
+	QThreadPool m_writerPool;
 };
 
 #endif
@@ -24,7 +24,6 @@ for which a new license (GPL+exception) is in place.
 #include <QBuffer>
 #include <QByteArray>
 #include <QCheckBox>
-#include <QDataStream>
 #include <QFile>
 #include <QList>
 #include <QMessageBox>
@@ -180,6 +179,8 @@ bool SVGExportPlugin::run(ScribusDoc* doc, const QString& filename)
 			if (exit == QMessageBox::No)
 				return true;
 		}
+		// the export reads the text layout of frames still waiting for it
+		doc->layoutDeferredTextFrames();
 		SVGExPlug *dia = new SVGExPlug(doc);
 		dia->doExport(fileName, Options);
 		delete dia;
@@ -207,39 +208,53 @@ bool SVGExPlug::doExport( const QString& fName, SVGOptions &Opts )
 	PattCount = 0;
 	MaskCount = 0;
 	FilterCount = 0;
+	glyphNames.clear();
+	sharedDefinitions.clear();
 	docu = QDomDocument("svgdoc");
-	QString vo = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-	QString st = "<svg></svg>";
-	docu.setContent(st);
 	page = m_Doc->currentPage();
 	double pageWidth  = page->width();
 	double pageHeight = page->height();
-	docElement = docu.documentElement();
-	docElement.setAttribute("width", FToStr(pageWidth)+"pt");
-	docElement.setAttribute("height", FToStr(pageHeight)+"pt");
-	docElement.setAttribute("viewBox", QString("0 0 %1 %2").arg(pageWidth).arg(pageHeight));
-	docElement.setAttribute("xmlns", "http://www.w3.org/2000/svg");
-	docElement.setAttribute("xmlns:inkscape","http://www.inkscape.org/namespaces/inkscape");
-	docElement.setAttribute("xmlns:xlink","http://www.w3.org/1999/xlink");
-	docElement.setAttribute("version","1.1");
+
+	// Items are written as soon as they are processed, so the output is never held in memory as a whole
+	QFile file(fName);
+	QScopedPointer<QtIOCompressor> compressor;
+	QIODevice* output = &file;
+	if (Options.compressFile)
+	{
+		compressor.reset(new QtIOCompressor(&file));
+		compressor->setStreamFormat(QtIOCompressor::GzipFormat);
+		output = compressor.data();
+	}
+	if (!output->open(QIODevice::WriteOnly))
+		return false;
+	m_stream.setDevice(output);
+	m_stream.setCodec("UTF-8");
+	m_stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	m_stream << "<!DOCTYPE svgdoc>\n";
+	m_stream << "<svg width=\"" << FToStr(pageWidth) << "pt\" height=\"" << FToStr(pageHeight) << "pt\"";
+	m_stream << " viewBox=\"" << QString("0 0 %1 %2").arg(pageWidth).arg(pageHeight) << "\"";
+	m_stream << " xmlns=\"http://www.w3.org/2000/svg\"";
+	m_stream << " xmlns:inkscape=\"http://www.inkscape.org/namespaces/inkscape\"";
+	m_stream << " xmlns:xlink=\"http://www.w3.org/1999/xlink\"";
+	m_stream << " version=\"1.1\">\n";
 	if (!m_Doc->documentInfo().title().isEmpty())
 	{
 		QDomText title = docu.createTextNode(m_Doc->documentInfo().title());
 		QDomElement titleElem = docu.createElement("title");
 		titleElem.appendChild(title);
-		docElement.appendChild(titleElem);
+		writeElement(titleElem);
 	}
 	if (!m_Doc->documentInfo().comments().isEmpty())
 	{
 		QDomText desc = docu.createTextNode(m_Doc->documentInfo().comments());
 		QDomElement descElem = docu.createElement("desc");
 		descElem.appendChild(desc);
-		docElement.appendChild(descElem);
+		writeElement(descElem);
 	}
 	globalDefs = docu.createElement("defs");
 	writeBasePatterns();
 	writeBaseSymbols();
-	docElement.appendChild(globalDefs);
+	writeDefinitions();
 	if (Options.exportPageBackground)
 	{
 		QDomElement backG = docu.createElement("rect");
@@ -248,7 +263,7 @@ bool SVGExPlug::doExport( const QString& fName, SVGOptions &Opts )
 		backG.setAttribute("width", FToStr(pageWidth));
 		backG.setAttribute("height", FToStr(pageHeight));
 		backG.setAttribute("style", "fill:"+m_Doc->paperColor().name()+";" + "stroke:none;");
-		docElement.appendChild(backG);
+		writeElement(backG);
 	}
 	ScLayer ll;
 	ll.isPrintable = false;
@@ -263,37 +278,49 @@ bool SVGExPlug::doExport( const QString& fName, SVGOptions &Opts )
 			ProcessPageLayer(page, ll);
 		}
 	}
-	if(Options.compressFile)
-	{
-		// zipped saving
-		QString wr = vo;
-		wr += docu.toString();
-		QByteArray utf8wr = wr.toUtf8();
-		QFile file(fName);
-		QtIOCompressor compressor(&file);
-		compressor.setStreamFormat(QtIOCompressor::GzipFormat);
-		compressor.open(QIODevice::WriteOnly);
-		compressor.write(utf8wr);
-		compressor.close();
-	}
-	else
-	{
-		QFile f(fName);
-		if(!f.open(QIODevice::WriteOnly))
-			return false;
-		QDataStream s(&f);
-		QString wr = vo;
-		wr += docu.toString();
-		QByteArray utf8wr = wr.toUtf8();
-		s.writeRawData(utf8wr.data(), utf8wr.length());
-		f.close();
-	}
-	return true;
+	writeDefinitions();
+	m_stream << "</svg>\n";
+	m_stream.flush();
+	bool success = (m_stream.status() == QTextStream::Ok);
+	m_stream.setDevice(nullptr);
+	output->close();
+	globalDefs = QDomElement();
+	sharedDefinitions.clear();
+	return success;
+}
+
+void SVGExPlug::writeElement(const QDomNode& node)
+{
+	node.save(m_stream, 1);
+}
+
+void SVGExPlug::writeDefinitions()
+{
+	if (!globalDefs.hasChildNodes())
+		return;
+	writeElement(globalDefs);
+	globalDefs = docu.createElement("defs");
+}
+
+QString SVGExPlug::shareDefinition(QDomElement& def)
+{
+	QString id = def.attribute("id");
+	def.removeAttribute("id");
+	QString key;
+	QTextStream keyStream(&key);
+	def.save(keyStream, 0);
+	keyStream.flush();
+	QHash<QString, QString>::const_iterator it = sharedDefinitions.constFind(key);
+	if (it != sharedDefinitions.constEnd())
+		return it.value();
+	def.setAttribute("id", id);
+	globalDefs.appendChild(def);
+	sharedDefinitions.insert(key, id);
+	return id;
 }
 
 void SVGExPlug::ProcessPageLayer(ScPage *page, ScLayer& layer)
 {
-	QDomElement layerGroup;
 	PageItem *Item;
 	QList<PageItem*> Items;
 	ScPage* SavedAct = m_Doc->currentPage();
@@ -307,12 +334,12 @@ void SVGExPlug::ProcessPageLayer(ScPage *page, ScLayer& layer)
 		return;
 	m_Doc->setCurrentPage(page);
 
-	layerGroup = docu.createElement("g");
-	layerGroup.setAttribute("id", layer.Name);
-	layerGroup.setAttribute("inkscape:label", layer.Name);
-	layerGroup.setAttribute("inkscape:groupmode", "layer");
+	m_stream << "<g id=\"" << layer.Name.toHtmlEscaped() << "\"";
+	m_stream << " inkscape:label=\"" << layer.Name.toHtmlEscaped() << "\"";
+	m_stream << " inkscape:groupmode=\"layer\"";
 	if (layer.transparency != 1.0)
-		layerGroup.setAttribute("opacity", FToStr(layer.transparency));
+		m_stream << " opacity=\"" << FToStr(layer.transparency) << "\"";
+	m_stream << ">\n";
 	for (int j = 0; j < Items.count(); ++j)
 	{
 		Item = Items.at(j);
@@ -332,9 +359,14 @@ void SVGExPlug::ProcessPageLayer(ScPage *page, ScLayer& layer)
 			continue;
 		if ((!page->pageName().isEmpty()) && (Item->OwnPage != static_cast<int>(page->pageNr())) && (Item->OwnPage != -1))
 			continue;
-		ProcessItemOnPage(Item->xPos()-page->xOffset(), Item->yPos()-page->yOffset(), Item, &layerGroup);
+		QDomElement itemParent = docu.createElement("g");
+		ProcessItemOnPage(Item->xPos()-page->xOffset(), Item->yPos()-page->yOffset(), Item, &itemParent);
+		// Definitions go first, some viewers do not resolve forward references
+		writeDefinitions();
+		for (QDomNode child = itemParent.firstChild(); !child.isNull(); child = child.nextSibling())
+			writeElement(child);
 	}
-	docElement.appendChild(layerGroup);
+	m_stream << "</g>\n";
 
 	m_Doc->setCurrentPage(SavedAct);
 }
@@ -1491,7 +1523,7 @@ QString SVGExPlug::handleGlyph(uint gid, const ScFace& font)
 	ob.setAttribute("d", SetClipPath(&pts, true));
 	ob.setAttribute("id", glName);
 	globalDefs.appendChild(ob);
-	glyphNames.append(glName);
+	glyphNames.insert(glName);
 	return glName;
 }
 
@@ -1582,8 +1614,7 @@ QDomElement SVGExPlug::processArrows(PageItem *Item, const QDomElement& line, co
 					mpa.scale(1, -1);
 				patt.setAttribute("patternTransform", MatrixToStr(mpa));
 				patt.setAttribute("xlink:href", "#"+Item->strokePattern());
-				globalDefs.appendChild(patt);
-				aFill += "fill:url(#"+pattID+");";
+				aFill += "fill:url(#"+shareDefinition(patt)+");";
 			}
 			else if (Item->GrTypeStroke > 0)
 			{
@@ -1625,8 +1656,7 @@ QDomElement SVGExPlug::processArrows(PageItem *Item, const QDomElement& line, co
 				}
 				grad.setAttribute("id", "Grad"+IToStr(GradCount));
 				grad.setAttribute("gradientUnits", "userSpaceOnUse");
-				globalDefs.appendChild(grad);
-				aFill = " fill:url(#Grad"+IToStr(GradCount)+");";
+				aFill = " fill:url(#"+shareDefinition(grad)+");";
 				GradCount++;
 			}
 			else
@@ -1747,8 +1777,7 @@ QDomElement SVGExPlug::processArrows(PageItem *Item, const QDomElement& line, co
 					mpa.scale(1, -1);
 				patt.setAttribute("patternTransform", MatrixToStr(mpa));
 				patt.setAttribute("xlink:href", "#"+Item->strokePattern());
-				globalDefs.appendChild(patt);
-				aFill += "fill:url(#"+pattID+");";
+				aFill += "fill:url(#"+shareDefinition(patt)+");";
 			}
 			else if (Item->GrTypeStroke > 0)
 			{
@@ -1790,8 +1819,7 @@ QDomElement SVGExPlug::processArrows(PageItem *Item, const QDomElement& line, co
 				}
 				grad.setAttribute("id", "Grad"+IToStr(GradCount));
 				grad.setAttribute("gradientUnits", "userSpaceOnUse");
-				globalDefs.appendChild(grad);
-				aFill = " fill:url(#Grad"+IToStr(GradCount)+");";
+				aFill = " fill:url(#"+shareDefinition(grad)+");";
 				GradCount++;
 			}
 			else
@@ -1879,8 +1907,7 @@ QString SVGExPlug::handleMask(PageItem *Item, double xOffset, double yOffset)
 				mpa.scale(1, -1);
 			patt.setAttribute("patternTransform", MatrixToStr(mpa));
 			patt.setAttribute("xlink:href", "#"+Item->patternMask());
-			globalDefs.appendChild(patt);
-			ob.setAttribute("fill", "url(#"+pattID+")");
+			ob.setAttribute("fill", "url(#"+shareDefinition(patt)+")");
 		}
 		else if ((Item->GrMask == 1) || (Item->GrMask == 2) || (Item->GrMask == 4) || (Item->GrMask == 5))
 		{
@@ -1944,8 +1971,7 @@ QString SVGExPlug::handleMask(PageItem *Item, double xOffset, double yOffset)
 				itcl.setAttribute("stop-color", SetColor(cstops.at(cst)->name, cstops.at(cst)->shade));
 				grad.appendChild(itcl);
 			}
-			globalDefs.appendChild(grad);
-			ob.setAttribute("fill", "url(#Grad"+IToStr(GradCount)+")");
+			ob.setAttribute("fill", "url(#"+shareDefinition(grad)+")");
 			GradCount++;
 		}
 		if ((Item->lineColor() != CommonStrings::None) && (!Item->isGroup()))
@@ -2002,8 +2028,7 @@ QString SVGExPlug::getFillStyle(PageItem *Item)
 					mpa.scale(1, -1);
 				patt.setAttribute("patternTransform", MatrixToStr(mpa));
 				patt.setAttribute("xlink:href", "#"+Item->pattern());
-				globalDefs.appendChild(patt);
-				fill = "fill:url(#"+pattID+");";
+				fill = "fill:url(#"+shareDefinition(patt)+");";
 			}
 			else
 			{
@@ -2075,8 +2100,7 @@ QString SVGExPlug::getFillStyle(PageItem *Item)
 						isFirst  = false;
 					}
 				}
-				globalDefs.appendChild(grad);
-				fill = "fill:url(#Grad"+IToStr(GradCount)+");";
+				fill = "fill:url(#"+shareDefinition(grad)+");";
 				GradCount++;
 			}
 		}
@@ -2219,8 +2243,7 @@ QString SVGExPlug::getStrokeStyle(PageItem *Item)
 			mpa.scale(1, -1);
 		patt.setAttribute("patternTransform", MatrixToStr(mpa));
 		patt.setAttribute("xlink:href", "#"+Item->strokePattern());
-		globalDefs.appendChild(patt);
-		stroke += " stroke:url(#"+pattID+");";
+		stroke += " stroke:url(#"+shareDefinition(patt)+");";
 	}
 	else if (Item->GrTypeStroke > 0)
 	{
@@ -2293,8 +2316,7 @@ QString SVGExPlug::getStrokeStyle(PageItem *Item)
 		grad.setAttribute("gradientTransform", MatrixToStr(qmatrix));
 		grad.setAttribute("id", "Grad"+IToStr(GradCount));
 		grad.setAttribute("gradientUnits", "userSpaceOnUse");
-		globalDefs.appendChild(grad);
-		stroke += " stroke:url(#Grad"+IToStr(GradCount)+");";
+		stroke += " stroke:url(#"+shareDefinition(grad)+");";
 		GradCount++;
 	}
 	else if (Item->lineColor() != CommonStrings::None)
@@ -9,6 +9,9 @@ for which a new license (GPL+exception) is in place.
 
 #include <QObject>
 #include <QDomElement>
+#include <QHash>
+#include <QSet>
+#include <QTextStream>
 #include "pluginapi.h"
 #include "loadsaveplugin.h"
 #include "tableborder.h"
@@ -100,6 +103,17 @@ private:
 	void writeBasePatterns();
 	void writeBaseSymbols();
 	/*!
+	\brief Add a definition to the defs, unless an identical one has already been written
+	\param def definition with its id attribute set
+	\retval QString id to reference, either the one of def or of the identical definition
+	*/
+	QString shareDefinition(QDomElement& def);
+	/*!
+	\brief Write the definitions collected since the last call and start a new defs element
+	*/
+	void writeDefinitions();
+	void writeElement(const QDomNode& node);
+	/*!
 	\author Franz Schmid
 	\param ite PageItem *
 	\retval QString Clipping Path
@@ -142,10 +156,14 @@ private:
 	int MaskCount;
 	int FilterCount;
 	QString baseDir;
+	/*! \brief Only used as factory for the elements of an item, which are
+	written and released as soon as the item is processed */
 	QDomDocument docu;
-	QDomElement docElement;
 	QDomElement globalDefs;
-	QList<QString> glyphNames;
+	QTextStream m_stream;
+	QSet<QString> glyphNames;
+	//! Serialized definition without id attribute, and the id it has been written with
+	QHash<QString, QString> sharedDefinitions;
 };
 
 #endif
@@ -24,10 +24,12 @@ for which a new license (GPL+exception) is in place.
 #include <QBuffer>
 #include <QByteArray>
 #include <QComboBox>
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QFile>
 #include <QList>
 #include <QMessageBox>
+#include <QRunnable>
 #include <QScopedPointer>
 #include <QTemporaryDir>
 #include <QTextStream>
@@ -193,6 +195,8 @@ bool XPSExportPlugin::run(ScribusDoc* doc, const QString& filename)
 			if (exit == QMessageBox::No)
 				return true;
 		}
+		// the export reads the text layout of frames still waiting for it
+		doc->layoutDeferredTextFrames();
 		XPSExPlug *dia = new XPSExPlug(doc, compress->currentIndex());
 		dia->doExport(fileName);
 		delete dia;
@@ -200,7 +204,34 @@ bool XPSExportPlugin::run(ScribusDoc* doc, const QString& filename)
 	return true;
 }
 
+namespace
+{
+	//! Memory images waiting to be encoded may take, in KiB
+	const int imageWriterBudgetKiB = 256 * 1024;
+
+	class XPSImageWriter : public QRunnable
+	{
+	public:
+		XPSImageWriter(const QImage& image, const QString& fileName, QSemaphore* budget, int cost)
+			: m_image(image), m_fileName(fileName), m_budget(budget), m_cost(cost) {}
+
+		void run() override
+		{
+			m_image.save(m_fileName, "PNG");
+			m_image = QImage();
+			m_budget->release(m_cost);
+		}
+
+	private:
+		QImage m_image;
+		QString m_fileName;
+		QSemaphore* m_budget;
+		int m_cost;
+	};
+}
+
 XPSExPlug::XPSExPlug(ScribusDoc* doc, int output_res)
+	: m_imageWriterBudget(imageWriterBudgetKiB)
 {
 	m_Doc = doc;
 	conversionFactor = 96.0 / 72.0;
@@ -227,6 +258,7 @@ bool XPSExPlug::doExport(const QString& fName)
 		imageCounter = 0;
 		fontCounter = 0;
 		xps_fontMap.clear();
+		m_imageParts.clear();
 		baseDir = dir->path();
 		// Create directory tree
 		QDir outDir(baseDir);
@@ -288,6 +320,11 @@ bool XPSExPlug::doExport(const QString& fName)
 			s.writeRawData(utf8wr.data(), utf8wr.length());
 			fdo.close();
 		}
+		m_imageWriters.waitForDone();
+		// Pages have already been moved to the package, do not add their empty directories
+		QDir pagesDir(baseDir + "/Documents/1");
+		pagesDir.rmdir("Pages/_rels");
+		pagesDir.rmdir("Pages");
 		zip->write(baseDir);
 	}
 	zip->close();
@@ -301,6 +338,7 @@ void XPSExPlug::writePages(QDomElement &root)
 	for (int a = 0; a < m_Doc->Pages->count(); a++)
 	{
 		ScPage* Page = m_Doc->Pages->at(a);
+		m_pageResources.clear();
 		p_docu.setContent(QString("<FixedPage></FixedPage>"));
 		QDomElement droot  = p_docu.documentElement();
 		droot.setAttribute("xmlns", "http://schemas.microsoft.com/xps/2005/06");
@@ -324,6 +362,7 @@ void XPSExPlug::writePages(QDomElement &root)
 			QByteArray utf8wr = vo.toUtf8();
 			s.writeRawData(utf8wr.data(), utf8wr.length());
 			ft.close();
+			addToPackage(QString("Documents/1/Pages/%1.fpage").arg(a+1));
 		}
 		QFile ftr(baseDir + QString("/Documents/1/Pages/_rels/%1.fpage.rels").arg(a+1));
 		if (ftr.open(QIODevice::WriteOnly))
@@ -334,6 +373,7 @@ void XPSExPlug::writePages(QDomElement &root)
 			QByteArray utf8wr = vo.toUtf8();
 			s.writeRawData(utf8wr.data(), utf8wr.length());
 			ftr.close();
+			addToPackage(QString("Documents/1/Pages/_rels/%1.fpage.rels").arg(a+1));
 		}
 		QDomElement rel1 = f_docu.createElement("PageContent");
 		rel1.setAttribute("Source", QString("Pages/%1.fpage").arg(a+1));
@@ -343,6 +383,15 @@ void XPSExPlug::writePages(QDomElement &root)
 	}
 }
 
+void XPSExPlug::addToPackage(const QString& path)
+{
+	// Adding parts as soon as they are complete keeps the temporary directory small
+	// and leaves less to compress when the export finishes
+	QString fileName = baseDir + "/" + path;
+	if (zip->writeFile(fileName, path.section('/', 0, -2)))
+		QFile::remove(fileName);
+}
+
 void XPSExPlug::writePage(QDomElement &doc_root, QDomElement &rel_root, ScPage *Page)
 {
 	ScLayer ll;
@@ -540,20 +589,14 @@ void XPSExPlug::handleImageFallBack(PageItem *Item, QDomElement &parentElem, QDo
 	double maxSize = qMax(bounds.width(), bounds.height());
 	maxSize = qMin(3000.0, maxSize * (m_dpi / 72.0));
 	QImage tmpImg = Item->DrawObj_toImage(maxSize);
-	tmpImg.save(baseDir + "/Resources/Images/" + QString("%1.png").arg(imageCounter), "PNG");
+	QString imageName = writeImage(tmpImg, rel_root);
 	gr.setAttribute("TileMode", "None");
 	gr.setAttribute("ViewboxUnits", "Absolute");
 	gr.setAttribute("ViewportUnits", "Absolute");
 	gr.setAttribute("Viewport", "0,0,1,1");
 	gr.setAttribute("Viewbox", QString("0, 0, %1, %2").arg(tmpImg.width()).arg(tmpImg.height()));
 	gr.setAttribute("Viewport", QString("%1, %2, %3, %4").arg((Item->visualXPos() - m_Doc->currentPage()->xOffset() - maxAdd) * conversionFactor).arg((Item->visualYPos() - m_Doc->currentPage()->yOffset() - maxAdd) * conversionFactor).arg(bounds.width() * conversionFactor).arg(bounds.height() * conversionFactor));
-	gr.setAttribute("ImageSource", "/Resources/Images/" + QString("%1.png").arg(imageCounter));
-	QDomElement rel = r_docu.createElement("Relationship");
-	rel.setAttribute("Id", QString("rIDi%1").arg(imageCounter));
-	rel.setAttribute("Type", "http://schemas.microsoft.com/xps/2005/06/required-resource");
-	rel.setAttribute("Target", "/Resources/Images/" + QString("%1.png").arg(imageCounter));
-	rel_root.appendChild(rel);
-	imageCounter++;
+	gr.setAttribute("ImageSource", imageName);
 	obf.appendChild(gr);
 	ob.appendChild(obf);
 	parentElem.appendChild(ob);
@@ -719,7 +762,7 @@ void XPSExPlug::processImageItem(double xOffset, double yOffset, PageItem *Item,
 		img.applyEffect(Item->effectsInUse, m_Doc->PageColors, true);
 		img.qImagePtr()->setDotsPerMeterX(3780);
 		img.qImagePtr()->setDotsPerMeterY(3780);
-		img.qImage().save(baseDir + "/Resources/Images/" + QString("%1.png").arg(imageCounter), "PNG");
+		QString imageName = writeImage(img.qImage(), rel_root);
 		gr.setAttribute("TileMode", "None");
 		gr.setAttribute("ViewboxUnits", "Absolute");
 		gr.setAttribute("ViewportUnits", "Absolute");
@@ -742,13 +785,7 @@ void XPSExPlug::processImageItem(double xOffset, double yOffset, PageItem *Item,
 		}
 		mpx.rotate(Item->imageRotation());
 		gr.setAttribute("Transform", MatrixToStr(mpx));
-		gr.setAttribute("ImageSource", "/Resources/Images/" + QString("%1.png").arg(imageCounter));
-		QDomElement rel = r_docu.createElement("Relationship");
-		rel.setAttribute("Id", QString("rIDi%1").arg(imageCounter));
-		rel.setAttribute("Type", "http://schemas.microsoft.com/xps/2005/06/required-resource");
-		rel.setAttribute("Target", "/Resources/Images/" + QString("%1.png").arg(imageCounter));
-		rel_root.appendChild(rel);
-		imageCounter++;
+		gr.setAttribute("ImageSource", imageName);
 		obf.appendChild(gr);
 		ob2.appendChild(obf);
 		grp.appendChild(ob2);
@@ -800,15 +837,13 @@ class XPSPainter: public TextLayoutPainter
 	//PageItem *m_item;
 	QDomElement m_group;
 	XPSExPlug *m_xps;
-	QMap<QString, QString> &m_fontMap;
 	QDomElement &m_relRoot;
 
 public:
-	XPSPainter(PageItem *item, QDomElement &group, XPSExPlug *xps, QMap<QString, QString> &XPSfontMap, QDomElement &rel_root):
+	XPSPainter(PageItem *item, QDomElement &group, XPSExPlug *xps, QDomElement &rel_root):
 //		m_item(item),
 		m_group(group),
 		m_xps(xps),
-		m_fontMap(XPSfontMap),
 		m_relRoot(rel_root)
 	{ }
 
@@ -817,8 +852,7 @@ public:
 		if (gc.isControlGlyphs() || gc.isEmpty())
 			return;
 
-		if (!m_fontMap.contains(font().replacementName()))
-			m_fontMap.insert(font().replacementName(), m_xps->embedFont(font(), m_relRoot));
+		QString fontUri = m_xps->embedFont(font(), m_relRoot);
 		QTransform transform = matrix();
 		QDomElement glyph = m_xps->p_docu.createElement("Glyphs");
 		double size = fontSize() * qMax(gc.scaleV(), gc.scaleH()) * m_xps->conversionFactor;
@@ -826,7 +860,7 @@ public:
 		glyph.setAttribute("BidiLevel", "0");
 		glyph.setAttribute("StyleSimulations", "None");
 		glyph.setAttribute("FontRenderingEmSize", m_xps->FToStr(size));
-		glyph.setAttribute("FontUri", m_fontMap[font().replacementName()]);
+		glyph.setAttribute("FontUri", fontUri);
 		glyph.setAttribute("Fill", m_xps->SetColor(fillColor().color,fillColor().shade, 0));
 		glyph.setAttribute("OriginX", m_xps->FToStr(x() * m_xps->conversionFactor));
 		glyph.setAttribute("OriginY", m_xps->FToStr(y() * m_xps->conversionFactor));
@@ -1059,7 +1093,7 @@ void XPSExPlug::processTextItem(double xOffset, double yOffset, PageItem *Item,
 //	parentElem.appendChild(grp);
 	if (Item->itemText.length() != 0)
 	{
-		XPSPainter p(Item, grp, this, xps_fontMap, rel_root);
+		XPSPainter p(Item, grp, this, rel_root);
 		Item->textLayout.renderBackground(&p);
 		Item->textLayout.render(&p);
 		QDomElement grp2 = p_docu.createElement("Canvas");
@@ -1844,41 +1878,82 @@ void XPSExPlug::drawArrow(double xOffset, double yOffset, PageItem *Item, QDomEl
 
 QString XPSExPlug::embedFont(const ScFace& font, QDomElement &rel_root)
 {
-	QByteArray fontData;
-	loadRawText(font.fontFilePath(), fontData);
-	QUuid id = QUuid::createUuid();
-	QString guidString = id.toString();
-	guidString = guidString.toUpper();
-	guidString.remove("{");
-	guidString.remove("}");
-	unsigned short guid[16];
-	const static int indexes[] = {6, 4, 2, 0, 11, 9, 16, 14, 19, 21, 24, 26, 28, 30, 32, 34};
-	for (int i = 0; i < 16; i++)
-	{
-		int hex1 = hex2int(guidString[indexes[i]].cell());
-		int hex2 = hex2int(guidString[indexes[i]+1].cell());
-		guid[i] = hex1 * 16 + hex2;
-	}
-	// Obfuscation - xor bytes in font binary with bytes from guid (font's filename)
-	const static int mapping[] = {15, 14, 13, 12, 11, 10, 9, 8, 6, 7, 4, 5, 0, 1, 2, 3};
-	for (int i = 0; i < 16; i++)
-	{
-		fontData[i] = fontData[i] ^ guid[mapping[i]];
-		fontData[i+16] = fontData[i+16] ^ guid[mapping[i]];
-	}
-	QFile ft(baseDir + "/Resources/Fonts/" + guidString + ".odttf");
-	if (ft.open(QIODevice::WriteOnly))
+	QString fontUri = xps_fontMap.value(font.replacementName());
+	if (fontUri.isEmpty())
+	{
+		QByteArray fontData;
+		loadRawText(font.fontFilePath(), fontData);
+		QUuid id = QUuid::createUuid();
+		QString guidString = id.toString();
+		guidString = guidString.toUpper();
+		guidString.remove("{");
+		guidString.remove("}");
+		unsigned short guid[16];
+		const static int indexes[] = {6, 4, 2, 0, 11, 9, 16, 14, 19, 21, 24, 26, 28, 30, 32, 34};
+		for (int i = 0; i < 16; i++)
+		{
+			int hex1 = hex2int(guidString[indexes[i]].cell());
+			int hex2 = hex2int(guidString[indexes[i]+1].cell());
+			guid[i] = hex1 * 16 + hex2;
+		}
+		// Obfuscation - xor bytes in font binary with bytes from guid (font's filename)
+		const static int mapping[] = {15, 14, 13, 12, 11, 10, 9, 8, 6, 7, 4, 5, 0, 1, 2, 3};
+		for (int i = 0; i < 16; i++)
+		{
+			fontData[i] = fontData[i] ^ guid[mapping[i]];
+			fontData[i+16] = fontData[i+16] ^ guid[mapping[i]];
+		}
+		QFile ft(baseDir + "/Resources/Fonts/" + guidString + ".odttf");
+		if (ft.open(QIODevice::WriteOnly))
+		{
+			ft.write(fontData);
+			ft.close();
+		}
+		fontUri = "/Resources/Fonts/" + guidString + ".odttf";
+		xps_fontMap.insert(font.replacementName(), fontUri);
+	}
+	// Every page needs its own relationship to the resources it uses
+	if (!m_pageResources.contains(fontUri))
 	{
-		ft.write(fontData);
-		ft.close();
+		QDomElement rel = r_docu.createElement("Relationship");
+		rel.setAttribute("Id", QString("rIDf%1").arg(fontCounter));
+		rel.setAttribute("Type", "http://schemas.microsoft.com/xps/2005/06/required-resource");
+		rel.setAttribute("Target", fontUri);
+		rel_root.appendChild(rel);
+		fontCounter++;
+		m_pageResources.insert(fontUri);
+	}
+	return fontUri;
+}
+
+QString XPSExPlug::writeImage(const QImage& image, QDomElement &rel_root)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(QString("%1 %2 %3 %4 %5").arg(image.width()).arg(image.height()).arg(image.format()).arg(image.dotsPerMeterX()).arg(image.dotsPerMeterY()).toLatin1());
+	int lineBytes = (image.width() * image.depth() + 7) / 8;
+	for (int y = 0; y < image.height(); ++y)
+		hash.addData(reinterpret_cast<const char*>(image.constScanLine(y)), lineBytes);
+	QByteArray key = hash.result();
+	QString imageName = m_imageParts.value(key);
+	if (imageName.isEmpty())
+	{
+		imageName = "/Resources/Images/" + QString("%1.png").arg(m_imageParts.count());
+		m_imageParts.insert(key, imageName);
+		int cost = qBound(1, image.byteCount() / 1024, imageWriterBudgetKiB);
+		m_imageWriterBudget.acquire(cost);
+		m_imageWriters.start(new XPSImageWriter(image, baseDir + imageName, &m_imageWriterBudget, cost));
+	}
+	if (!m_pageResources.contains(imageName))
+	{
+		QDomElement rel = r_docu.createElement("Relationship");
+		rel.setAttribute("Id", QString("rIDi%1").arg(imageCounter));
+		rel.setAttribute("Type", "http://schemas.microsoft.com/xps/2005/06/required-resource");
+		rel.setAttribute("Target", imageName);
+		rel_root.appendChild(rel);
+		imageCounter++;
+		m_pageResources.insert(imageName);
 	}
-	QDomElement rel = r_docu.createElement("Relationship");
-	rel.setAttribute("Id", QString("rIDf%1").arg(fontCounter));
-	rel.setAttribute("Type", "http://schemas.microsoft.com/xps/2005/06/required-resource");
-	rel.setAttribute("Target", "/Resources/Fonts/" + guidString + ".odttf");
-	rel_root.appendChild(rel);
-	fontCounter++;
-	return "/Resources/Fonts/" + guidString + ".odttf";
+	return imageName;
 }
 
 void XPSExPlug::GetMultiStroke(struct SingleLine *sl, QDomElement &parentElem)
@@ -16,6 +16,10 @@ for which a new license (GPL+exception) is in place.
 
 #include <QObject>
 #include <QDomElement>
+#include <QHash>
+#include <QSemaphore>
+#include <QSet>
+#include <QThreadPool>
 #include "pluginapi.h"
 #include "loadsaveplugin.h"
 #include "tableborder.h"
@@ -89,7 +93,22 @@ private:
 	void processSymbolStroke(double xOffset, double yOffset, PageItem *Item, QDomElement &parentElem, QDomElement &rel_root);
 	void processArrows(double xOffset, double yOffset, PageItem *Item, QDomElement &parentElem, QDomElement &rel_root);
 	void drawArrow(double xOffset, double yOffset, PageItem *Item, QDomElement &parentElem, QDomElement &rel_root, FPointArray &arrow);
+	/*!
+	\brief Embed a font once per document and reference it from the current page
+	\retval QString part name of the embedded font
+	*/
 	QString embedFont(const ScFace& font, QDomElement &rel_root);
+	/*!
+	\brief Write an image once per document and reference it from the current page.
+	Identical images share a part, new ones are encoded to PNG on worker threads.
+	\retval QString part name of the image
+	*/
+	QString writeImage(const QImage& image, QDomElement &rel_root);
+	/*!
+	\brief Move a finished part from the temporary directory into the package
+	\param path path of the part relative to the temporary directory
+	*/
+	void addToPackage(const QString& path);
 	void GetMultiStroke(struct SingleLine *sl, QDomElement &parentElem);
 	void getStrokeStyle(PageItem *Item, QDomElement &parentElem, QDomElement &rel_root, double xOffset, double yOffset, bool forArrow = false);
 	void getFillStyle(PageItem *Item, QDomElement &parentElem, QDomElement &rel_root, double xOffset, double yOffset, bool withTransparency = true);
@@ -118,6 +137,13 @@ private:
 	int imageCounter;
 	int fontCounter;
 	QMap<QString, QString> xps_fontMap;
+	//! Content hash of the written images and their part names
+	QHash<QByteArray, QString> m_imageParts;
+	//! Fonts and images the current page has a relationship to
+	QSet<QString> m_pageResources;
+	//! Memory taken by images waiting to be encoded, in KiB
+	QSemaphore m_imageWriterBudget;
+	QThreadPool m_imageWriters;
 	struct txtRunItem
 	{
 		QChar chr;
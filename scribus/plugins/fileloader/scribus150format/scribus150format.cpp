@@ -2310,6 +2310,7 @@ void Scribus150Format::readTypographicSettings(ScribusDoc* doc, ScXmlStreamAttri
 	doc->typographicPrefs().valueUnderlineWidth  = attrs.valueAsInt("UnderlineWidth", -1);
 	doc->typographicPrefs().valueStrikeThruPos   = attrs.valueAsInt("StrikeThruPos", -1);
 	doc->typographicPrefs().valueStrikeThruWidth = attrs.valueAsInt("StrikeThruWidth", -1);
+	doc->typographicPrefs().lineBreakMode        = attrs.valueAsInt("LineBreakMode", 0, 1, 0);
 }
 
 bool Scribus150Format::readPageSets(ScribusDoc* doc, ScXmlStreamReader& reader)
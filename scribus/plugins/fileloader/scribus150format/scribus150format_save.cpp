@@ -256,6 +256,7 @@ bool Scribus150Format::saveFile(const QString & fileName, const FileFormat & /*
 	docu.writeAttribute("UnderlineWidth" , m_Doc->typographicPrefs().valueUnderlineWidth);
 	docu.writeAttribute("StrikeThruPos"  , m_Doc->typographicPrefs().valueStrikeThruPos);
 	docu.writeAttribute("StrikeThruWidth", m_Doc->typographicPrefs().valueStrikeThruWidth);
+	docu.writeAttribute("LineBreakMode"  , m_Doc->typographicPrefs().lineBreakMode);
 	docu.writeAttribute("GROUPC",m_Doc->GroupCounter);
 	docu.writeAttribute("HCMS" , static_cast<int>(m_Doc->HasCMS));
 	docu.writeAttribute("DPSo" , static_cast<int>(m_Doc->cmsSettings().SoftProofOn));
@@ -1074,10 +1074,7 @@ QString AIPlug::parseColor(QString data)
 	tmp.setSpotColor(false);
 	tmp.setRegistrationColor(false);
 	QString namPrefix = "FromAI";
-	QString fNam = m_Doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
-	if (fNam == namPrefix+tmp.name())
-		importedColors.append(fNam);
-	ret = fNam;
+	ret = colorInterner.intern(tmp, namPrefix);
 	meshColorMode = 0;
 	return ret;
 }
@@ -1096,10 +1093,7 @@ QString AIPlug::parseColorGray(QString data)
 	tmp.setSpotColor(false);
 	tmp.setRegistrationColor(false);
 	QString namPrefix = "FromAI";
-	QString fNam = m_Doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
-	if (fNam == namPrefix+tmp.name())
-		importedColors.append(fNam);
-	ret = fNam;
+	ret = colorInterner.intern(tmp, namPrefix);
 	meshColorMode = 2;
 	return ret;
 }
@@ -1119,10 +1113,7 @@ QString AIPlug::parseColorRGB(QString data)
 	tmp.setSpotColor(false);
 	tmp.setRegistrationColor(false);
 	QString namPrefix = "FromAI";
-	QString fNam = m_Doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
-	if (fNam == namPrefix+tmp.name())
-		importedColors.append(fNam);
-	ret = fNam;
+	ret = colorInterner.intern(tmp, namPrefix);
 	meshColorMode = 1;
 	return ret;
 }
@@ -1150,10 +1141,7 @@ QString AIPlug::parseCustomColor(QString data, double &shade)
 	tmp.setColorF(c, m, y, k);
 	tmp.setSpotColor(true);
 	tmp.setRegistrationColor(false);
-	QString fNam = m_Doc->PageColors.tryAddColor(FarNam, tmp);
-	if (fNam == FarNam)
-		importedColors.append(FarNam);
-	ret = fNam;
+	ret = colorInterner.internNamed(FarNam, tmp);
 	meshColorMode = 0;
 	return ret;
 }
@@ -1194,10 +1182,7 @@ QString AIPlug::parseCustomColorX(QString data, double &shade, const QString& ty
 	if (type == "0")
 		tmp.setSpotColor(true);
 	tmp.setRegistrationColor(false);
-	QString fNam = m_Doc->PageColors.tryAddColor(FarNam, tmp);
-	if (fNam == FarNam)
-		importedColors.append(FarNam);
-	ret = fNam;
+	ret = colorInterner.internNamed(FarNam, tmp);
 	return ret;
 }
 
@@ -2498,18 +2483,24 @@ void AIPlug::processData(const QString& data)
 			family.replace( QRegExp( "'" ) , QChar( ' ' ) );
 			textFont = m_Doc->itemToolPrefs().textFont;
 			bool found = false;
-			SCFontsIterator it(PrefsManager::instance()->appPrefs.fontPrefs.AvailFonts);
-			for ( ; it.hasNext(); it.next())
-			{
-				QString fam;
-				QString fn = it.current().scName();
-				int pos = fn.indexOf(" ");
-				fam = fn.left(pos);
-				if (fam == family)
+			if (knownFontFamilies.contains(family))
+				found = knownFontFamilies.value(family);
+			else
+			{
+				SCFontsIterator it(PrefsManager::instance()->appPrefs.fontPrefs.AvailFonts);
+				for ( ; it.hasNext(); it.next())
 				{
-					found = true;
-					ret = fn;
+					QString fam;
+					QString fn = it.current().scName();
+					int pos = fn.indexOf(" ");
+					fam = fn.left(pos);
+					if (fam == family)
+					{
+						found = true;
+						ret = fn;
+					}
 				}
+				knownFontFamilies.insert(family, found);
 			}
 			if (found)
 				textFont = family;
@@ -3367,6 +3358,8 @@ void AIPlug::processComment(QDataStream &ts, const QString& comment)
 bool AIPlug::convert(const QString& fn)
 {
 	QString tmp;
+	colorInterner.setColorList(&m_Doc->PageColors, &importedColors);
+	knownFontFamilies.clear();
 	LineW = 1.0;
 	Opacity = 1.0;
 	blendMode = 0;
@@ -7,6 +7,7 @@ for which a new license (GPL+exception) is in place.
 #ifndef IMPORTAI_H
 #define IMPORTAI_H
 
+#include <QHash>
 #include <QList>
 #include <QTransform>
 #include <QObject>
@@ -17,6 +18,7 @@ for which a new license (GPL+exception) is in place.
 #include "fpointarray.h"
 #include "mesh.h"
 #include "sccolor.h"
+#include "sccolorinterner.h"
 #include "text/storytext.h"
 #include "vgradient.h"
 
@@ -93,6 +95,8 @@ private:
 	QStack<FPointArray> clipStack;
 	ColorList CustColors;
 	QStringList importedColors;
+	ScColorInterner colorInterner;
+	QHash<QString, bool> knownFontFamilies;
 	QStringList importedGradients;
 	QStringList importedPatterns;
 	double baseX, baseY;
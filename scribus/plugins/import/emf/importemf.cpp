@@ -961,6 +961,7 @@ bool EmfPlug::convert(const QString& fn)
 {
 	importedColors.clear();
 	importedPatterns.clear();
+	colorInterner.setColorList(&m_Doc->PageColors, &importedColors);
 	currentDC.CurrColorFill = "White";
 	currentDC.CurrFillTrans = 0.0;
 	currentDC.CurrColorStroke = "Black";
@@ -1082,6 +1083,8 @@ bool EmfPlug::convert(const QString& fn)
 		ds.setFloatingPointPrecision(QDataStream::SinglePrecision);
 		quint32 id, size;
 		recordCount = 0;
+		// the header may claim more records than fit in the file, a record takes at least 8 bytes
+		m_Doc->beginItemBatch(qMin<qint64>(m_records, f.size() / 8));
 		while (!ds.atEnd())
 		{
 			qint64 posi = ds.device()->pos();
@@ -1696,13 +1699,14 @@ bool EmfPlug::convert(const QString& fn)
 					break;
 			}
 			ds.device()->seek(posi + size);
-			if (progressDialog)
+			if (progressDialog && (recordCount % 256 == 0))
 			{
 				progressDialog->setProgress("GI", recordCount);
 				qApp->processEvents();
 			}
 		}
 		invalidateClipGroup();
+		m_Doc->endItemBatch();
 		if (Elements.count() == 0)
 		{
 			if (importedColors.count() != 0)
@@ -2339,12 +2343,10 @@ void EmfPlug::finishItem(PageItem* ite, bool fill)
 			}
 		}
 	}
+	// Items are added to the clip group when it is closed, grouping them
+	// one by one recalculates the group for every item
 	if (clipGroup != nullptr)
-	{
-		QList<PageItem*> itemList;
-		itemList.append(ite);
-		m_Doc->groupObjectsToItem(clipGroup, itemList);
-	}
+		clipGroupItems.append(ite);
 	else
 		Elements.append(ite);
 }
@@ -2353,14 +2355,17 @@ void EmfPlug::invalidateClipGroup()
 {
 	if (clipGroup != nullptr)
 	{
-		if (clipGroup->asGroupFrame()->groupItemList.count() == 0)
+		if (clipGroupItems.count() == 0)
 		{
 			Elements.removeAll(clipGroup);
 			m_Doc->Items->removeAll(clipGroup);
 			delete clipGroup;
 		}
+		else
+			m_Doc->groupObjectsToItem(clipGroup, clipGroupItems);
 	}
 	clipGroup = nullptr;
+	clipGroupItems.clear();
 }
 
 void EmfPlug::createClipGroup()
@@ -3366,10 +3371,7 @@ QString EmfPlug::handleColor(const QColor& col)
 	tmp.setSpotColor(false);
 	tmp.setRegistrationColor(false);
 	QString tmpName = "FromEMF"+col.name().toUpper();
-	QString fNam = m_Doc->PageColors.tryAddColor(tmpName, tmp);
-	if (fNam == tmpName)
-		importedColors.append(tmpName);
-	return fNam;
+	return colorInterner.internNamed(tmpName, tmp);
 }
 
 void EmfPlug::handleFillRegion(QDataStream &ds)
@@ -17,6 +17,7 @@ for which a new license (GPL+exception) is in place.
 #include "pluginapi.h"
 #include "pageitem.h"
 #include "sccolor.h"
+#include "sccolorinterner.h"
 #include "fpointarray.h"
 #include "commonstrings.h"
 #include <QList>
@@ -297,6 +298,7 @@ private:
 	QHash<quint32, emfStyle> emfStyleMapEMP;
 	QList<PageItem*> Elements;
 	PageItem* clipGroup;
+	QList<PageItem*> clipGroupItems;
 	double docWidth;
 	double docHeight;
 	double baseX, baseY;
@@ -313,6 +315,7 @@ private:
 	QRectF bBoxDev;
 	QRectF bBoxMM;
 	QStringList importedColors;
+	ScColorInterner colorInterner;
 	QStringList importedPatterns;
 	bool interactive;
 	MultiProgressDialog * progressDialog;
@@ -60,6 +60,7 @@ for which a new license (GPL+exception) is in place.
 #include "util.h"
 #include "util_formats.h"
 #include "util_math.h"
+#include "util_parallel.h"
 
 IdmlPlug::IdmlPlug(ScribusDoc* doc, int flags)
 {
@@ -568,6 +569,7 @@ bool IdmlPlug::convert(const QString& fn)
 			}
 			else
 			{
+				listParts(fn, docElem);
 				for (QDomNode drawPag = docElem.firstChild(); !drawPag.isNull(); drawPag = drawPag.nextSibling())
 				{
 					QDomElement dpg = drawPag.toElement();
@@ -680,12 +682,95 @@ bool IdmlPlug::convert(const QString& fn)
 			}
 		}
 	}
+	preparsedParts.clear();
+	partSources.clear();
+	partIndex.clear();
 	delete fun;
 	if (progressDialog)
 		progressDialog->close();
 	return retVal;
 }
 
+void IdmlPlug::listParts(const QString& fn, const QDomElement& docElem)
+{
+	// Collect the spread and story files convert() is going to parse, in that order
+	packageFileName = fn;
+	partSources.clear();
+	partIndex.clear();
+	bool firstSpread = true;
+	for (QDomElement dpg = docElem.firstChildElement(); !dpg.isNull(); dpg = dpg.nextSiblingElement())
+	{
+		if (!dpg.hasAttribute("src"))
+			continue;
+		bool used = false;
+		if (dpg.tagName() == "idPkg:Story")
+			used = true;
+		else if ((dpg.tagName() == "idPkg:MasterSpread") && (importerFlags & LoadSavePlugin::lfCreateDoc))
+			used = true;
+		else if (dpg.tagName() == "idPkg:Spread")
+		{
+			used = (importerFlags & LoadSavePlugin::lfCreateDoc) || firstSpread;
+			firstSpread = false;
+		}
+		if (used && !partIndex.contains(dpg.attribute("src")))
+		{
+			partIndex.insert(dpg.attribute("src"), partSources.count());
+			partSources.append(dpg.attribute("src"));
+		}
+	}
+}
+
+void IdmlPlug::parsePartsAhead(int first)
+{
+	// Decompressing and parsing the parts is independent of the document, only the
+	// creation of items and text has to happen on this thread. Only a few parts are
+	// parsed ahead so that large packages are never held in memory as a whole.
+	// A zip handler must not be shared between threads, so each chunk opens its own.
+	int last = qMin(partSources.count(), first + 2 * parallelThreadCount());
+	if (last - first < 2)
+		return;
+	QVector<QDomDocument> documents(last - first);
+	QVector<char> done(last - first, 0);
+	QDomDocument* partDoms = documents.data();
+	char* partDone = done.data();
+	const QStringList& sources = partSources;
+	const QString& fn = packageFileName;
+	int grainSize = qMax(1, (last - first) / parallelThreadCount());
+	parallelFor(first, last, grainSize, [&](int chunkFirst, int chunkLast) {
+		ScZipHandler zip;
+		if (!zip.open(fn))
+			return;
+		for (int i = chunkFirst; i < chunkLast; ++i)
+		{
+			QByteArray data;
+			QDomDocument partDom;
+			if (zip.read(sources[i], data) && partDom.setContent(data))
+				partDoms[i - first] = partDom;
+			partDone[i - first] = 1;
+		}
+	});
+	for (int i = first; i < last; ++i)
+	{
+		if (done[i - first])
+			preparsedParts.insert(partSources[i], documents[i - first]);
+	}
+}
+
+bool IdmlPlug::readPart(const QString& src, QDomDocument& partDom)
+{
+	if (!preparsedParts.contains(src) && partIndex.contains(src))
+		parsePartsAhead(partIndex.value(src));
+	if (preparsedParts.contains(src))
+	{
+		// Parts are used once, release them as early as possible
+		partDom = preparsedParts.take(src);
+		return !partDom.isNull();
+	}
+	QByteArray f2;
+	fun->read(src, f2);
+	return partDom.setContent(f2);
+}
+
 bool IdmlPlug::parseFontsXML(const QDomElement& grElem)
 {
 	QDomElement grNode;
@@ -1513,9 +1598,7 @@ bool IdmlPlug::parseSpreadXML(const QDomElement& spElem)
 	QDomDocument spMapDom;
 	if (spElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		fun->read(spElem.attribute("src"), f2);
-		if (spMapDom.setContent(f2))
+		if (readPart(spElem.attribute("src"), spMapDom))
 			spNode = spMapDom.documentElement();
 		else
 			return false;
@@ -2708,9 +2791,7 @@ bool IdmlPlug::parseStoryXML(const QDomElement& stElem)
 	QDomDocument stMapDom;
 	if (stElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		fun->read(stElem.attribute("src"), f2);
-		if (stMapDom.setContent(f2))
+		if (readPart(stElem.attribute("src"), stMapDom))
 			stNode = stMapDom.documentElement();
 		else
 			return false;
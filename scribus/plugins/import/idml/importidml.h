@@ -25,6 +25,7 @@ for which a new license (GPL+exception) is in place.
 #include <QString>
 #include <QDomDocument>
 #include <QDomElement>
+#include <QHash>
 
 #include "third_party/zip/scribus_zip.h"
 
@@ -108,6 +109,9 @@ private:
 	void parseParagraphStyle(const QDomElement& styleElem);
 	bool parsePreferencesXML(const QDomElement& prElem);
 	void parsePreferencesXMLNode(const QDomElement& prNode);
+	void listParts(const QString& fn, const QDomElement& docElem);
+	void parsePartsAhead(int first);
+	bool readPart(const QString& src, QDomDocument& partDom);
 	bool parseSpreadXML(const QDomElement& spElem);
 	void parseSpreadXMLNode(const QDomElement& spNode);
 	QList<PageItem*> parseItemXML(const QDomElement& itElem, const QTransform& pTrans = QTransform());
@@ -188,6 +192,12 @@ private:
 	QMap<QString, ObjectStyle> ObjectStyles;
 
 	ScZipHandler *fun;
+	//! \brief Spread and story files in the order they are imported, with their index
+	QStringList partSources;
+	QHash<QString, int> partIndex;
+	QString packageFileName;
+	//! \brief The next few parts, parsed ahead by worker threads, by their src
+	QHash<QString, QDomDocument> preparsedParts;
 
 public slots:
 	void cancelRequested() { cancel = true; }
@@ -11,6 +11,9 @@ for which a new license (GPL+exception) is in place.
 #include <QCursor>
 #include <QDebug>
 #include <QDrag>
+#ifdef DEBUG_LOAD_TIMES
+#include <QElapsedTimer>
+#endif
 #include <QFile>
 #include <QInputDialog>
 #include <QList>
@@ -684,8 +687,26 @@ bool PdfPlug::convert(const QString& fn)
 						}
 						m_Doc->setPageSize("Custom");
 					//	m_Doc->pdfOptions().PresentVals.clear();
+#ifdef DEBUG_LOAD_TIMES
+						QElapsedTimer importTimer;
+						importTimer.start();
+						qint64 slowestPageTime = 0;
+						int slowestPage = 0;
+#endif
+						if (progressDialog)
+						{
+							progressDialog->setTotalSteps("GI", static_cast<int>(pageNs.size()));
+							progressDialog->setProgress("GI", 0);
+							qApp->processEvents();
+						}
 						for (uint ap = 0; ap < pageNs.size(); ++ap)
 						{
+							if (cancel)
+								break;
+#ifdef DEBUG_LOAD_TIMES
+							QElapsedTimer pageTimer;
+							pageTimer.start();
+#endif
 							int pp = pageNs[ap];
 							m_Doc->setActiveLayer(baseLayer);
 							if (firstPg)
@@ -819,7 +840,22 @@ bool PdfPlug::convert(const QString& fn)
 								delete pgTrans;
 							}
 							m_Doc->currentPage()->PresentVals = ef;
+#ifdef DEBUG_LOAD_TIMES
+							if (pageTimer.elapsed() > slowestPageTime)
+							{
+								slowestPageTime = pageTimer.elapsed();
+								slowestPage = pp;
+							}
+#endif
+							if (progressDialog)
+							{
+								progressDialog->setProgress("GI", static_cast<int>(ap + 1));
+								qApp->processEvents();
+							}
 						}
+#ifdef DEBUG_LOAD_TIMES
+						qDebug() << "PDF import:" << pageNs.size() << "pages in" << importTimer.elapsed() << "ms, slowest page" << slowestPage << "in" << slowestPageTime << "ms";
+#endif
 						int numjs = pdfDoc->getCatalog()->numJS();
 						if (numjs > 0)
 						{
@@ -93,10 +93,10 @@ AnoOutputDev::~AnoOutputDev()
 	delete m_itemText;
 }
 
-AnoOutputDev::AnoOutputDev(ScribusDoc* doc, QStringList *importedColors)
+AnoOutputDev::AnoOutputDev(ScribusDoc* doc, ScColorInterner* colorInterner)
 {
 	m_doc = doc;
-	m_importedColors = importedColors;
+	m_colorInterner = colorInterner;
 	CurrColorStroke = CommonStrings::None;
 	CurrColorFill = CommonStrings::None;
 	CurrColorText = "Black";
@@ -149,7 +149,7 @@ QString AnoOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		double Gc = colToDbl(rgb.g);
 		double Bc = colToDbl(rgb.b);
 		tmp.setRgbColorF(Rc, Gc, Bc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner->intern(tmp, namPrefix);
 	}
 	else if (color_space->getMode() == csDeviceCMYK)
 	{
@@ -160,7 +160,7 @@ QString AnoOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		double Yc = colToDbl(cmyk.y);
 		double Kc = colToDbl(cmyk.k);
 		tmp.setCmykColorF(Cc, Mc, Yc, Kc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner->intern(tmp, namPrefix);
 	}
 	else if ((color_space->getMode() == csCalGray) || (color_space->getMode() == csDeviceGray))
 	{
@@ -168,7 +168,7 @@ QString AnoOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		color_space->getGray(color, &gray);
 		double Kc = 1.0 - colToDbl(gray);
 		tmp.setCmykColorF(0, 0, 0, Kc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner->intern(tmp, namPrefix);
 	}
 	else if (color_space->getMode() == csSeparation)
 	{
@@ -215,7 +215,7 @@ QString AnoOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		}
 		tmp.setSpotColor(true);
 
-		fNam = m_doc->PageColors.tryAddColor(name, tmp);
+		fNam = m_colorInterner->internNamed(name, tmp, false);
 		*shade = qRound(colToDbl(color->c[0]) * 100);
 	}
 	else
@@ -226,14 +226,21 @@ QString AnoOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		double Gc = colToDbl(rgb.g);
 		double Bc = colToDbl(rgb.b);
 		tmp.setRgbColorF(Rc, Gc, Bc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner->intern(tmp, namPrefix);
 	//	qDebug() << "update fill color other colorspace" << color_space->getMode() << "treating as rgb" << Rc << Gc << Bc;
 	}
-	if (fNam == namPrefix+tmp.name())
-		m_importedColors->append(fNam);
 	return fNam;
 }
 
+// Items created by the importer are close to the end of the item lists,
+// searching from the back keeps removals cheap on documents with many pages.
+static void removeRecentItem(QList<PageItem*> *list, PageItem *item)
+{
+	int index = list->lastIndexOf(item);
+	if (index >= 0)
+		list->removeAt(index);
+}
+
 SlaOutputDev::SlaOutputDev(ScribusDoc* doc, QList<PageItem*> *Elements, QStringList *importedColors, int flags)
 {
 	m_doc = doc;
@@ -243,6 +250,7 @@ SlaOutputDev::SlaOutputDev(ScribusDoc* doc, QList<PageItem*> *Elements, QStringL
 	m_clipPaths.clear();
 	m_currentMask = "";
 	m_importedColors = importedColors;
+	m_colorInterner.setColorList(&m_doc->PageColors, m_importedColors);
 	CurrColorStroke = "Black";
 	CurrColorFill = "Black";
 	Coords = "";
@@ -652,7 +660,7 @@ bool SlaOutputDev::handleWidgetAnnot(Annot* annota, double xCoor, double yCoor,
 			AnnotAppearance *apa = annota->getAppearStreams();
 			if (apa || !achar)
 			{
-				AnoOutputDev *Adev = new AnoOutputDev(m_doc, m_importedColors);
+				AnoOutputDev *Adev = new AnoOutputDev(m_doc, &m_colorInterner);
 				Gfx *gfx = new Gfx(pdfDoc, Adev, pdfDoc->getPage(m_actPage)->getResourceDict(), annota->getRect(), nullptr);
 				ano->draw(gfx, false);
 				if (!bgFound)
@@ -874,8 +882,15 @@ void SlaOutputDev::applyTextStyle(PageItem* ite, const QString& fontName, const
 	CharStyle newStyle;
 	newStyle.setFillColor(textColor);
 	newStyle.setFontSize(fontSize * 10);
-	if (!fontName.isEmpty())
+	if (!fontName.isEmpty() && m_fontFaces.contains(fontName))
+	{
+		const ScFace& face = m_fontFaces[fontName];
+		if (!face.isNone())
+			newStyle.setFont(face);
+	}
+	else if (!fontName.isEmpty())
 	{
+		m_fontFaces.insert(fontName, ScFace());
 		SCFontsIterator it(*m_doc->AllFonts);
 		for ( ; it.hasNext() ; it.next())
 		{
@@ -883,16 +898,19 @@ void SlaOutputDev::applyTextStyle(PageItem* ite, const QString& fontName, const
 			if ((face.psName() == fontName) && (face.usable()) && (face.type() == ScFace::TTF))
 			{
 				newStyle.setFont(face);
+				m_fontFaces.insert(fontName, face);
 				break;
 			}
 			if ((face.family() == fontName) && (face.usable()) && (face.type() == ScFace::TTF))
 			{
 				newStyle.setFont(face);
+				m_fontFaces.insert(fontName, face);
 				break;
 			}
 			if ((face.scName() == fontName) && (face.usable()) && (face.type() == ScFace::TTF))
 			{
 				newStyle.setFont(face);
+				m_fontFaces.insert(fontName, face);
 				break;
 			}
 		}
@@ -1239,7 +1257,7 @@ void SlaOutputDev::endPage()
 				if (m_radioButtons.contains(refList[a]))
 				{
 					tmpSel->addItem(m_radioButtons[refList[a]], true);
-					m_Elements->removeAll(m_radioButtons[refList[a]]);
+					removeRecentItem(m_Elements, m_radioButtons[refList[a]]);
 				}
 			}
 			if (!tmpSel->isEmpty())
@@ -1276,7 +1294,7 @@ void SlaOutputDev::restoreState(GfxState *state)
 				for (int dre = 0; dre < gElements.Items.count(); ++dre)
 				{
 					tmpSel->addItem(gElements.Items.at(dre), true);
-					m_Elements->removeAll(gElements.Items.at(dre));
+					removeRecentItem(m_Elements, gElements.Items.at(dre));
 				}
 				PageItem *ite = m_doc->groupObjectsSelection(tmpSel);
 				if (ite)
@@ -1363,7 +1381,7 @@ void SlaOutputDev::endTransparencyGroup(GfxState *state)
 				for (int dre = 0; dre < gElements.Items.count(); ++dre)
 				{
 					tmpSel->addItem(gElements.Items.at(dre), true);
-					m_Elements->removeAll(gElements.Items.at(dre));
+					removeRecentItem(m_Elements, gElements.Items.at(dre));
 				}
 				PageItem *ite = m_doc->groupObjectsSelection(tmpSel);
 				ite->setFillTransparency(1.0 - state->getFillOpacity());
@@ -1381,7 +1399,7 @@ void SlaOutputDev::endTransparencyGroup(GfxState *state)
 				ite->gYpos = 0;
 				ite->setXYPos(ite->gXpos, ite->gYpos, true);
 				pat.items.append(ite);
-				m_doc->Items->removeAll(ite);
+				removeRecentItem(m_doc->Items, ite);
 				QString id = QString("Pattern_from_PDF_%1S").arg(m_doc->docPatterns.count() + 1);
 				m_doc->addPattern(id, pat);
 				m_currentMask = id;
@@ -1392,7 +1410,7 @@ void SlaOutputDev::endTransparencyGroup(GfxState *state)
 			for (int dre = 0; dre < gElements.Items.count(); ++dre)
 			{
 				tmpSel->addItem(gElements.Items.at(dre), true);
-				m_Elements->removeAll(gElements.Items.at(dre));
+				removeRecentItem(m_Elements, gElements.Items.at(dre));
 			}
 			if ((gElements.Items.count() != 1) || (gElements.isolated))
 				ite = m_doc->groupObjectsSelection(tmpSel);
@@ -1598,7 +1616,7 @@ void SlaOutputDev::stroke(GfxState *state)
 					lItem->setDashes(DashValues);
 					lItem->setDashOffset(DashOffset);
 					lItem->setTextFlowMode(PageItem::TextFlowDisabled);
-					m_doc->Items->removeAll(ite);
+					removeRecentItem(m_doc->Items, ite);
 				}
 				else
 				{
@@ -2220,7 +2238,7 @@ GBool SlaOutputDev::tilingPatternFill(GfxState *state, Gfx * /*gfx*/, Catalog *c
 		for (int dre = 0; dre < gElements.Items.count(); ++dre)
 		{
 			m_doc->m_Selection->addItem(gElements.Items.at(dre), true);
-			m_Elements->removeAll(gElements.Items.at(dre));
+			removeRecentItem(m_Elements, gElements.Items.at(dre));
 		}
 		m_doc->itemSelection_FlipV();
 		PageItem *ite;
@@ -2246,7 +2264,7 @@ GBool SlaOutputDev::tilingPatternFill(GfxState *state, Gfx * /*gfx*/, Catalog *c
 		ite->gYpos = 0;
 		ite->setXYPos(ite->gXpos, ite->gYpos, true);
 		pat.items.append(ite);
-		m_doc->Items->removeAll(ite);
+		removeRecentItem(m_doc->Items, ite);
 		id = QString("Pattern_from_PDF_%1").arg(m_doc->docPatterns.count() + 1);
 		m_doc->addPattern(id, pat);
 	}
@@ -2452,10 +2470,10 @@ void SlaOutputDev::drawImageMask(GfxState *state, Object *ref, Stream *str, int
 			}
 		}
 		else
-			m_doc->Items->removeAll(ite);
+			removeRecentItem(m_doc->Items, ite);
 	}
 	else
-		m_doc->Items->removeAll(ite);
+		removeRecentItem(m_doc->Items, ite);
 	imgStr->close();
 	delete tempFile;
 	delete imgStr;
@@ -2594,10 +2612,10 @@ void SlaOutputDev::drawSoftMaskedImage(GfxState *state, Object *ref, Stream *str
 			}
 		}
 		else
-			m_doc->Items->removeAll(ite);
+			removeRecentItem(m_doc->Items, ite);
 	}
 	else
-		m_doc->Items->removeAll(ite);
+		removeRecentItem(m_doc->Items, ite);
 	delete tempFile;
 	delete imgStr;
 	delete[] buffer;
@@ -2743,10 +2761,10 @@ void SlaOutputDev::drawMaskedImage(GfxState *state, Object *ref, Stream *str,  i
 			}
 		}
 		else
-			m_doc->Items->removeAll(ite);
+			removeRecentItem(m_doc->Items, ite);
 	}
 	else
-		m_doc->Items->removeAll(ite);
+		removeRecentItem(m_doc->Items, ite);
 	delete tempFile;
 	delete imgStr;
 	delete[] buffer;
@@ -2914,7 +2932,7 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 				}
 			}
 			else
-				m_doc->Items->removeAll(ite);
+				removeRecentItem(m_doc->Items, ite);
 		}
 		delete tempFile;
 	}
@@ -2942,7 +2960,7 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 				}
 			}
 			else
-				m_doc->Items->removeAll(ite);
+				removeRecentItem(m_doc->Items, ite);
 		}
 		delete tempFile;
 	}
@@ -3450,7 +3468,7 @@ void SlaOutputDev::endType3Char(GfxState *state)
 		for (int dre = 0; dre < gElements.Items.count(); ++dre)
 		{
 			m_doc->m_Selection->addItem(gElements.Items.at(dre), true);
-			m_Elements->removeAll(gElements.Items.at(dre));
+			removeRecentItem(m_Elements, gElements.Items.at(dre));
 		}
 		PageItem *ite;
 		if (m_doc->m_Selection->count() > 1)
@@ -3501,7 +3519,7 @@ void SlaOutputDev::endTextObject(GfxState *state)
 			for (int dre = 0; dre < gElements.Items.count(); ++dre)
 			{
 				tmpSel->addItem(gElements.Items.at(dre), true);
-				m_Elements->removeAll(gElements.Items.at(dre));
+				removeRecentItem(m_Elements, gElements.Items.at(dre));
 			}
 			PageItem *ite;
 			if (gElements.Items.count() != 1)
@@ -3551,7 +3569,7 @@ QString SlaOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		double Gc = colToDbl(rgb.g);
 		double Bc = colToDbl(rgb.b);
 		tmp.setRgbColorF(Rc, Gc, Bc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner.intern(tmp, namPrefix);
 	}
 	else if (color_space->getMode() == csDeviceCMYK)
 	{
@@ -3562,7 +3580,7 @@ QString SlaOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		double Yc = colToDbl(cmyk.y);
 		double Kc = colToDbl(cmyk.k);
 		tmp.setCmykColorF(Cc, Mc, Yc, Kc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner.intern(tmp, namPrefix);
 	}
 	else if ((color_space->getMode() == csCalGray) || (color_space->getMode() == csDeviceGray))
 	{
@@ -3570,7 +3588,7 @@ QString SlaOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		color_space->getGray(color, &gray);
 		double Kc = 1.0 - colToDbl(gray);
 		tmp.setCmykColorF(0, 0, 0, Kc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner.intern(tmp, namPrefix);
 	}
 	else if (color_space->getMode() == csSeparation)
 	{
@@ -3617,7 +3635,7 @@ QString SlaOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		}
 		tmp.setSpotColor(true);
 
-		fNam = m_doc->PageColors.tryAddColor(name, tmp);
+		fNam = m_colorInterner.internNamed(name, tmp, false);
 		*shade = qRound(colToDbl(color->c[0]) * 100);
 	}
 	else
@@ -3628,11 +3646,9 @@ QString SlaOutputDev::getColor(GfxColorSpace *color_space, POPPLER_CONST_070 Gfx
 		double Gc = colToDbl(rgb.g);
 		double Bc = colToDbl(rgb.b);
 		tmp.setRgbColorF(Rc, Gc, Bc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner.intern(tmp, namPrefix);
 //		qDebug() << "update fill color other colorspace" << color_space->getMode() << "treating as rgb" << Rc << Gc << Bc;
 	}
-	if (fNam == namPrefix+tmp.name())
-		m_importedColors->append(fNam);
 	return fNam;
 }
 
@@ -3652,7 +3668,7 @@ QString SlaOutputDev::getAnnotationColor(const AnnotColor *color)
 		double Gc = color_data[1];
 		double Bc = color_data[2];
 		tmp.setRgbColorF(Rc, Gc, Bc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner.intern(tmp, namPrefix);
 	}
 	else if (color->getSpace() == AnnotColor::colorCMYK)
 	{
@@ -3662,17 +3678,15 @@ QString SlaOutputDev::getAnnotationColor(const AnnotColor *color)
 		double Yc = color_data[2];
 		double Kc = color_data[3];
 		tmp.setCmykColorF(Cc, Mc, Yc, Kc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner.intern(tmp, namPrefix);
 	}
 	else if (color->getSpace() == AnnotColor::colorGray)
 	{
 		const double *color_data = color->getValues();
 		double Kc = 1.0 - color_data[0];
 		tmp.setCmykColorF(0, 0, 0, Kc);
-		fNam = m_doc->PageColors.tryAddColor(namPrefix+tmp.name(), tmp);
+		fNam = m_colorInterner.intern(tmp, namPrefix);
 	}
-	if (fNam == namPrefix+tmp.name())
-		m_importedColors->append(fNam);
 	return fNam;
 }
 
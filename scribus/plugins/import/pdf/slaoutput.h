@@ -23,6 +23,7 @@ for which a new license (GPL+exception) is in place.
 #include "fpointarray.h"
 #include "importpdfconfig.h"
 #include "pageitem.h"
+#include "sccolorinterner.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "selection.h"
@@ -121,7 +122,7 @@ private:
 class AnoOutputDev : public OutputDev
 {
 public:
-	AnoOutputDev(ScribusDoc* doc, QStringList *importedColors);
+	AnoOutputDev(ScribusDoc* doc, ScColorInterner* colorInterner);
 	virtual ~AnoOutputDev();
 
 	GBool isOk() { return gTrue; }
@@ -148,7 +149,7 @@ public:
 private:
 	QString getColor(GfxColorSpace *color_space, POPPLER_CONST_070 GfxColor *color, int *shade);
 	ScribusDoc* m_doc;
-	QStringList *m_importedColors;
+	ScColorInterner* m_colorInterner;
 };
 
 
@@ -315,6 +316,7 @@ private:
 	Selection* tmpSel;
 	QList<PageItem*> *m_Elements;
 	QStringList *m_importedColors;
+	ScColorInterner m_colorInterner;
 	QTransform m_ctm;
 	struct F3Entry
 	{
@@ -341,6 +343,7 @@ private:
 	FormPageWidgets *m_formWidgets;
 	QHash<QString, QList<int> > m_radioMap;
 	QHash<int, PageItem*> m_radioButtons;
+	QHash<QString, ScFace> m_fontFaces;
 	int m_actPage;
 };
 
@@ -14,6 +14,7 @@ for which a new license (GPL+exception) is in place.
 #include <QMimeData>
 #include <QPainterPath>
 #include <QRegExp>
+#include <QScopedPointer>
 #include <QTemporaryFile>
 
 #include "svgplugin.h"
@@ -40,6 +41,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
+#include "scxmlstreamreader.h"
 #include "selection.h"
 #include "ui/customfdialog.h"
 #include "ui/propertiespalette.h"
@@ -218,6 +220,38 @@ QImage SVGImportPlugin::readThumbnail(const QString& fileName)
 	return ret;
 }
 
+namespace
+{
+	//! \brief Size of uncompressed files above which the import is streamed.
+	const qint64 svgStreamingThreshold = 16 * 1024 * 1024;
+
+	//! \brief Opens a plain or gzip compressed SVG file for reading.
+	class SvgInput
+	{
+	public:
+		SvgInput(const QString& fileName, bool compressed) : m_file(fileName)
+		{
+			if (compressed)
+			{
+				m_compressor.reset(new QtIOCompressor(&m_file));
+				m_compressor->setStreamFormat(QtIOCompressor::GzipFormat);
+			}
+		}
+
+		QIODevice* open()
+		{
+			QIODevice* device = m_compressor ? static_cast<QIODevice*>(m_compressor.data()) : &m_file;
+			if (!device->open(QIODevice::ReadOnly))
+				return nullptr;
+			return device;
+		}
+
+	private:
+		QFile m_file;
+		QScopedPointer<QtIOCompressor> m_compressor;
+	};
+}
+
 SVGPlug::SVGPlug(ScribusDoc* doc, int flags)
 {
 	tmpSel = new Selection(this, false);
@@ -232,6 +266,8 @@ SVGPlug::SVGPlug(ScribusDoc* doc, int flags)
 	docDesc = "";
 	docTitle = "";
 	groupLevel = 0;
+	inputCompressed = false;
+	streamed = false;
 	importerFlags = flags;
 	interactive = (flags & LoadSavePlugin::lfInteractive);
 //	m_gc.setAutoDelete(true);
@@ -283,7 +319,7 @@ QImage SVGPlug::readThumbnail(const QString& fName)
 			m_gc.top()->matrix = matrix;
 		}
 	}
-	QList<PageItem*> Elements = parseGroup(docElem);
+	QList<PageItem*> Elements = streamed ? parseDocStream(true) : parseGroup(docElem);
 	tmpSel->clear();
 	QImage tmpImage = QImage();
 	if (Elements.count() > 0)
@@ -330,14 +366,23 @@ bool SVGPlug::loadData(const QString& fName)
 	bool isCompressed = false, success = false;
 	QByteArray bb(3, ' ');
 	QFile fi(fName);
+	qint64 fileSize = 0;
 	if (fi.open(QIODevice::ReadOnly))
 	{
+		fileSize = fi.size();
 		fi.read(bb.data(), 2);
 		fi.close();
 		// Qt4 bb[0]->QChar(bb[0])
 		if ((QChar(bb[0]) == QChar(0x1F)) && (QChar(bb[1]) == QChar(0x8B)))
 			isCompressed = true;
 	}
+	inputFileName = fName;
+	inputCompressed = (fName.right(2) == "gz") || (isCompressed);
+	// A DOM tree needs several times the size of the file, large files
+	// such as maps are converted while they are read
+	streamed = (fileSize > (inputCompressed ? svgStreamingThreshold / 8 : svgStreamingThreshold));
+	if (streamed)
+		return loadIndex();
 	if ((fName.right(2) == "gz") || (isCompressed))
 	{
 		QFile file(fName);
@@ -429,7 +474,10 @@ void SVGPlug::convert(const TransactionSettings& trSettings, int flags)
 			m_gc.top()->matrix = matrix;
 		}
 	}
-	Elements += parseDoc(docElem);
+	if (streamed)
+		Elements += parseDocStream(false);
+	else
+		Elements += parseDoc(docElem);
 	if (flags & LoadSavePlugin::lfCreateDoc)
 	{
 		m_Doc->documentInfo().setTitle(docTitle);
@@ -1209,9 +1257,28 @@ QList<PageItem*> SVGPlug::parseA(const QDomElement &e)
 
 QList<PageItem*> SVGPlug::parseGroup(const QDomElement &e)
 {
-	FPointArray clipPath;
-	QList<PageItem*> GElements, gElements;
-	if ((importerFlags & LoadSavePlugin::lfCreateDoc) && (e.hasAttribute("inkscape:groupmode")) && (e.attribute("inkscape:groupmode") == "layer"))
+	groupContext group;
+	beginGroup(e, group);
+	for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling())
+	{
+		QDomElement b = n.toElement();
+		if (b.isNull() || isIgnorableNode(b))
+			continue;
+		SvgStyle svgStyle;
+		parseStyle(&svgStyle, b);
+		if (!svgStyle.Display) 
+			continue;
+		QList<PageItem*> el = parseElement(b);
+		for (int ec = 0; ec < el.count(); ++ec)
+			group.elements.append(el.at(ec));
+	}
+	return endGroup(e, group);
+}
+
+void SVGPlug::beginGroup(const QDomElement &e, groupContext& group)
+{
+	group.isLayer = (importerFlags & LoadSavePlugin::lfCreateDoc) && (e.hasAttribute("inkscape:groupmode")) && (e.attribute("inkscape:groupmode") == "layer");
+	if (group.isLayer)
 	{
 		setupNode(e);
 		QString LayerName = e.attribute("inkscape:label", "Layer");
@@ -1226,141 +1293,129 @@ QList<PageItem*> SVGPlug::parseGroup(const QDomElement &e)
 		m_Doc->setLayerPrintable(currentLayer, true);
 		m_Doc->setLayerTransparency(currentLayer, trans);
 		firstLayer = false;
-		for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling())
-		{
-			QDomElement b = n.toElement();
-			if (b.isNull() || isIgnorableNode(b))
-				continue;
-			SvgStyle svgStyle;
-			parseStyle(&svgStyle, b);
-			if (!svgStyle.Display) 
-				continue;
-			QList<PageItem*> el = parseElement(b);
-			for (int ec = 0; ec < el.count(); ++ec)
-				GElements.append(el.at(ec));
-		}
-		delete (m_gc.pop());
 	}
 	else
 	{
-		double baseX = m_Doc->currentPage()->xOffset();
-		double baseY = m_Doc->currentPage()->yOffset();
+		group.baseX = m_Doc->currentPage()->xOffset();
+		group.baseY = m_Doc->currentPage()->yOffset();
 		groupLevel++;
 		setupNode(e);
-		parseClipPathAttr(e, clipPath);
+		parseClipPathAttr(e, group.clipPath);
 		m_gc.top()->forGroup = true;
-		int z = m_Doc->itemAdd(PageItem::Group, PageItem::Rectangle, baseX, baseY, 1, 1, 0, CommonStrings::None, CommonStrings::None);
-		PageItem *neu = m_Doc->Items->at(z);
-		for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling())
+		int z = m_Doc->itemAdd(PageItem::Group, PageItem::Rectangle, group.baseX, group.baseY, 1, 1, 0, CommonStrings::None, CommonStrings::None);
+		group.item = m_Doc->Items->at(z);
+	}
+}
+
+QList<PageItem*> SVGPlug::endGroup(const QDomElement &e, groupContext& group)
+{
+	if (group.isLayer)
+	{
+		delete (m_gc.pop());
+		return group.elements;
+	}
+	FPointArray& clipPath = group.clipPath;
+	QList<PageItem*> GElements;
+	QList<PageItem*>& gElements = group.elements;
+	PageItem *neu = group.item;
+	double baseX = group.baseX;
+	double baseY = group.baseY;
+	groupLevel--;
+	SvgStyle *gc = m_gc.top();
+	if (clipPath.empty())
+	{
+		if (!gc->clipPath.empty())
+			clipPath = gc->clipPath.copy();
+	}
+	parseFilterAttr(e, neu);
+	if (gElements.count() == 0 || (gElements.count() < 2 && (clipPath.empty()) && (gc->Opacity == 1.0)))
+	{
+		// Unfortunately we have to take the long route here, or we risk crash on undo/redo
+		// FIXME : create group object after parsing grouped objects
+		/*m_Doc->Items->takeAt(z);
+		delete neu;*/
+		Selection tmpSelection(m_Doc, false);
+		tmpSelection.addItem(neu);
+		m_Doc->itemSelection_DeleteItem(&tmpSelection);
+		for (int gr = 0; gr < gElements.count(); ++gr)
 		{
-			QDomElement b = n.toElement();
-			if (b.isNull() || isIgnorableNode(b))
-				continue;
-			SvgStyle svgStyle;
-			parseStyle(&svgStyle, b);
-			if (!svgStyle.Display) 
-				continue;
-			QList<PageItem*> el = parseElement(b);
-			for (int ec = 0; ec < el.count(); ++ec)
-				gElements.append(el.at(ec));
+			GElements.append(gElements.at(gr));
 		}
-		groupLevel--;
-		SvgStyle *gc = m_gc.top();
-		if (clipPath.empty())
+	}
+	else
+	{
+		double minx =  std::numeric_limits<double>::max();
+		double miny =  std::numeric_limits<double>::max();
+		double maxx = -std::numeric_limits<double>::max();
+		double maxy = -std::numeric_limits<double>::max();
+		GElements.append(neu);
+		for (int gr = 0; gr < gElements.count(); ++gr)
 		{
-			if (!gc->clipPath.empty())
-				clipPath = gc->clipPath.copy();
+			PageItem* currItem = gElements.at(gr);
+			double x1, x2, y1, y2;
+			currItem->getVisualBoundingRect(&x1, &y1, &x2, &y2);
+			minx = qMin(minx, x1);
+			miny = qMin(miny, y1);
+			maxx = qMax(maxx, x2);
+			maxy = qMax(maxy, y2);
 		}
-		parseFilterAttr(e, neu);
-		if (gElements.count() == 0 || (gElements.count() < 2 && (clipPath.empty()) && (gc->Opacity == 1.0)))
+		double gx = minx;
+		double gy = miny;
+		double gw = maxx - minx;
+		double gh = maxy - miny;
+		if (((gx > -9999999) && (gx < 9999999)) && ((gy > -9999999) && (gy < 9999999)) && ((gw > 0) && (gw < 9999999)) && ((gh > 0) && (gh < 9999999)))
 		{
-			// Unfortunately we have to take the long route here, or we risk crash on undo/redo
-			// FIXME : create group object after parsing grouped objects
-			/*m_Doc->Items->takeAt(z);
-			delete neu;*/
-			Selection tmpSelection(m_Doc, false);
-			tmpSelection.addItem(neu);
-			m_Doc->itemSelection_DeleteItem(&tmpSelection);
+			neu->setXYPos(gx, gy);
+			neu->setWidthHeight(gw, gh);
+			if (!clipPath.empty())
+			{
+				QTransform mm = gc->matrix;
+				neu->PoLine = clipPath.copy();
+				neu->PoLine.map(mm);
+				neu->PoLine.translate(-gx + baseX, -gy + baseY);
+				clipPath.resize(0);
+				neu->Clip = FlattenPath(neu->PoLine, neu->Segments);
+			}
+			else
+				neu->SetRectFrame();
+			if (!e.attribute("id").isEmpty())
+				neu->setItemName(e.attribute("id"));
+			else
+				neu->setItemName( tr("Group%1").arg(m_Doc->GroupCounter));
+			neu->setFillTransparency(1 - gc->Opacity);
+			neu->gXpos = neu->xPos() - gx;
+			neu->gYpos = neu->yPos() - gy;
+			neu->groupWidth = gw;
+			neu->groupHeight = gh;
 			for (int gr = 0; gr < gElements.count(); ++gr)
 			{
-				GElements.append(gElements.at(gr));
+				PageItem* currItem = gElements.at(gr);
+				currItem->gXpos = currItem->xPos() - gx;
+				currItem->gYpos = currItem->yPos() - gy;
+				currItem->gWidth = gw;
+				currItem->gHeight = gh;
+				currItem->Parent = neu;
+				neu->groupItemList.append(currItem);
+				m_Doc->Items->removeAll(currItem);
 			}
+			neu->setRedrawBounding();
+			neu->setTextFlowMode(PageItem::TextFlowDisabled);
+			m_Doc->GroupCounter++;
 		}
 		else
 		{
-			double minx =  std::numeric_limits<double>::max();
-			double miny =  std::numeric_limits<double>::max();
-			double maxx = -std::numeric_limits<double>::max();
-			double maxy = -std::numeric_limits<double>::max();
-			GElements.append(neu);
+			// Group is out of valid coordinates, remove it
+			GElements.removeAll(neu);
+			Selection tmpSelection(m_Doc, false);
+			tmpSelection.addItem(neu);
 			for (int gr = 0; gr < gElements.count(); ++gr)
 			{
-				PageItem* currItem = gElements.at(gr);
-				double x1, x2, y1, y2;
-				currItem->getVisualBoundingRect(&x1, &y1, &x2, &y2);
-				minx = qMin(minx, x1);
-				miny = qMin(miny, y1);
-				maxx = qMax(maxx, x2);
-				maxy = qMax(maxy, y2);
-			}
-			double gx = minx;
-			double gy = miny;
-			double gw = maxx - minx;
-			double gh = maxy - miny;
-			if (((gx > -9999999) && (gx < 9999999)) && ((gy > -9999999) && (gy < 9999999)) && ((gw > 0) && (gw < 9999999)) && ((gh > 0) && (gh < 9999999)))
-			{
-				neu->setXYPos(gx, gy);
-				neu->setWidthHeight(gw, gh);
-				if (!clipPath.empty())
-				{
-					QTransform mm = gc->matrix;
-					neu->PoLine = clipPath.copy();
-					neu->PoLine.map(mm);
-					neu->PoLine.translate(-gx + baseX, -gy + baseY);
-					clipPath.resize(0);
-					neu->Clip = FlattenPath(neu->PoLine, neu->Segments);
-				}
-				else
-					neu->SetRectFrame();
-				if (!e.attribute("id").isEmpty())
-					neu->setItemName(e.attribute("id"));
-				else
-					neu->setItemName( tr("Group%1").arg(m_Doc->GroupCounter));
-				neu->setFillTransparency(1 - gc->Opacity);
-				neu->gXpos = neu->xPos() - gx;
-				neu->gYpos = neu->yPos() - gy;
-				neu->groupWidth = gw;
-				neu->groupHeight = gh;
-				for (int gr = 0; gr < gElements.count(); ++gr)
-				{
-					PageItem* currItem = gElements.at(gr);
-					currItem->gXpos = currItem->xPos() - gx;
-					currItem->gYpos = currItem->yPos() - gy;
-					currItem->gWidth = gw;
-					currItem->gHeight = gh;
-					currItem->Parent = neu;
-					neu->groupItemList.append(currItem);
-					m_Doc->Items->removeAll(currItem);
-				}
-				neu->setRedrawBounding();
-				neu->setTextFlowMode(PageItem::TextFlowDisabled);
-				m_Doc->GroupCounter++;
-			}
-			else
-			{
-				// Group is out of valid coordinates, remove it
-				GElements.removeAll(neu);
-				Selection tmpSelection(m_Doc, false);
-				tmpSelection.addItem(neu);
-				for (int gr = 0; gr < gElements.count(); ++gr)
-				{
-					tmpSelection.addItem(gElements.at(gr));
-				}
-				m_Doc->itemSelection_DeleteItem(&tmpSelection);
+				tmpSelection.addItem(gElements.at(gr));
 			}
+			m_Doc->itemSelection_DeleteItem(&tmpSelection);
 		}
-		delete (m_gc.pop());
 	}
+	delete (m_gc.pop());
 	return GElements;
 }
 
@@ -1383,10 +1438,91 @@ QList<PageItem*> SVGPlug::parseDoc(const QDomElement &e)
 	return GElements;
 }
 
+QList<PageItem*> SVGPlug::parseDocStream(bool asGroup)
+{
+	QList<PageItem*> GElements;
+	SvgInput input(inputFileName, inputCompressed);
+	QIODevice* device = input.open();
+	if (!device)
+		return GElements;
+	ScXmlStreamReader reader(device);
+	reader.setNamespaceProcessing(false);
+	QDomElement docElem = inpdoc.documentElement();
+	// The top level definitions were kept by the index pass and are
+	// parsed before any content can refer to them
+	for (QDomElement defs = docElem.firstChildElement(); !defs.isNull(); defs = defs.nextSiblingElement())
+		parseDefs(defs);
+	while (!reader.atEnd() && (reader.readNext() != QXmlStreamReader::StartElement))
+		;
+	if (!reader.isStartElement())
+		return GElements;
+	if (asGroup)
+		GElements = parseGroupStream(reader, docElem);
+	else
+		GElements = parseChildrenStream(reader, true);
+	if (reader.hasError())
+		qDebug() << "SVG import:" << reader.errorString() << "at line" << reader.lineNumber();
+	return GElements;
+}
+
+QList<PageItem*> SVGPlug::parseGroupStream(ScXmlStreamReader& reader, const QDomElement &e)
+{
+	groupContext group;
+	beginGroup(e, group);
+	group.elements = parseChildrenStream(reader, false);
+	return endGroup(e, group);
+}
+
+QList<PageItem*> SVGPlug::parseChildrenStream(ScXmlStreamReader& reader, bool topLevel)
+{
+	QList<PageItem*> GElements;
+	while (!reader.atEnd())
+	{
+		QXmlStreamReader::TokenType token = reader.readNext();
+		if (token == QXmlStreamReader::EndElement)
+			break;
+		if (token != QXmlStreamReader::StartElement)
+			continue;
+		// Only the attributes are read here, the children follow in the stream
+		QDomElement b = readElement(reader);
+		if (isIgnorableNode(b))
+		{
+			reader.skipCurrentElement();
+			continue;
+		}
+		SvgStyle svgStyle;
+		parseStyle(&svgStyle, b);
+		if (!svgStyle.Display)
+		{
+			reader.skipCurrentElement();
+			continue;
+		}
+		QString STag = parseTagName(b);
+		if (topLevel && (STag == "defs"))
+		{
+			reader.skipCurrentElement();
+			continue;
+		}
+		// Referenced groups are kept as a whole for later use elements
+		if ((STag == "g") && !(b.hasAttribute("id") && isReferencedId(b.attribute("id"))))
+		{
+			QList<PageItem*> el = parseGroupStream(reader, b);
+			for (int ec = 0; ec < el.count(); ++ec)
+				GElements.append(el.at(ec));
+			continue;
+		}
+		readElementContent(reader, b);
+		QList<PageItem*> el = parseElement(b);
+		for (int ec = 0; ec < el.count(); ++ec)
+			GElements.append(el.at(ec));
+	}
+	return GElements;
+}
+
 QList<PageItem*> SVGPlug::parseElement(const QDomElement &e)
 {
 	QList<PageItem*> GElements;
-	if (e.hasAttribute("id"))
+	if (e.hasAttribute("id") && isReferencedId(e.attribute("id")))
 		m_nodeMap.insert(e.attribute("id"), e);
 	QString STag = parseTagName(e);
 	if (STag.startsWith("svg:"))
@@ -3230,6 +3366,144 @@ void SVGPlug::parseGradient(const QDomElement &e)
 	importedGradTrans.insert(origName, id);
 }
 
+bool SVGPlug::loadIndex()
+{
+	SvgInput input(inputFileName, inputCompressed);
+	QIODevice* device = input.open();
+	if (!device)
+		return false;
+	// First pass: remember the root element, the top level definitions
+	// and the ids referenced anywhere in the file
+	ScXmlStreamReader reader(device);
+	reader.setNamespaceProcessing(false);
+	QDomElement docElem;
+	int depth = 0;
+	while (!reader.atEnd())
+	{
+		QXmlStreamReader::TokenType token = reader.readNext();
+		if (token == QXmlStreamReader::EndElement)
+		{
+			--depth;
+			continue;
+		}
+		if (token != QXmlStreamReader::StartElement)
+			continue;
+		if (depth == 0)
+		{
+			docElem = readElement(reader);
+			inpdoc.appendChild(docElem);
+			collectReferences(docElem);
+		}
+		else if ((depth == 1) && ((reader.qualifiedName() == "defs") || (reader.qualifiedName() == "svg:defs")))
+		{
+			QDomElement defs = readElement(reader);
+			readElementContent(reader, defs);
+			docElem.appendChild(defs);
+			collectReferences(defs);
+			continue;
+		}
+		else
+		{
+			const QXmlStreamAttributes attrs = reader.attributes();
+			for (int i = 0; i < attrs.count(); ++i)
+				collectReferences(attrs.at(i).qualifiedName().toString(), attrs.at(i).value().toString());
+		}
+		++depth;
+	}
+	if (reader.hasError())
+	{
+		qDebug() << "SVG import:" << reader.errorString() << "at line" << reader.lineNumber();
+		return false;
+	}
+	return !docElem.isNull();
+}
+
+QDomElement SVGPlug::readElement(ScXmlStreamReader& reader)
+{
+	QDomElement e = inpdoc.createElement(reader.qualifiedName().toString());
+	const QXmlStreamAttributes attrs = reader.attributes();
+	for (int i = 0; i < attrs.count(); ++i)
+		e.setAttribute(attrs.at(i).qualifiedName().toString(), attrs.at(i).value().toString());
+	return e;
+}
+
+void SVGPlug::readElementContent(ScXmlStreamReader& reader, QDomElement& e)
+{
+	// Builds the children the same way QDomDocument::setContent() does,
+	// whitespace only text is dropped
+	QDomElement current = e;
+	while (!reader.atEnd())
+	{
+		QXmlStreamReader::TokenType token = reader.readNext();
+		if (token == QXmlStreamReader::StartElement)
+		{
+			QDomElement child = readElement(reader);
+			current.appendChild(child);
+			current = child;
+		}
+		else if (token == QXmlStreamReader::EndElement)
+		{
+			if (current == e)
+				break;
+			current = current.parentNode().toElement();
+		}
+		else if ((token == QXmlStreamReader::Characters) && !reader.isWhitespace())
+		{
+			if (reader.isCDATA())
+			{
+				current.appendChild(inpdoc.createCDATASection(reader.text().toString()));
+				continue;
+			}
+			QDomNode last = current.lastChild();
+			if (last.isText() && !last.isCDATASection())
+				last.toText().appendData(reader.text().toString());
+			else
+				current.appendChild(inpdoc.createTextNode(reader.text().toString()));
+		}
+	}
+}
+
+void SVGPlug::collectReferences(const QString& attrName, const QString& value)
+{
+	if (attrName.endsWith("href"))
+	{
+		if (value.startsWith("#"))
+			referencedIds.insert(value.mid(1));
+		return;
+	}
+	int pos = value.indexOf("url(");
+	while (pos >= 0)
+	{
+		int end = value.indexOf(')', pos);
+		if (end < 0)
+			break;
+		QString ref = value.mid(pos + 4, end - pos - 4).trimmed();
+		ref.remove('\'');
+		ref.remove('"');
+		if (ref.startsWith("#"))
+			referencedIds.insert(ref.mid(1));
+		pos = value.indexOf("url(", end);
+	}
+}
+
+void SVGPlug::collectReferences(const QDomElement &e)
+{
+	QDomNamedNodeMap attrs = e.attributes();
+	for (int i = 0; i < attrs.count(); ++i)
+	{
+		QDomAttr attr = attrs.item(i).toAttr();
+		collectReferences(attr.name(), attr.value());
+	}
+	for (QDomElement child = e.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+		collectReferences(child);
+}
+
+bool SVGPlug::isReferencedId(const QString& id) const
+{
+	// Without the index pass every element stays available, as the whole tree is in memory anyway
+	return !streamed || referencedIds.contains(id);
+}
+
 QString SVGPlug::parseTagName(const QDomElement& element)
 {
 	QString tagName(element.tagName());
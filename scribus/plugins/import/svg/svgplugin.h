@@ -11,6 +11,7 @@ for which a new license (GPL+exception) is in place.
 #include <QFont>
 #include <QList>
 #include <QRectF>
+#include <QSet>
 #include <QSizeF>
 #include <QStack>
 #include "pluginapi.h"
@@ -19,6 +20,7 @@ for which a new license (GPL+exception) is in place.
 #include "vgradient.h"
 
 class ScrAction;
+class ScXmlStreamReader;
 class ScribusMainWindow;
 class TransactionSettings;
 
@@ -237,6 +239,7 @@ public:
 	bool import(const QString& fname, const TransactionSettings& trSettings, int flags);
 	QImage readThumbnail(const QString& fn);
 	bool loadData(const QString& fname);
+	bool loadIndex();
 	void convert(const TransactionSettings& trSettings, int flags);
 	void addGraphicContext();
 	void setupNode( const QDomElement &e );
@@ -254,6 +257,9 @@ public:
 	QList<PageItem*> parseA(const QDomElement &e);
 	QList<PageItem*> parseGroup(const QDomElement &e);
 	QList<PageItem*> parseDoc(const QDomElement &e);
+	QList<PageItem*> parseDocStream(bool asGroup);
+	QList<PageItem*> parseGroupStream(ScXmlStreamReader& reader, const QDomElement &e);
+	QList<PageItem*> parseChildrenStream(ScXmlStreamReader& reader, bool topLevel);
 	QList<PageItem*> parseElement(const QDomElement &e);
 	QList<PageItem*> parseCircle(const QDomElement &e);
 	QList<PageItem*> parseEllipse(const QDomElement &e);
@@ -288,9 +294,20 @@ public:
 	void parseMarker(const QDomElement &b);
 	void parsePattern(const QDomElement &b);
 	void parseGradient( const QDomElement &e );
+	QDomElement readElement(ScXmlStreamReader& reader);
+	void readElementContent(ScXmlStreamReader& reader, QDomElement& e);
+	void collectReferences(const QString& attrName, const QString& value);
+	void collectReferences(const QDomElement &e);
+	bool isReferencedId(const QString& id) const;
 	FPoint GetMaxClipO(FPointArray Clip);
 	FPoint GetMinClipO(FPointArray Clip);
 	QDomDocument inpdoc;
+	QString inputFileName;
+	bool inputCompressed;
+	//! \brief True if the file is converted while it is read instead of from a full DOM tree.
+	bool streamed;
+	//! \brief Ids referenced from href attributes and url() values, filled by the index pass.
+	QSet<QString> referencedIds;
 	QString docDesc;
 	QString docTitle;
 	int groupLevel;
@@ -333,6 +350,17 @@ public:
 	};
 	QMap<QString, filterSpec> filters;
 	QMap<QString, markerDesc> markers;
+	struct groupContext
+	{
+		bool isLayer { false };
+		PageItem* item { nullptr };
+		double baseX { 0.0 };
+		double baseY { 0.0 };
+		FPointArray clipPath;
+		QList<PageItem*> elements;
+	};
+	void beginGroup(const QDomElement &e, groupContext& group);
+	QList<PageItem*> endGroup(const QDomElement &e, groupContext& group);
 	QList<PageItem*> Elements;
 
 protected:
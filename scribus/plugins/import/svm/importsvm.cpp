@@ -645,6 +645,7 @@ bool SvmPlug::convert(const QString& fn)
 {
 	importedColors.clear();
 	importedPatterns.clear();
+	colorInterner.setColorList(&m_Doc->PageColors, &importedColors);
 	currentDC.CurrColorFill = "White";
 	currentDC.CurrFillTrans = 0.0;
 	currentDC.CurrColorStroke = "Black";
@@ -728,6 +729,8 @@ bool SvmPlug::convert(const QString& fn)
 		ds >> head.width;
 		ds >> head.height;
 		ds >> head.actionCount;
+		// the header may claim more actions than fit in the file, an action takes at least 8 bytes
+		m_Doc->beginItemBatch(qMin<qint64>(head.actionCount, f.size() / 8));
 		while (!ds.atEnd())
 		{
 			recordCount++;
@@ -939,12 +942,13 @@ bool SvmPlug::convert(const QString& fn)
 				}
 			}
 			ds.device()->seek(posi + totalSize);
-			if (progressDialog)
+			if (progressDialog && (recordCount % 256 == 0))
 			{
 				progressDialog->setProgress("GI", recordCount);
 				qApp->processEvents();
 			}
 		}
+		m_Doc->endItemBatch();
 		if (Elements.count() == 0)
 		{
 			if (importedColors.count() != 0)
@@ -2401,10 +2405,7 @@ QString SvmPlug::handleColor(const QColor& col)
 	tmp.setSpotColor(false);
 	tmp.setRegistrationColor(false);
 	QString tmpName = "FromSVM"+col.name().toUpper();
-	QString fNam = m_Doc->PageColors.tryAddColor(tmpName, tmp);
-	if (fNam == tmpName)
-		importedColors.append(tmpName);
-	return fNam;
+	return colorInterner.internNamed(tmpName, tmp);
 }
 
 void SvmPlug::handleSetClipRegion(QDataStream &ds)
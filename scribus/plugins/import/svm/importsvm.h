@@ -17,6 +17,7 @@ for which a new license (GPL+exception) is in place.
 #include "pluginapi.h"
 #include "pageitem.h"
 #include "sccolor.h"
+#include "sccolorinterner.h"
 #include "fpointarray.h"
 #include "commonstrings.h"
 #include <QList>
@@ -309,6 +310,7 @@ private:
 	qint32 winPextendX, winPextendY;
 	qint32 winOrigX, winOrigY;
 	QStringList importedColors;
+	ScColorInterner colorInterner;
 	QStringList importedPatterns;
 	bool interactive;
 	MultiProgressDialog * progressDialog;
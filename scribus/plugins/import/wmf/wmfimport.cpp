@@ -724,6 +724,7 @@ QList<PageItem*> WMFImport::parseWmfCommands()
 	m_context.setWindowOrg( m_BBox.left(), m_BBox.bottom() );
 	m_context.setWindowExt( m_BBox.width(), m_BBox.height() );
 
+	m_Doc->beginItemBatch(m_commands.count());
 	for (int index = 0; index < m_commands.count(); ++index)
 	{
 		cmd = m_commands.at(index);
@@ -749,6 +750,7 @@ QList<PageItem*> WMFImport::parseWmfCommands()
 			cerr << str.toLatin1().data() << endl;
 		}
 	}
+	m_Doc->endItemBatch();
 	return elements;
 }
 
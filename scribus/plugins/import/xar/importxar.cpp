@@ -454,6 +454,7 @@ bool XarPlug::convert(const QString& fn)
 	imageData.resize(0);
 	importedColors.clear();
 	importedPatterns.clear();
+	colorInterner.setColorList(&m_Doc->PageColors, &importedColors);
 	firstLayer = true;
 	inTextLine = false;
 	inTextBlock = false;
@@ -3464,10 +3465,7 @@ void XarPlug::handleComplexColor(QDataStream &ts)
 					tmpName = "FromXara" + c.name();
 				else
 					tmpName = XarName;
-				QString fNam = m_Doc->PageColors.tryAddColor(tmpName, tmp);
-				if (fNam == tmpName)
-					importedColors.append(tmpName);
-				tmpName = fNam;
+				tmpName = colorInterner.internNamed(tmpName, tmp);
 			}
 			else
 			{
@@ -3478,10 +3476,7 @@ void XarPlug::handleComplexColor(QDataStream &ts)
 					tmpName = "FromXara"+c.name();
 				else
 					tmpName = XarName;
-				QString fNam = m_Doc->PageColors.tryAddColor(tmpName, tmp);
-				if (fNam == tmpName)
-					importedColors.append(tmpName);
-				tmpName = fNam;
+				tmpName = colorInterner.internNamed(tmpName, tmp);
 			}
 		}
 		else
@@ -3493,10 +3488,7 @@ void XarPlug::handleComplexColor(QDataStream &ts)
 				tmpName = "FromXara"+c.name();
 			else
 				tmpName = XarName;
-			QString fNam = m_Doc->PageColors.tryAddColor(tmpName, tmp);
-			if (fNam == tmpName)
-				importedColors.append(tmpName);
-			tmpName = fNam;
+			tmpName = colorInterner.internNamed(tmpName, tmp);
 		}
 	}
 	XarColor color;
@@ -3522,10 +3514,7 @@ void XarPlug::handleColorRGB(QDataStream &ts)
 	tmp.setSpotColor(false);
 	tmp.setRegistrationColor(false);
 	tmpName = "FromXara"+c.name();
-	QString fNam = m_Doc->PageColors.tryAddColor(tmpName, tmp);
-	if (fNam == tmpName)
-		importedColors.append(tmpName);
-	tmpName = fNam;
+	tmpName = colorInterner.internNamed(tmpName, tmp);
 	XarColor color;
 	color.colorType = 0;
 	color.colorModel = 2;
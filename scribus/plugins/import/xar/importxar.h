@@ -20,6 +20,7 @@ for which a new license (GPL+exception) is in place.
 #include "commonstrings.h"
 #include "pageitem.h"
 #include "sccolor.h"
+#include "sccolorinterner.h"
 #include "fpointarray.h"
 #include <QList>
 #include <QTransform>
@@ -472,6 +473,7 @@ private:
 	QStack<XarStyle*>	m_gc;
 	QString activeLayer;
 	QStringList importedColors;
+	ScColorInterner colorInterner;
 	QStringList importedPatterns;
 	FPointArray clipCoords;
 	FPointArray Coords;
@@ -13,7 +13,6 @@ for which a new license (GPL+exception) is in place.
 #include "collection.h"
 #include "findimage.h"
 #include "previewimage.h"
-#include "loadimage.h"
 #include "ui/scmessagebox.h"
 
 #include "fileloader.h"
@@ -122,9 +121,11 @@ PictureBrowser::PictureBrowser(ScribusDoc* doc, QWidget *parent):
 
 	pModel = new PreviewImagesModel(this);
 
-//create loadImagesThread instance, connect and run it
-	lit = new loadImagesThread(this, pModel);
-	lit->start();
+//preview icons are generated by the shared thumbnail service
+	connect(ScThumbnailService::instance(), SIGNAL(thumbnailReady(int, const QString&, const QImage&, const ScThumbnailInfo&)), this, SLOT(thumbnailReady(int, const QString&, const QImage&, const ScThumbnailInfo&)));
+	thumbnailPriorityTimer.setSingleShot(true);
+	thumbnailPriorityTimer.setInterval(50);
+	connect(&thumbnailPriorityTimer, SIGNAL(timeout()), this, SLOT(updateThumbnailPriorities()));
 
 	connect(imageViewArea, SIGNAL(clicked(const QModelIndex &)), this, SLOT(previewIconClicked(const QModelIndex &)));
 	connect(imageViewArea, SIGNAL(doubleClicked(const QModelIndex &)), this, SLOT(previewIconDoubleClicked(const QModelIndex &)));
@@ -289,10 +290,13 @@ PictureBrowser::PictureBrowser(ScribusDoc* doc, QWidget *parent):
 
 PictureBrowser::~PictureBrowser()
 {
+	ScThumbnailService::instance()->cancel(thumbnailTickets.keys());
 }
 
 void PictureBrowser::closeEvent(QCloseEvent* e)
 {
+	ScThumbnailService::instance()->cancel(thumbnailTickets.keys());
+	thumbnailTickets.clear();
 	delete pImages;
 	pImages=nullptr;
 	delete pModel;
@@ -304,7 +308,66 @@ void PictureBrowser::callLoadImageThread(int row, int pId)
 {
 	previewImage *imageToLoad = pModel->modelItemsList.at(row);
 
-	emit loadImageJob(row, imageToLoad->fileInformation.absoluteFilePath(), pbSettings.previewIconSize, pId);
+	//icons closest to the last displayed one are generated first
+	int priority = -qAbs(row - currentRow);
+	int ticket = ScThumbnailService::instance()->request(imageToLoad->fileInformation.absoluteFilePath(), pbSettings.previewIconSize, priority);
+	thumbnailTickets.insert(ticket, qMakePair(row, pId));
+	thumbnailPriorityTimer.start();
+}
+
+
+void PictureBrowser::updateThumbnailPriorities()
+{
+	ScThumbnailService *service = ScThumbnailService::instance();
+	QHash<int, QPair<int, int> >::iterator it = thumbnailTickets.begin();
+	while (it != thumbnailTickets.end())
+	{
+		int row = it.value().first;
+		int tpId = it.value().second;
+		int distance = qAbs(row - currentRow);
+		//list of files has changed or the icon scrolled far away: drop the request,
+		//it will be requested again when the icon becomes visible
+		if (!pModel || (tpId != pModel->pId) || (distance > 2 * previewIconsVisible))
+		{
+			service->cancel(it.key());
+			if (pModel)
+				pModel->processImageLoadError(row, tpId, 0);
+			it = thumbnailTickets.erase(it);
+			continue;
+		}
+		service->setPriority(it.key(), -distance);
+		++it;
+	}
+}
+
+
+void PictureBrowser::thumbnailReady(int ticket, const QString& path, const QImage& image, const ScThumbnailInfo& info)
+{
+	Q_UNUSED(path);
+	if (!thumbnailTickets.contains(ticket))
+		return;
+	QPair<int, int> request = thumbnailTickets.take(ticket);
+	//check if list of files has changed and this result is obsolete
+	if (!pModel || (request.second != pModel->pId))
+		return;
+	if (image.isNull())
+	{
+		pModel->processImageLoadError(request.first, request.second, 1);
+		return;
+	}
+
+	ImageInformation *imgInfo = new ImageInformation;
+	imgInfo->width = info.width;
+	imgInfo->height = info.height;
+	imgInfo->type = info.type;
+	imgInfo->colorspace = info.colorspace;
+	imgInfo->xdpi = info.xdpi;
+	imgInfo->ydpi = info.ydpi;
+	imgInfo->layers = info.layers;
+	imgInfo->embedded = info.embedded;
+	imgInfo->profileName = info.profileName;
+	imgInfo->valid = info.valid;
+	pModel->processLoadedImage(request.first, image, imgInfo, request.second);
 }
 
 
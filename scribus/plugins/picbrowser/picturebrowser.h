@@ -26,6 +26,10 @@ for which a new license (GPL+exception) is in place.
 
 //threads support
 #include <QThread>
+#include <QHash>
+#include <QPair>
+#include <QTimer>
+#include "scthumbnailservice.h"
 
 //documentbrowser
 #include "pageitem.h"
@@ -59,8 +63,6 @@ class collectionReaderThread;
 class collectionListReaderThread;
 class collectionWriterThread;
 class collectionsWriterThread;
-class loadImagesThread;
-class loadImagesThreadInstance;
 class findImagesThread;
 class QImage;
 class imageFilters;
@@ -105,7 +107,7 @@ class PictureBrowser : public QDialog, Ui::PictureBrowser
 		void changedDocument ( ScribusDoc* doc );
 		void closedDocument();
 
-		//posts an image which should be loaded to the imageloading thread
+		//requests a preview icon from the thumbnail service
 		void callLoadImageThread ( int row, int pId );
 		PictureBrowserSettings pbSettings;
 
@@ -117,13 +119,6 @@ class PictureBrowser : public QDialog, Ui::PictureBrowser
 		bool saveSettings;
 
 	signals:
-		//signal which posts a new job to the imageloading thread
-		//parameters:
-		//previewImage* imageToLoad: pointer to identify the previewimage
-		//QString path: path to the image
-		//int size: size of the icon, the returned QImage will be resized according to this
-		//int pId: a unique id to check wether the pointer is valid or a different set of images has been chosen while thread was executed
-		void loadImageJob ( int, QString, int, int );
 		//signals for selecting a page in the current document
 		void selectPage ( int );
 		void selectMasterPage ( QString );
@@ -132,6 +127,10 @@ class PictureBrowser : public QDialog, Ui::PictureBrowser
 		void unitChange();
 
 	private slots:
+		//called by the thumbnail service when a preview icon has been generated
+		void thumbnailReady ( int ticket, const QString& path, const QImage& image, const ScThumbnailInfo& info );
+		//reprioritizes pending preview icons around currentRow, cancels those scrolled far away
+		void updateThumbnailPriorities();
 		//slot for the navigation combobox, sets current browsingmode (folderbrowser, collectionsbrowser, documentbrowser)
 		void navigate ( int index );
 		//called when a previewicon was clicked
@@ -243,8 +242,10 @@ class PictureBrowser : public QDialog, Ui::PictureBrowser
 		previewImages *pImages;
 		//the path currently selected in folderbrowser
 		QString currPath;
-		//a thread for loading images
-		loadImagesThread *lit;
+		//pending thumbnail requests: ticket -> (row, pId)
+		QHash<int, QPair<int, int> > thumbnailTickets;
+		//coalesces priority updates of pending thumbnail requests while scrolling
+		QTimer thumbnailPriorityTimer;
 		//a thread for reading a collectionsfile
 		collectionReaderThread *crt;
 		QList<collectionReaderThread *> crtList;
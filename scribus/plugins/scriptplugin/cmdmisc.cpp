@@ -13,10 +13,12 @@ for which a new license (GPL+exception) is in place.
 #include <QList>
 
 #include "prefsmanager.h"
+#include "scimagecachemanager.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "selection.h"
+#include "text/layoutprofiler.h"
 #include "fonts/scfontmetrics.h"
 #include "pdfoptionsio.h"
 
@@ -786,6 +788,138 @@ PyObject *scribus_readpdfoptions(PyObject* /* self */, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+static void setDictItem(PyObject* dict, const char* key, PyObject* value)
+{
+	PyDict_SetItemString(dict, key, value);
+	Py_DECREF(value);
+}
+
+PyObject *scribus_getimagecachestats(PyObject* /* self */)
+{
+	ScImageCacheManager & icm = ScImageCacheManager::instance();
+	ScImageCacheManager::Statistics stats = icm.statistics();
+
+	PyObject *dict = PyDict_New();
+	if (!dict)
+		return nullptr;
+	setDictItem(dict, "hits", PyLong_FromLongLong(stats.hits));
+	setDictItem(dict, "misses", PyLong_FromLongLong(stats.misses));
+	setDictItem(dict, "stores", PyLong_FromLongLong(stats.stores));
+	setDictItem(dict, "evictions", PyLong_FromLongLong(stats.evictions));
+	setDictItem(dict, "hitRate", PyFloat_FromDouble(stats.hitRate()));
+	setDictItem(dict, "bytesSaved", PyLong_FromLongLong(stats.bytesSaved));
+	setDictItem(dict, "loadTimeSaved", PyLong_FromLongLong(stats.loadTimeSaved));
+	setDictItem(dict, "workingSetSize", PyLong_FromLongLong(stats.workingSetSize));
+	setDictItem(dict, "maxCacheSize", PyLong_FromLongLong(stats.maxCacheSize));
+	setDictItem(dict, "adaptive", PyBool_FromLong(icm.adaptiveSizing()));
+	return dict;
+}
+
+PyObject *scribus_resetimagecachestats(PyObject* /* self */)
+{
+	ScImageCacheManager::instance().resetStatistics();
+	Py_RETURN_NONE;
+}
+
+static PyObject* layoutProfileMilliseconds(qint64 nsecs)
+{
+	return PyFloat_FromDouble(nsecs / 1000000.0);
+}
+
+PyObject *scribus_getlayoutprofile(PyObject* /* self */)
+{
+	const LayoutProfiler& profiler(LayoutProfiler::instance());
+
+	PyObject *frames = PyList_New(0);
+	if (!frames)
+		return nullptr;
+	QList<LayoutProfiler::FrameProfile> profiles = profiler.frames();
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		const LayoutProfiler::FrameProfile& profile = profiles.at(i);
+		PyObject *frame = PyDict_New();
+		PyObject *paragraphs = PyDict_New();
+		if (!frame || !paragraphs)
+		{
+			Py_XDECREF(frame);
+			Py_XDECREF(paragraphs);
+			Py_DECREF(frames);
+			return nullptr;
+		}
+		QMap<int, qint64>::const_iterator it;
+		for (it = profile.paragraphs.constBegin(); it != profile.paragraphs.constEnd(); ++it)
+		{
+			PyObject *key = PyLong_FromLong(it.key());
+			PyObject *value = layoutProfileMilliseconds(it.value());
+			PyDict_SetItem(paragraphs, key, value);
+			Py_DECREF(key);
+			Py_DECREF(value);
+		}
+		setDictItem(frame, "name", PyString_FromString(profile.name.toUtf8()));
+		setDictItem(frame, "page", PyLong_FromLong(profile.page));
+		setDictItem(frame, "layouts", PyLong_FromLong(profile.layouts));
+		setDictItem(frame, "lines", PyLong_FromLong(profile.lines));
+		setDictItem(frame, "total", layoutProfileMilliseconds(profile.total));
+		setDictItem(frame, "shaping", layoutProfileMilliseconds(profile.phases[LayoutProfiler::Shaping]));
+		setDictItem(frame, "breaking", layoutProfileMilliseconds(profile.phases[LayoutProfiler::Breaking]));
+		setDictItem(frame, "boxes", layoutProfileMilliseconds(profile.phases[LayoutProfiler::Boxes]));
+		setDictItem(frame, "paragraphs", paragraphs);
+		PyList_Append(frames, frame);
+		Py_DECREF(frame);
+	}
+
+	PyObject *lookups = PyDict_New();
+	if (!lookups)
+	{
+		Py_DECREF(frames);
+		return nullptr;
+	}
+	const char* lookupNames[LayoutProfiler::LookupCount] = { "shapedText", "totalFit", "hyphenation" };
+	for (int i = 0; i < LayoutProfiler::LookupCount; ++i)
+	{
+		LayoutProfiler::Lookups counts = profiler.lookups(static_cast<LayoutProfiler::Lookup>(i));
+		PyObject *lookup = PyDict_New();
+		if (!lookup)
+		{
+			Py_DECREF(frames);
+			Py_DECREF(lookups);
+			return nullptr;
+		}
+		setDictItem(lookup, "hits", PyLong_FromLongLong(counts.hits));
+		setDictItem(lookup, "misses", PyLong_FromLongLong(counts.misses));
+		setDictItem(lookup, "hitRate", PyFloat_FromDouble(counts.hitRate()));
+		setDictItem(lookups, lookupNames[i], lookup);
+	}
+
+	PyObject *dict = PyDict_New();
+	if (!dict)
+	{
+		Py_DECREF(frames);
+		Py_DECREF(lookups);
+		return nullptr;
+	}
+	setDictItem(dict, "enabled", PyBool_FromLong(LayoutProfiler::isEnabled()));
+	setDictItem(dict, "frames", frames);
+	setDictItem(dict, "hyphenation", layoutProfileMilliseconds(profiler.time(LayoutProfiler::Hyphenation)));
+	setDictItem(dict, "lookups", lookups);
+	return dict;
+}
+
+PyObject *scribus_setlayoutprofiling(PyObject* /* self */, PyObject* args)
+{
+	int e;
+	if (!PyArg_ParseTuple(args, "i", &e))
+		return nullptr;
+	LayoutProfiler::instance().setEnabled(static_cast<bool>(e));
+	Py_RETURN_NONE;
+}
+
+PyObject *scribus_resetlayoutprofile(PyObject* /* self */)
+{
+	LayoutProfiler::instance().reset();
+	Py_RETURN_NONE;
+}
+
 /*! HACK: this removes "warning: 'blah' defined but not used" compiler warnings
 with header files structure untouched (docstrings are kept near declarations)
 PV */
@@ -806,5 +940,8 @@ void cmdmiscdocwarnings()
 	  << scribus_removelayer__doc__ << scribus_createlayer__doc__ 
 	  << scribus_getlanguage__doc__ << scribus_moveselectiontofront__doc__
 	  << scribus_moveselectiontoback__doc__ << scribus_filequit__doc__
-	  << scribus_savepdfoptions__doc__ << scribus_readpdfoptions__doc__;
+	  << scribus_savepdfoptions__doc__ << scribus_readpdfoptions__doc__
+	  << scribus_getimagecachestats__doc__ << scribus_resetimagecachestats__doc__
+	  << scribus_getlayoutprofile__doc__ << scribus_setlayoutprofiling__doc__
+	  << scribus_resetlayoutprofile__doc__;
 }
@@ -362,6 +362,52 @@ Read PDF options from fileName.\n\
 "));
 PyObject *scribus_readpdfoptions(PyObject* /* self */, PyObject* args);
 
+PyDoc_STRVAR(scribus_getimagecachestats__doc__,
+QT_TR_NOOP("getImageCacheStatistics() -> dict\n\
+\n\
+Returns the image cache usage of the running session as a dictionary with\n\
+the keys \"hits\", \"misses\", \"stores\", \"evictions\", \"hitRate\",\n\
+\"bytesSaved\", \"loadTimeSaved\" (milliseconds), \"workingSetSize\" (bytes),\n\
+\"maxCacheSize\" (bytes, the limit currently in effect) and \"adaptive\".\n\
+"));
+PyObject *scribus_getimagecachestats(PyObject* /* self */);
+
+PyDoc_STRVAR(scribus_resetimagecachestats__doc__,
+QT_TR_NOOP("resetImageCacheStatistics()\n\
+\n\
+Resets the image cache usage counters of the running session.\n\
+"));
+PyObject *scribus_resetimagecachestats(PyObject* /* self */);
+
+PyDoc_STRVAR(scribus_getlayoutprofile__doc__,
+QT_TR_NOOP("getLayoutProfile() -> dict\n\
+\n\
+Returns the text layout measurements of the running session as a dictionary\n\
+with the keys \"enabled\", \"frames\", \"hyphenation\" (milliseconds) and\n\
+\"lookups\". \"frames\" lists the frames laid out, slowest first, as\n\
+dictionaries with the keys \"name\", \"page\", \"layouts\", \"lines\", \"total\",\n\
+\"shaping\", \"breaking\", \"boxes\" (milliseconds) and \"paragraphs\", which\n\
+maps the first character of each paragraph to its layout time in the last\n\
+layout. \"lookups\" maps \"shapedText\", \"totalFit\" and \"hyphenation\" to\n\
+dictionaries with the keys \"hits\", \"misses\" and \"hitRate\".\n\
+Layouts are only measured while enabled with setLayoutProfiling(True).\n\
+"));
+PyObject *scribus_getlayoutprofile(PyObject* /* self */);
+
+PyDoc_STRVAR(scribus_setlayoutprofiling__doc__,
+QT_TR_NOOP("setLayoutProfiling(bool)\n\
+\n\
+Enables measuring text layout when bool = True, disables it otherwise.\n\
+"));
+PyObject *scribus_setlayoutprofiling(PyObject* /* self */, PyObject* args);
+
+PyDoc_STRVAR(scribus_resetlayoutprofile__doc__,
+QT_TR_NOOP("resetLayoutProfile()\n\
+\n\
+Forgets the text layout measurements of the running session.\n\
+"));
+PyObject *scribus_resetlayoutprofile(PyObject* /* self */);
+
 #endif
 
 
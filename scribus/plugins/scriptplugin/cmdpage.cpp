@@ -167,6 +167,8 @@ PyObject *scribus_pagecount(PyObject* /* self */)
 {
 	if (!checkHaveDocument())
 		return nullptr;
+	// scripts walk the pages to look at their frames, have them laid out
+	ScCore->primaryMainWindow()->doc->layoutDeferredTextFrames();
 	return PyInt_FromLong(static_cast<long>(ScCore->primaryMainWindow()->doc->Pages->count()));
 }
 
@@ -185,6 +185,8 @@ PyObject *scribus_gettextlines(PyObject* /* self */, PyObject* args)
 		PyErr_SetString(WrongFrameTypeError, QObject::tr("Cannot get number of lines of non-text frame.","python error").toLocal8Bit().constData());
 		return nullptr;
 	}
+	if (item->invalid)
+		item->layout();
 	return PyInt_FromLong(static_cast<long>(item->textLayout.lines()));
 }
 
@@ -0,0 +1,335 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include "hunspellchecker.h"
+
+#include <QThread>
+
+#include "langmgr.h"
+#include "scribusdoc.h"
+#include "text/specialchars.h"
+#include "text/storytext.h"
+
+/*! Spells words on a worker thread. The results are kept with the words,
+    the caches of the dictionaries may forget them meanwhile. */
+class SpellCheckJob : public QThread
+{
+	public:
+		QVector<HunspellChecker::Word> words;
+		/*! Version of the story the words were collected from */
+		quint64 version;
+
+	protected:
+		void run()
+		{
+			for (int i = 0; i < words.count(); ++i)
+			{
+				HunspellChecker::Word& w = words[i];
+				if (w.checked)
+					continue;
+				w.correct = w.speller->isCorrect(w.text);
+				w.checked = true;
+			}
+		}
+};
+
+HunspellChecker::HunspellChecker(StoryText* story, ScribusDoc* doc, const QMap<QString, QString>& dictionaryMap, const QMap<QString, HunspellDict*>& spellers)
+	: QObject(nullptr),
+	m_story(story),
+	m_doc(doc),
+	m_dictionaryMap(dictionaryMap),
+	m_spellers(spellers),
+	m_length(story->length()),
+	m_version(story->version()),
+	m_dirtyStart(0),
+	m_dirtyEnd(story->length()),
+	m_job(nullptr)
+{
+	// wait for a pause in typing before checking
+	m_timer.setSingleShot(true);
+	m_timer.setInterval(250);
+	connect(&m_timer, SIGNAL(timeout()), this, SLOT(checkPending()));
+	connect(story, SIGNAL(changed(int,int)), this, SLOT(storyChanged(int,int)));
+	connect(story, SIGNAL(destroyed()), this, SLOT(storyDestroyed()));
+	m_timer.start();
+}
+
+HunspellChecker::~HunspellChecker()
+{
+	if (m_job)
+	{
+		m_job->wait();
+		delete m_job;
+	}
+}
+
+void HunspellChecker::finish()
+{
+	m_timer.stop();
+	if (m_job)
+	{
+		m_job->wait();
+		delete m_job;
+		m_job = nullptr;
+	}
+	if (!m_story)
+		return;
+	recheckIfOutdated(m_version);
+	if (m_dirtyStart < 0)
+		return;
+	QVector<Word> words = collectWords();
+	for (int i = 0; i < words.count(); ++i)
+	{
+		words[i].correct = words[i].speller->isCorrect(words[i].text);
+		words[i].checked = true;
+	}
+	applyWords(words);
+}
+
+void HunspellChecker::storyChanged(int firstItem, int endItem)
+{
+	// each edit we are told about changes the version once
+	if (recheckIfOutdated(m_version + 1))
+	{
+		m_timer.start();
+		return;
+	}
+	m_version = m_story->version();
+	int newLength = m_story->length();
+	int delta = newLength - m_length;
+	m_length = newLength;
+
+	// Insertions and removals report the range up to the end of the story,
+	// only the inserted or removed characters changed then
+	int oldEnd, newEnd;
+	if (delta != 0 && endItem >= newLength)
+	{
+		oldEnd = firstItem + qMax(0, -delta);
+		newEnd = firstItem + qMax(0, delta);
+	}
+	else
+	{
+		newEnd = endItem;
+		oldEnd = qMax(firstItem, endItem - delta);
+	}
+
+	// Forget the results touching the changed range, move the following ones
+	QMap<int, WordsFound>::iterator it = m_misspelled.lowerBound(firstItem);
+	if (it != m_misspelled.begin())
+	{
+		QMap<int, WordsFound>::iterator prev = it;
+		--prev;
+		if (prev.value().end >= firstItem)
+			it = prev;
+	}
+	while (it != m_misspelled.end() && it.key() <= oldEnd)
+		it = m_misspelled.erase(it);
+	if (delta != 0)
+	{
+		QList<WordsFound> moved;
+		while (it != m_misspelled.end())
+		{
+			moved.append(it.value());
+			it = m_misspelled.erase(it);
+		}
+		for (int i = 0; i < moved.count(); ++i)
+		{
+			WordsFound& wf = moved[i];
+			wf.start += delta;
+			wf.end += delta;
+			m_misspelled.insert(m_misspelled.constEnd(), wf.start, wf);
+		}
+	}
+
+	if (m_dirtyStart < 0)
+	{
+		m_dirtyStart = firstItem;
+		m_dirtyEnd = newEnd;
+	}
+	else
+	{
+		int start = (m_dirtyStart < firstItem) ? m_dirtyStart : ((m_dirtyStart >= oldEnd) ? m_dirtyStart + delta : firstItem);
+		int end = (m_dirtyEnd < firstItem) ? m_dirtyEnd : ((m_dirtyEnd >= oldEnd) ? m_dirtyEnd + delta : firstItem);
+		m_dirtyStart = qMin(start, firstItem);
+		m_dirtyEnd = qMax(end, newEnd);
+	}
+	m_dirtyStart = qBound(0, m_dirtyStart, newLength);
+	m_dirtyEnd = qBound(m_dirtyStart, m_dirtyEnd, newLength);
+	m_timer.start();
+}
+
+void HunspellChecker::storyDestroyed()
+{
+	m_story = nullptr;
+	m_timer.stop();
+	deleteLater();
+}
+
+void HunspellChecker::checkPending()
+{
+	// a running job calls again when done
+	if (!m_story || m_job)
+		return;
+	recheckIfOutdated(m_version);
+	if (m_dirtyStart < 0)
+		return;
+
+	QVector<Word> words = collectWords();
+	if (lookUpWords(words))
+	{
+		applyWords(words);
+		return;
+	}
+	// the story may change while the job runs, the words are collected again then
+	SpellCheckJob* job = new SpellCheckJob();
+	job->words = words;
+	job->version = m_version;
+	m_job = job;
+	connect(m_job, SIGNAL(finished()), this, SLOT(jobFinished()));
+	m_job->start(QThread::LowPriority);
+}
+
+void HunspellChecker::jobFinished()
+{
+	// finish() may have waited for and deleted the job already
+	if (m_job && m_job->isFinished())
+	{
+		SpellCheckJob* job = m_job;
+		m_job = nullptr;
+		bool current = m_story && (job->version == m_version) && (m_story->version() == m_version);
+		if (current)
+			applyWords(job->words);
+		delete job;
+		if (current)
+			return;
+	}
+	checkPending();
+}
+
+QString HunspellChecker::dictionaryLanguage(int pos) const
+{
+	QString wordLang = m_story->charStyle(pos).language();
+	if (wordLang.isEmpty())
+	{
+		const StyleSet<CharStyle> &tmp(m_doc->charStyles());
+		for (int i = 0; i < tmp.count(); ++i)
+			if (tmp[i].isDefaultStyle())
+				wordLang = tmp[i].language();
+	}
+	//A little hack as for some reason our en dictionary from the aspell plugin was not called en_GB or en_US but en, content was en_GB though. Meh.
+	if (wordLang == "en")
+		wordLang = "en_GB";
+	if (!m_dictionaryMap.contains(wordLang))
+	{
+		QString altLang = LanguageManager::instance()->getAlternativeAbbrevfromAbbrev(wordLang);
+		if (!altLang.isEmpty())
+			wordLang = altLang;
+	}
+	return wordLang;
+}
+
+QVector<HunspellChecker::Word> HunspellChecker::collectWords()
+{
+	QVector<Word> words;
+	QString text = m_story->plainText();
+	BreakIterator* bi = StoryText::getWordIterator();
+	if (!bi)
+		return words;
+	bi->setText((const UChar*) text.utf16());
+
+	// start at the word touching the dirty range
+	int pos = (m_dirtyStart > 0) ? bi->preceding(m_dirtyStart) : bi->first();
+	if (pos == BreakIterator::DONE)
+		pos = 0;
+	m_dirtyStart = pos;
+	// the word starting at the end of the range may have been joined to or split
+	// from the changed text, the range only grows to the end of that word
+	int dirtyEnd = m_dirtyEnd;
+	while (pos != BreakIterator::DONE && pos <= dirtyEnd && pos < text.length())
+	{
+		int wordStart = pos;
+		pos = bi->next();
+		int wordEnd = (pos == BreakIterator::DONE) ? text.length() : pos;
+
+		bool hasLetter = false;
+		QString word;
+		for (int i = wordStart; i < wordEnd; ++i)
+		{
+			QChar ch = text.at(i);
+			hasLetter |= ch.isLetter();
+			// remove any Ignorable Code Point
+			if (!SpecialChars::isIgnorableCodePoint(ch.unicode()))
+				word += ch;
+		}
+		m_dirtyEnd = qMax(m_dirtyEnd, wordEnd);
+		if (!hasLetter)
+			continue;
+
+		Word w;
+		w.start = wordStart;
+		w.end = wordEnd;
+		w.text = word;
+		w.lang = dictionaryLanguage(wordStart);
+		w.speller = m_spellers.value(w.lang, nullptr);
+		w.checked = false;
+		w.correct = true;
+		if (w.speller)
+			words.append(w);
+	}
+	return words;
+}
+
+bool HunspellChecker::recheckIfOutdated(quint64 expectedVersion)
+{
+	if (m_story->version() == expectedVersion)
+		return false;
+	m_misspelled.clear();
+	m_version = m_story->version();
+	m_length = m_story->length();
+	m_dirtyStart = 0;
+	m_dirtyEnd = m_length;
+	return true;
+}
+
+bool HunspellChecker::lookUpWords(QVector<Word>& words)
+{
+	bool allKnown = true;
+	for (int i = 0; i < words.count(); ++i)
+	{
+		Word& w = words[i];
+		w.checked = w.speller->cachedResult(w.text, w.correct);
+		allKnown &= w.checked;
+	}
+	return allKnown;
+}
+
+void HunspellChecker::applyWords(const QVector<Word>& words)
+{
+	int start = m_dirtyStart;
+	int end = m_dirtyEnd;
+	QMap<int, WordsFound>::iterator it = m_misspelled.lowerBound(start);
+	while (it != m_misspelled.end() && it.key() < end)
+		it = m_misspelled.erase(it);
+
+	for (int i = 0; i < words.count(); ++i)
+	{
+		const Word& w = words.at(i);
+		if (w.correct)
+			continue;
+		WordsFound wf;
+		wf.start = w.start;
+		wf.end = w.end;
+		wf.w = w.text;
+		wf.changed = false;
+		wf.ignore = false;
+		wf.changeOffset = 0;
+		wf.lang = w.lang;
+		m_misspelled.insert(wf.start, wf);
+	}
+	m_dirtyStart = -1;
+	m_dirtyEnd = -1;
+	emit misspellingsChanged(start, end);
+}
@@ -0,0 +1,101 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef HUNSPELLCHECKER_H
+#define HUNSPELLCHECKER_H
+
+#include "hunspelldict.h"
+#include "hunspellpluginstructs.h"
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class ScribusDoc;
+class SpellCheckJob;
+class StoryText;
+
+/*!
+	\brief Keeps the misspelled words of a story up to date.
+
+	The checker follows the edits of a StoryText and only checks the words
+	touched by them again. Edits it was not told about, e.g. through another
+	frame of a chain sharing the text or with signals blocked, are noticed by
+	the version of the story, the whole story is checked again then. Words are spelled on a worker thread, the results
+	are remembered by the dictionaries so words occurring again are not
+	spelled twice. Word boundaries and languages are looked up on the GUI
+	thread, the worker never accesses the story.
+*/
+class HunspellChecker : public QObject
+{
+	Q_OBJECT
+
+	friend class SpellCheckJob;
+
+	public:
+		HunspellChecker(StoryText* story, ScribusDoc* doc, const QMap<QString, QString>& dictionaryMap, const QMap<QString, HunspellDict*>& spellers);
+		~HunspellChecker();
+
+		StoryText* story() const { return m_story; }
+		/*! Misspelled words found so far, ordered by position, without suggestions */
+		QList<WordsFound> misspelledWords() const { return m_misspelled.values(); }
+		/*! True while edits wait to be checked */
+		bool isBusy() const { return m_dirtyStart >= 0; }
+		/*! Checks all pending edits before returning */
+		void finish();
+
+	signals:
+		/*! The misspelled words between start and end have been updated */
+		void misspellingsChanged(int start, int end);
+
+	private slots:
+		void storyChanged(int firstItem, int endItem);
+		void storyDestroyed();
+		void checkPending();
+		void jobFinished();
+
+	private:
+		struct Word
+		{
+			int start;
+			int end;
+			QString text;
+			QString lang;
+			HunspellDict* speller;
+			/*! False until the word has been spelled */
+			bool checked;
+			bool correct;
+		};
+
+		/*! The dictionary language for the word at pos */
+		QString dictionaryLanguage(int pos) const;
+		/*! Collects the words overlapping the dirty range and extends the range to them */
+		QVector<Word> collectWords();
+		/*! Spells the words the dictionaries' caches know, returns true if all are known */
+		bool lookUpWords(QVector<Word>& words);
+		/*! Replaces the results in the dirty range, all words must have been spelled */
+		void applyWords(const QVector<Word>& words);
+		/*! Forgets all results if the story was edited unnoticed, returns true if it was */
+		bool recheckIfOutdated(quint64 expectedVersion);
+
+		StoryText* m_story;
+		ScribusDoc* m_doc;
+		QMap<QString, QString> m_dictionaryMap;
+		QMap<QString, HunspellDict*> m_spellers;
+		QMap<int, WordsFound> m_misspelled;
+		int m_length;
+		quint64 m_version;
+		/*! Range which needs checking, -1 if none */
+		int m_dirtyStart;
+		int m_dirtyEnd;
+		QTimer m_timer;
+		SpellCheckJob* m_job;
+};
+
+#endif
@@ -9,6 +9,7 @@ for which a new license (GPL+exception) is in place.
 
 #include <hunspell/hunspell.hxx>
 #include <QDebug>
+#include <QMutexLocker>
 #include <QTextCodec>
 
 #include "scconfig.h"
@@ -38,9 +39,34 @@ HunspellDict::~HunspellDict()
 	m_hunspell = nullptr;
 }
 
+bool HunspellDict::isCorrect(const QString& word)
+{
+	bool correct = false;
+	if (cachedResult(word, correct))
+		return correct;
+	correct = (spell(word) != 0);
+	QMutexLocker locker(&m_mutex);
+	// the cache is bounded, spelling again is cheaper than running out of memory
+	if (m_cache.count() >= 200000)
+		m_cache.clear();
+	m_cache.insert(word, correct);
+	return correct;
+}
+
+bool HunspellDict::cachedResult(const QString& word, bool& correct)
+{
+	QMutexLocker locker(&m_mutex);
+	QHash<QString, bool>::const_iterator it = m_cache.constFind(word);
+	if (it == m_cache.constEnd())
+		return false;
+	correct = it.value();
+	return true;
+}
+
 #ifndef HUNSPELL_NEWAPI
 int HunspellDict::spell(const QString& word)
 {
+	QMutexLocker locker(&m_mutex);
 	if (m_hunspell)
 		return m_hunspell->spell(m_codec->fromUnicode(word).constData());
 	return -1;
@@ -48,6 +74,7 @@ int HunspellDict::spell(const QString& word)
 
 QStringList HunspellDict::suggest(const QString& word)
 {
+	QMutexLocker locker(&m_mutex);
 	char **sugglist = nullptr;
 	QStringList replacements;
 
@@ -61,6 +88,7 @@ QStringList HunspellDict::suggest(const QString& word)
 #else
 int HunspellDict::spell(const QString& word)
 {
+	QMutexLocker locker(&m_mutex);
 	if (!m_hunspell)
 		return -1;
 	std::string s = m_codec->fromUnicode(word).toStdString();
@@ -69,6 +97,7 @@ int HunspellDict::spell(const QString& word)
 
 QStringList HunspellDict::suggest(const QString& word)
 {
+	QMutexLocker locker(&m_mutex);
 	QStringList replacements;
 	if (!m_hunspell)
 		return replacements;
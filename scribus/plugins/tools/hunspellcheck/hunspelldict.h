@@ -8,6 +8,8 @@ for which a new license (GPL+exception) is in place.
 #ifndef HUNSPELLDICT_H
 #define HUNSPELLDICT_H
 
+#include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 
@@ -23,9 +25,17 @@ public:
 	int spell(const QString& word);
 	QStringList suggest(const QString& word);
 
+	/*! Spells word, remembering the result. May be called from any thread. */
+	bool isCorrect(const QString& word);
+	/*! Looks up a result of isCorrect(), returns false if word was not checked yet */
+	bool cachedResult(const QString& word, bool& correct);
+
 protected:
 	Hunspell*   m_hunspell;
 	QTextCodec* m_codec;
+	/*! Hunspell is not reentrant, this guards it and the cache */
+	QMutex m_mutex;
+	QHash<QString, bool> m_cache;
 };
 
 #endif
@@ -14,14 +14,27 @@ for which a new license (GPL+exception) is in place.
 // Please don't implement the functionality of your plugin here; do that
 // in mypluginimpl.h and mypluginimpl.cpp .
 
-HunspellPlugin::HunspellPlugin()
+HunspellPlugin::HunspellPlugin() : m_impl(nullptr)
 {
 	// Set action info in languageChange, so we only have to do
 	// it in one place.
 	languageChange();
 }
 
-HunspellPlugin::~HunspellPlugin() {};
+HunspellPlugin::~HunspellPlugin()
+{
+	delete m_impl;
+}
+
+HunspellPluginImpl* HunspellPlugin::impl()
+{
+	if (!m_impl)
+	{
+		m_impl = new HunspellPluginImpl();
+		Q_CHECK_PTR(m_impl);
+	}
+	return m_impl;
+}
 
 void HunspellPlugin::languageChange()
 {
@@ -76,27 +89,22 @@ void HunspellPlugin::deleteAboutData(const AboutData* about) const
 
 bool HunspellPlugin::run(ScribusDoc* doc, const QString& target)
 {
-	HunspellPluginImpl *hunspellPluginImpl = new HunspellPluginImpl();
-	Q_CHECK_PTR(hunspellPluginImpl);
-	bool result = hunspellPluginImpl->run(target, doc);
-	delete hunspellPluginImpl;
-	return result;
+	HunspellPluginImpl *hunspellPluginImpl = impl();
+	hunspellPluginImpl->setRunningForSE(false, nullptr);
+	return hunspellPluginImpl->run(target, doc);
 }
 
 bool HunspellPlugin::run(QWidget *parent, ScribusDoc *doc, const QString& target)
 {
-	HunspellPluginImpl *hunspellPluginImpl = new HunspellPluginImpl();
-	Q_CHECK_PTR(hunspellPluginImpl);
-	bool result = false;
+	HunspellPluginImpl *hunspellPluginImpl = impl();
+	hunspellPluginImpl->setRunningForSE(false, nullptr);
 	if (parent)
 	{
 		StoryEditor* se = dynamic_cast<StoryEditor*>(parent);
 		if (se)
 			hunspellPluginImpl->setRunningForSE(true, se);
 	}
-	result = hunspellPluginImpl->run(target, doc);
-	delete hunspellPluginImpl;
-	return result;
+	return hunspellPluginImpl->run(target, doc);
 }
 
 // Low level plugin API
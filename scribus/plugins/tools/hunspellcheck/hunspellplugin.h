@@ -10,6 +10,8 @@ for which a new license (GPL+exception) is in place.
 #include "pluginapi.h"
 #include "scplugin.h"
 
+class HunspellPluginImpl;
+
 /*! \brief See scplugin.h and pluginmanager.{cpp,h} for detail on what these methods do.
 That documentatation is not duplicated here.
 Please don't implement the functionality of your plugin here; do that
@@ -32,6 +34,11 @@ class PLUGIN_API HunspellPlugin : public ScActionPlugin
 		virtual void addToMainWindowMenu(ScribusMainWindow *) {};
 
 		// Special features (none)
+
+	protected:
+		//! \brief Kept between runs so dictionaries and spelling results are reused
+		HunspellPluginImpl* m_impl;
+		HunspellPluginImpl* impl();
 };
 
 extern "C" PLUGIN_API int hunspellplugin_getPluginAPIVersion();
@@ -14,7 +14,6 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "selection.h"
-#include "text/specialchars.h"
 #include "ui/storyeditor.h"
 #include "util.h"
 
@@ -41,6 +40,10 @@ HunspellPluginImpl::HunspellPluginImpl() : QObject(nullptr)
 
 HunspellPluginImpl::~HunspellPluginImpl()
 {
+	// checkers may still be spelling with the dictionaries
+	foreach (QPointer<HunspellChecker> checker, m_checkers)
+		delete checker.data();
+	m_checkers.clear();
 	foreach (HunspellDict* h, hspellerMap)
 	{
 		delete h;
@@ -53,6 +56,7 @@ HunspellPluginImpl::~HunspellPluginImpl()
 bool HunspellPluginImpl::run(const QString & target, ScribusDoc* doc)
 {
 	m_doc=doc;
+	wordsToCorrect.clear();
 	bool initOk=initHunspell();
 	if (!initOk)
 		return false;
@@ -66,6 +70,9 @@ bool HunspellPluginImpl::run(const QString & target, ScribusDoc* doc)
 
 bool HunspellPluginImpl::initHunspell()
 {
+	// dictionaries are kept loaded between runs
+	if (!hspellerMap.isEmpty())
+		return true;
 	bool dictPathFound=LanguageManager::instance()->findSpellingDictionaries(dictionaryPaths);
 	if (!dictPathFound)
 	{
@@ -113,84 +120,29 @@ bool HunspellPluginImpl::checkWithHunspellSE()
 	return true;
 }
 
+HunspellChecker* HunspellPluginImpl::checkerFor(StoryText *iText)
+{
+	QPointer<HunspellChecker> checker = m_checkers.value(iText);
+	// a new story may have been allocated at the address of a deleted one
+	if (checker && checker->story() == iText)
+		return checker.data();
+	delete checker.data();
+	checker = new HunspellChecker(iText, m_doc, dictionaryMap, hspellerMap);
+	m_checkers.insert(iText, checker);
+	return checker.data();
+}
+
 bool HunspellPluginImpl::parseTextFrame(StoryText *iText)
 {
-	int len = iText->length();
-	int currPos = iText->firstWord(), wordStart;
-	while (currPos < len)
+	// only the text edited since the last run is checked again
+	HunspellChecker* checker = checkerFor(iText);
+	checker->finish();
+	QList<WordsFound> words = checker->misspelledWords();
+	for (int i = 0; i < words.count(); ++i)
 	{
-		wordStart = currPos;
-		int wordEnd = iText->endOfWord(wordStart);
-		QString word = iText->text(wordStart,wordEnd - wordStart);
-		// remove any Ignorable Code Point
-		QString tmp = word;
-		QString tmp2;
-		for (int i =0; i < word.size(); ++i)
-		{
-			if (!SpecialChars::isIgnorableCodePoint(tmp.at(i).unicode()))
-				tmp2 += tmp.at(i);
-		}
-		word = tmp2;
-		QString wordLang = iText->charStyle(wordStart).language();
-
-		if (wordLang.isEmpty())
-		{
-			const StyleSet<CharStyle> &tmp(m_doc->charStyles());
-			for (int i = 0; i < tmp.count(); ++i)
-				if (tmp[i].isDefaultStyle())
-				{
-					//check out why we are getting "German" back here next
-					wordLang=tmp[i].language();
-					//qDebug()<<"Default char style lang"<<tmp[i].language();
-				}
-		}
-		//we now use the abbreviation
-		//wordLang=LanguageManager::instance()->getAbbrevFromLang(wordLang, true, false);
-		//A little hack as for some reason our en dictionary from the aspell plugin was not called en_GB or en_US but en, content was en_GB though. Meh.
-		if (wordLang=="en")
-			wordLang="en_GB";
-	//	int spellerIndex=0;
-		//qDebug()<<"Word:"<<word<<wordLang;
-		if (!dictionaryMap.contains(wordLang))
-		{
-			//qDebug()<<"Spelling language to match style language NOT installed ("<<wordLang<<")";
-			QString altLang=LanguageManager::instance()->getAlternativeAbbrevfromAbbrev(wordLang);
-			if (altLang!="")
-			{
-				//qDebug()<<"altLang"<<altLang<<dictionaryMap.contains(altLang);
-				wordLang=altLang;
-			}
-		}
-		else
-		{
-			//qDebug()<<"Spelling language to match style language IS installed ("<<wordLang<<")";
-			int i = 0;
-			auto it = dictionaryMap.cbegin();
-			while (it != dictionaryMap.cend())
-			{
-				if (it.key() == wordLang)
-					break;
-				++i;
-				++it;
-			}
-		//	spellerIndex = i;
-		}
-
-		if (hspellerMap.contains(wordLang) && hspellerMap[wordLang]->spell(word)==0)
-		{
-			//qDebug()<<"hspellerMap.contains(wordLang)"<<hspellerMap.contains(wordLang)<< "hspellerMap[wordLang]->spell(word)"<<hspellerMap[wordLang]->spell(word);
-			struct WordsFound wf;
-			wf.start=wordStart;
-			wf.end=wordEnd;
-			wf.w=word;
-			wf.changed=false;
-			wf.ignore=false;
-			wf.changeOffset=0;
-			wf.lang = wordLang;
-			wf.replacements = hspellerMap[wordLang]->suggest(word);
-			wordsToCorrect.append(wf);
-		}
-		currPos = iText->endOfWord(wordStart);
+		WordsFound wf = words.at(i);
+		wf.replacements = hspellerMap[wf.lang]->suggest(wf.w);
+		wordsToCorrect.append(wf);
 	}
 	return true;
 }
@@ -7,11 +7,13 @@ for which a new license (GPL+exception) is in place.
 #ifndef HUNSPELLPLUGINIMPL_H
 #define HUNSPELLPLUGINIMPL_H
 
+#include "hunspellchecker.h"
 #include "hunspelldict.h"
 #include "hunspellpluginstructs.h"
 
 #include <QObject>
 #include <QMap>
+#include <QPointer>
 #include <QString>
 #include <QStringList>
 
@@ -40,10 +42,14 @@ class HunspellPluginImpl : public QObject
 		QList<WordsFound> wordsToCorrect;
 
 	protected:
+		/*! The checker following iText, created on first use */
+		HunspellChecker* checkerFor(StoryText *iText);
+
 		QMap<QString, QString> dictionaryMap;
 		QStringList dictionaryPaths;
 		//int numDicts, numAFFs;
 		QMap<QString, HunspellDict*> hspellerMap;
+		QMap<StoryText*, QPointer<HunspellChecker> > m_checkers;
 		ScribusDoc* m_doc;
 		bool m_runningForSE;
 		StoryEditor* m_SE;
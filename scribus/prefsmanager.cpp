@@ -227,6 +227,7 @@ void PrefsManager::initDefaults()
 	appPrefs.typoPrefs.valueUnderlineWidth = -1;
 	appPrefs.typoPrefs.valueStrikeThruPos = -1;
 	appPrefs.typoPrefs.valueStrikeThruWidth = -1;
+	appPrefs.typoPrefs.lineBreakMode = TypoPrefs::GreedyLineBreaking;
 	appPrefs.guidesPrefs.valueBaselineGrid = 14.4;
 	appPrefs.guidesPrefs.offsetBaselineGrid = 0.0;
 	appPrefs.displayPrefs.showToolTips = true;
@@ -505,6 +506,7 @@ void PrefsManager::initDefaults()
 	appPrefs.imageCachePrefs.maxCacheSizeMiB = 1000;
 	appPrefs.imageCachePrefs.maxCacheEntries = 1000;
 	appPrefs.imageCachePrefs.compressionLevel = 1;
+	appPrefs.imageCachePrefs.adaptiveSize = false;
 	appPrefs.activePageSizes.clear();
 	appPrefs.activePageSizes << "A4" << "Letter";
 
@@ -1554,6 +1556,7 @@ bool PrefsManager::WritePref(const QString& ho)
 		dcTypography.setAttribute("StrikeThruWidth", appPrefs.typoPrefs.valueStrikeThruWidth);
 	else
 		dcTypography.setAttribute("StrikeThruWidth", appPrefs.typoPrefs.valueStrikeThruWidth / 10.0);
+	dcTypography.setAttribute("LineBreakMode", appPrefs.typoPrefs.lineBreakMode);
 	elem.appendChild(dcTypography);
 
 	QDomElement dcItemTools=docu.createElement("ItemTools");
@@ -1909,6 +1912,7 @@ bool PrefsManager::WritePref(const QString& ho)
 	icElem.setAttribute("MaximumCacheSizeMiB", appPrefs.imageCachePrefs.maxCacheSizeMiB);
 	icElem.setAttribute("MaximumCacheEntries", appPrefs.imageCachePrefs.maxCacheEntries);
 	icElem.setAttribute("CompressionLevel", appPrefs.imageCachePrefs.compressionLevel);
+	icElem.setAttribute("AdaptiveSize", appPrefs.imageCachePrefs.adaptiveSize);
 	elem.appendChild(icElem);
 	// active page sizes
 	QDomElement apsElem = docu.createElement("ActivePageSizes");
@@ -2161,6 +2165,7 @@ bool PrefsManager::ReadPref(const QString& ho)
 				appPrefs.typoPrefs.valueStrikeThruWidth = qRound(stw * 10);
 			else
 				appPrefs.typoPrefs.valueStrikeThruWidth = -1;
+			appPrefs.typoPrefs.lineBreakMode = dc.valueAsInt("LineBreakMode", 0, 1, 0);
 		}
 
 
@@ -2679,6 +2684,7 @@ bool PrefsManager::ReadPref(const QString& ho)
 			appPrefs.imageCachePrefs.maxCacheSizeMiB = dc.attribute("MaximumCacheSizeMiB", "1000").toInt();
 			appPrefs.imageCachePrefs.maxCacheEntries = dc.attribute("MaximumCacheEntries", "1000").toInt();
 			appPrefs.imageCachePrefs.compressionLevel = dc.attribute("CompressionLevel", "1").toInt();
+			appPrefs.imageCachePrefs.adaptiveSize = static_cast<bool>(dc.attribute("AdaptiveSize", "0").toInt());
 		}
 		// active page sizes
 		if (dc.tagName() == "ActivePageSizes")
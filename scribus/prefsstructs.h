@@ -69,6 +69,12 @@ struct VerifierPrefs
 
 struct TypoPrefs
 {
+	enum LineBreakMode
+	{
+		GreedyLineBreaking = 0, //! Fill each line as much as possible
+		TotalFitLineBreaking = 1 //! Choose the breaks of all lines of a paragraph together
+	};
+
 	int valueSuperScript; //! Displacement of superscript
 	int scalingSuperScript; //! Scaling of superscript
 	int valueSubScript; //! Displacement of subscript
@@ -79,6 +85,7 @@ struct TypoPrefs
 	int valueUnderlineWidth; //! Underline width
 	int valueStrikeThruPos; //! Strike-through displacement
 	int valueStrikeThruWidth; //! Strike-through line width
+	int lineBreakMode; //! Line breaking of justified paragraphs, see LineBreakMode
 
 	inline bool operator==(const TypoPrefs &other)
 	{
@@ -458,6 +465,7 @@ struct ImageCachePrefs
 	int maxCacheSizeMiB;  //!< Maximum total size of image cache in MiB
 	int maxCacheEntries;  //!< Maximum number of cache entries
 	int compressionLevel; //!< Cache image compression level (see QImage)
+	bool adaptiveSize;    //!< Adapt the cache size to the images reused in recent sessions
 };
 
 struct ApplicationPrefs
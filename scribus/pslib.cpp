@@ -33,6 +33,7 @@ for which a new license (GPL+exception) is in place.
 #include <QByteArray>
 #include <QRegExp>
 #include <QBuffer>
+#include <QSet>
 #include <QStack>
 
 #include "cmsettings.h"
@@ -61,6 +62,18 @@ for which a new license (GPL+exception) is in place.
 #include "util_math.h"
 #include "text/boxes.h"
 
+namespace
+{
+	//! Memory images kept for the plates of a page may take
+	const qint64 plateImageBudget = Q_INT64_C(512) * 1024 * 1024;
+}
+
+struct PSLib::LoadedImage
+{
+	ScImage image;
+	QByteArray mask;
+};
+
 using namespace TableUtils;
 
 class PSPainter:public TextLayoutPainter
@@ -236,10 +249,15 @@ PSLib::PSLib(PrintOptions &options, bool psart, SCFonts &AllFonts, QMap<QString,
 {
 	Options = options;
 	optimization = OptimizeCompat;
+	// Six decimals keep the resolution of the former six significant digits
+	// for values below one, without switching to exponent notation
+	m_operatorStream.setPrecision(6);
 	m_Doc = nullptr;
 	progressDialog = nullptr;
 	abortExport = false;
 	PageIndex = 0;
+	m_plateImagesPage = -1;
+	m_plateImagesSize = 0;
 	User = "";
 	Creator = "Scribus" + QString(VERSION);
 	Titel = "";
@@ -443,6 +461,12 @@ void PSLib::PutStream(const char* array, int length, bool hexEnc)
 		spoolStream.writeRawData(array, length);
 }
 
+void PSLib::PutStream(ScOperatorStream& stream)
+{
+	spoolStream.writeRawData(stream.data().constData(), stream.size());
+	stream.clear();
+}
+
 bool PSLib::PutImageToStream(ScImage& image, int plate)
 {
 	bool writeSucceed = false;
@@ -538,8 +562,8 @@ void PSLib::WriteASCII85Bytes(const unsigned char* array, int length)
 
 QString PSLib::ToStr(double c)
 {
-	QString cc;
-	return cc.setNum(c);
+	char number[ScOperatorStream::NumberBufferSize];
+	return QString::fromLatin1(number, ScOperatorStream::formatNumber(number, c, m_operatorStream.precision()));
 }
 
 QString PSLib::IToStr(int c)
@@ -550,8 +574,11 @@ QString PSLib::IToStr(int c)
 
 QString PSLib::MatrixToStr(double m11, double m12, double m21, double m22, double x, double y)
 {
-	QString cc("[%1 %2 %3 %4 %5 %6]");
-	return  cc.arg(m11).arg(m12).arg(m21).arg(m22).arg(x).arg(y);
+	ScOperatorStream matrix(m_operatorStream.precision());
+	matrix << '[' << m11 << m12 << m21 << m22 << x;
+	matrix.appendNumber(y);
+	matrix << ']';
+	return QString::fromLatin1(matrix.data());
 }
 
 void PSLib::PS_set_Info(const QString& art, const QString& was)
@@ -948,17 +975,20 @@ void PSLib::PS_end_page()
 
 void PSLib::PS_curve(double x1, double y1, double x2, double y2, double x3, double y3)
 {
-	PutStream(ToStr(x1) + " " + ToStr(y1) + " " + ToStr(x2) + " " + ToStr(y2) + " " + ToStr(x3) + " " + ToStr(y3) + " cu\n");
+	m_operatorStream << x1 << y1 << x2 << y2 << x3 << y3;
+	PutStream(m_operatorStream.op("cu"));
 }
 
 void PSLib::PS_moveto(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " m\n");
+	m_operatorStream << x << y;
+	PutStream(m_operatorStream.op("m"));
 }
 
 void PSLib::PS_lineto(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " li\n");
+	m_operatorStream << x << y;
+	PutStream(m_operatorStream.op("li"));
 }
 
 void PSLib::PS_closepath()
@@ -1180,7 +1210,12 @@ bool PSLib::PS_ImageData(PageItem *item, const QString& fn, const QString& Name,
 			return false;
 		}
 	}
-	if ((maskArray.size() > 0) && (item->pixm.imgInfo.type != ImageType7))
+	ImageResource resource;
+	resource.width = image.width();
+	resource.height = image.height();
+	resource.hasMask = (maskArray.size() > 0) && (item->pixm.imgInfo.type != ImageType7);
+	m_imageResources.insert(Name, resource);
+	if (resource.hasMask)
 	{
 		PutStream("currentfile /ASCII85Decode filter /FlateDecode filter /ReusableStreamDecode filter\n");
 		if (!PutImageToStream(image, maskArray, -1))
@@ -1206,7 +1241,6 @@ bool PSLib::PS_ImageData(PageItem *item, const QString& fn, const QString& Name,
 
 bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, double scalex, double scaley, const QString& Prof, bool UseEmbedded, const QString& Name)
 {
-	bool dummy;
 	QByteArray tmp;
 
 	QFileInfo fi = QFileInfo(fn);
@@ -1249,30 +1283,32 @@ bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, doub
 		return false;
 	}
 
-	ScImage image;
-	image.imgInfo.valid = false;
-	image.imgInfo.clipPath = "";
-	image.imgInfo.PDSpathData.clear();
-	image.imgInfo.layerInfo.clear();
-	image.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
-	image.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
-	CMSettings cms(item->doc(), Prof, item->IRender);
-	cms.allowColorManagement(true);
-	cms.setUseEmbeddedProfile(UseEmbedded);
 	int resolution = 300;
 	if (item->asLatexFrame())
 		resolution = item->asLatexFrame()->realDpi();
 	else if (item->pixm.imgInfo.type == ImageType7)
 		resolution = 72;
 	//	int resolution = (item->pixm.imgInfo.type == ImageType7) ? 72 : 300;
-	if ( !image.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, resolution, &dummy) )
+	int w, h;
+	bool hasMask;
+	QSharedPointer<LoadedImage> loaded;
+	if (!Name.isEmpty() && m_imageResources.contains(Name))
 	{
-		PS_Error_ImageLoadFailure(fn);
-		return false;
+		// The data has already been written as reusable stream, only its geometry is needed
+		ImageResource resource = m_imageResources.value(Name);
+		w = resource.width;
+		h = resource.height;
+		hasMask = resource.hasMask;
+	}
+	else
+	{
+		loaded = loadImage(item, fn, Prof, UseEmbedded, resolution);
+		if (!loaded)
+			return false;
+		w = loaded->image.width();
+		h = loaded->image.height();
+		hasMask = (loaded->mask.size() > 0) && (item->pixm.imgInfo.type != ImageType7);
 	}
-	image.applyEffect(item->effectsInUse, colorsToUse, true);
-	int w = image.width();
-	int h = image.height();
 	PutStream(ToStr(x*scalex) + " " + ToStr(y*scaley) + " tr\n");
 	PutStream("0 " + ToStr(h*scaley) + " tr\n");
 	PutStream(ToStr(-item->imageRotation()) + " ro\n");
@@ -1285,23 +1321,7 @@ bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, doub
 	//	PutStream(ToStr(x*scalex) + " " + ToStr(y*scaley) + " tr\n");
 	PutStream(ToStr(qRound(scalex*w)) + " " + ToStr(qRound(scaley*h)) + " sc\n");
 	PutStream(((!DoSep) && (!GraySc)) ? "/DeviceCMYK setcolorspace\n" : "/DeviceGray setcolorspace\n");
-	QByteArray maskArray;
-	ScImage img2;
-	img2.imgInfo.clipPath = "";
-	img2.imgInfo.PDSpathData.clear();
-	img2.imgInfo.layerInfo.clear();
-	img2.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
-	img2.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
-	if (item->pixm.imgInfo.type != ImageType7)
-	{
-		bool alphaLoaded = img2.getAlpha(fn, item->pixm.imgInfo.actualPageNumber, maskArray, false, true, resolution);
-		if (!alphaLoaded)
-		{
-			PS_Error_MaskLoadFailure(fn);
-			return false;
-		}
-	}
-	if ((maskArray.size() > 0) && (item->pixm.imgInfo.type != ImageType7))
+	if (hasMask)
 	{
 		int plate = DoSep ? Plate : (GraySc ? -2 : -1);
 		// JG - Experimental code using Type3 image instead of patterns
@@ -1331,7 +1351,7 @@ bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, doub
 		PutStream("image\n");
 		if (Name.isEmpty())
 		{
-			if (!PutImageToStream(image, maskArray, plate))
+			if (!PutImageToStream(loaded->image, loaded->mask, plate))
 			{
 				PS_Error_ImageDataWriteFailure();
 				return false;
@@ -1365,7 +1385,7 @@ bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, doub
 			int plate = DoSep ? Plate : (GraySc ? -2 : -1);
 			PutStream("   /DataSource currentfile /ASCII85Decode filter /FlateDecode filter >>\n");
 			PutStream("image\n");
-			if (!PutImageToStream(image, plate))
+			if (!PutImageToStream(loaded->image, plate))
 			{
 				PS_Error_ImageDataWriteFailure();
 				return false;
@@ -1375,6 +1395,132 @@ bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, doub
 	return true;
 }
 
+QSharedPointer<PSLib::LoadedImage> PSLib::loadImage(PageItem *item, const QString& fn, const QString& Prof, bool UseEmbedded, int resolution)
+{
+	// Separations process a page once per plate, load its images only for the first one
+	QString cacheKey;
+	if (DoSep)
+	{
+		cacheKey = imageResourceKey(item);
+		if (!cacheKey.isEmpty())
+		{
+			cacheKey += "\n" + QString::number(resolution);
+			QSharedPointer<LoadedImage> cached = m_plateImages.value(cacheKey);
+			if (cached)
+				return cached;
+		}
+	}
+
+	bool dummy;
+	QSharedPointer<LoadedImage> loaded(new LoadedImage());
+	ScImage& image = loaded->image;
+	image.imgInfo.valid = false;
+	image.imgInfo.clipPath = "";
+	image.imgInfo.PDSpathData.clear();
+	image.imgInfo.layerInfo.clear();
+	image.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
+	image.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
+	CMSettings cms(item->doc(), Prof, item->IRender);
+	cms.allowColorManagement(true);
+	cms.setUseEmbeddedProfile(UseEmbedded);
+	if ( !image.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, resolution, &dummy) )
+	{
+		PS_Error_ImageLoadFailure(fn);
+		return QSharedPointer<LoadedImage>();
+	}
+	image.applyEffect(item->effectsInUse, colorsToUse, true);
+	ScImage img2;
+	img2.imgInfo.clipPath = "";
+	img2.imgInfo.PDSpathData.clear();
+	img2.imgInfo.layerInfo.clear();
+	img2.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
+	img2.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
+	if (item->pixm.imgInfo.type != ImageType7)
+	{
+		bool alphaLoaded = img2.getAlpha(fn, item->pixm.imgInfo.actualPageNumber, loaded->mask, false, true, resolution);
+		if (!alphaLoaded)
+		{
+			PS_Error_MaskLoadFailure(fn);
+			return QSharedPointer<LoadedImage>();
+		}
+	}
+
+	if (!cacheKey.isEmpty())
+	{
+		qint64 size = qint64(image.width()) * image.height() * 4 + loaded->mask.size();
+		if (m_plateImagesSize + size <= plateImageBudget)
+		{
+			m_plateImages.insert(cacheKey, loaded);
+			m_plateImagesSize += size;
+		}
+	}
+	return loaded;
+}
+
+QString PSLib::imageResourceKey(PageItem *item) const
+{
+	if (item->pixm.imgInfo.isRequest || item->asLatexFrame())
+		return QString();
+	QString key = item->Pfile + "\n" + QString::number(item->pixm.imgInfo.actualPageNumber);
+	key += "\n" + item->IProfile + "\n" + QString::number(item->UseEmbedded) + "\n" + QString::number(item->IRender);
+	for (int i = 0; i < item->effectsInUse.count(); ++i)
+		key += "\n" + QString::number(item->effectsInUse.at(i).effectCode) + " " + item->effectsInUse.at(i).effectParameters;
+	return key;
+}
+
+bool PSLib::PS_shareImages(ScribusDoc* doc, const std::vector<int>& pageNumbers)
+{
+	QSet<int> exportedPages;
+	for (size_t i = 0; i < pageNumbers.size(); ++i)
+		exportedPages.insert(pageNumbers[i] - 1);
+
+	QStringList keys;
+	QHash<QString, int> useCount;
+	QHash<QString, PageItem*> firstUse;
+	QList<PageItem*> items;
+	for (int i = 0; i < doc->DocItems.count(); ++i)
+	{
+		PageItem* item = doc->DocItems.at(i);
+		if (exportedPages.contains(item->OwnPage))
+			items.append(item);
+	}
+	while (!items.isEmpty())
+	{
+		PageItem* item = items.takeFirst();
+		if (item->isGroup())
+		{
+			items = item->getChildren() + items;
+			continue;
+		}
+		if (!item->asImageFrame() || !item->imageIsAvailable || item->Pfile.isEmpty() || !item->printEnabled())
+			continue;
+		if (item->pixm.imgInfo.type == ImageType7)
+			continue;
+		QString key = imageResourceKey(item);
+		if (key.isEmpty())
+			continue;
+		if (!firstUse.contains(key))
+		{
+			keys.append(key);
+			firstUse.insert(key, item);
+		}
+		useCount[key]++;
+	}
+
+	for (int i = 0; i < keys.count() && !abortExport; ++i)
+	{
+		const QString& key = keys.at(i);
+		if (useCount.value(key) < 2)
+			continue;
+		PageItem* item = firstUse.value(key);
+		QString name = QString("SharedImage%1").arg(m_sharedImages.count());
+		if (!PS_ImageData(item, item->Pfile, name, item->IProfile, item->UseEmbedded))
+			return false;
+		m_sharedImages.insert(key, name);
+	}
+	return true;
+}
+
 
 void PSLib::PS_plate(int nr, const QString& name)
 {
@@ -1688,6 +1834,11 @@ int PSLib::CreatePS(ScribusDoc* Doc, PrintOptions &options)
 		}
 		if (errorOccured) break;
 	}
+	m_sharedImages.clear();
+	m_imageResources.clear();
+	// Reusable streams need LanguageLevel 3, and separations write different data per plate
+	if (!errorOccured && !abortExport && !sep && farb && (Options.prnEngine == PostScript3))
+		errorOccured = !PS_shareImages(Doc, pageNs);
 	sepac = 0;
 	uint aa = 0;
 	uint a;	
@@ -1702,6 +1853,12 @@ int PSLib::CreatePS(ScribusDoc* Doc, PrintOptions &options)
 		}
 		a = pageNs[aa]-1;
 		ScPage* page = Doc->Pages->at(a);
+		if (static_cast<int>(a) != m_plateImagesPage)
+		{
+			m_plateImages.clear();
+			m_plateImagesSize = 0;
+			m_plateImagesPage = a;
+		}
 		if ((!psExport) && (Doc->m_Selection->count() != 0))
 		{
 			MarginStruct Ma;
@@ -1775,6 +1932,9 @@ int PSLib::CreatePS(ScribusDoc* Doc, PrintOptions &options)
 			aa++;
 	}
 	PS_close();
+	m_plateImages.clear();
+	m_plateImagesSize = 0;
+	m_plateImagesPage = -1;
 	if (progressDialog)
 		progressDialog->close();
 	if (errorOccured)
@@ -1854,8 +2014,13 @@ bool PSLib::ProcessItem(ScribusDoc* Doc, ScPage* page, PageItem* item, uint PNr,
 		{
 			bool imageOk = false;
 			PS_translate(0, -item->BBoxH*item->imageYScale());
+			QString sharedImage;
+			if (!m_sharedImages.isEmpty() && !sep && farb)
+				sharedImage = m_sharedImages.value(imageResourceKey(item));
 			if ((optimization == OptimizeSize) && (((!page->pageName().isEmpty()) && !sep && farb) || useTemplate))
 				imageOk = PS_image(item, item->imageXOffset(), -item->imageYOffset(), item->Pfile, item->imageXScale(), item->imageYScale(), item->IProfile, item->UseEmbedded, item->itemName());
+			else if (!sharedImage.isEmpty())
+				imageOk = PS_image(item, item->imageXOffset(), -item->imageYOffset(), item->Pfile, item->imageXScale(), item->imageYScale(), item->IProfile, item->UseEmbedded, sharedImage);
 			else
 				imageOk = PS_image(item, item->imageXOffset(), -item->imageYOffset(), item->Pfile, item->imageXScale(), item->imageYScale(), item->IProfile, item->UseEmbedded);
 			if (!imageOk) return false;
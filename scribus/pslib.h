@@ -29,11 +29,14 @@ for which a new license (GPL+exception) is in place.
 
 #include <QDataStream>
 #include <QFile>
+#include <QHash>
 #include <QList>
 #include <QPen>
+#include <QSharedPointer>
 #include <QString>
 
 #include "scribusapi.h"
+#include "scoperatorstream.h"
 #include "scribusstructs.h"
 #include "colormgmt/sccolormgmtengine.h"
 #include "tableborder.h"
@@ -150,6 +153,8 @@ class SCRIBUS_API PSLib : public QObject
 		void PutStream (const QString& c);
 		void PutStream (const QByteArray& array, bool hexEnc);
 		void PutStream (const char* in, int length, bool hexEnc);
+		/** \brief Write the content of an operator stream and clear it */
+		void PutStream (ScOperatorStream& stream);
 
 		bool PutImageToStream(ScImage& image, int plate);
 		bool PutImageToStream(ScImage& image, const QByteArray& mask, int plate);
@@ -160,6 +165,23 @@ class SCRIBUS_API PSLib : public QObject
 		void WriteASCII85Bytes(const QByteArray& array);
 		void WriteASCII85Bytes(const unsigned char* array, int length);
 
+		/** \brief Image data as PS_image() writes it, with its alpha mask */
+		struct LoadedImage;
+		/** \brief Geometry of an image written as reusable stream by PS_ImageData() */
+		struct ImageResource
+		{
+			int width { 0 };
+			int height { 0 };
+			bool hasMask { false };
+		};
+
+		/** \brief Load the image of an item, reusing the data loaded for a previous plate of the page */
+		QSharedPointer<LoadedImage> loadImage(PageItem *item, const QString& fn, const QString& Prof, bool UseEmbedded, int resolution);
+		/** \brief Identifies the image data of an image frame, empty if the data can not be shared */
+		QString imageResourceKey(PageItem *item) const;
+		/** \brief Write images placed several times on the exported pages once, as reusable streams */
+		bool PS_shareImages(ScribusDoc* doc, const std::vector<int>& pageNumbers);
+
 		void paintBorder(const TableBorder& border, const QPointF& start, const QPointF& end, const QPointF& startOffsetFactors, const QPointF& endOffsetFactors);
 
 		Optimization optimization;
@@ -192,6 +214,7 @@ class SCRIBUS_API PSLib : public QObject
 		bool isPDF;
 		QFile Spool;
 		QDataStream spoolStream;
+		ScOperatorStream m_operatorStream;
 		int  Plate;
 		bool DoSep;
 		bool useSpotColors;
@@ -206,6 +229,13 @@ class SCRIBUS_API PSLib : public QObject
 		bool abortExport;
 		PrintOptions Options;
 		ScPage* ActPage;
+		//! Resource key of shared images and the name of their reusable stream
+		QHash<QString, QString> m_sharedImages;
+		QHash<QString, ImageResource> m_imageResources;
+		//! Images loaded for the page being separated, written again for each plate
+		QHash<QString, QSharedPointer<LoadedImage> > m_plateImages;
+		int m_plateImagesPage;
+		qint64 m_plateImagesSize;
 
 	protected slots:
 		void cancelRequested();
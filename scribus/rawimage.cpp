@@ -4,6 +4,9 @@ to the COPYING file provided with the program. Following this notice may exist
 a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
+#include <climits>
+#include <cstring>
+
 #include "rawimage.h"
 
 RawImage::RawImage()
@@ -29,9 +32,17 @@ bool RawImage::create( int width, int height, int channels )
 	m_width = width;
 	m_height = height;
 	m_channels = channels;
-	int finalSize=width * height * channels;
+	// QByteArray cannot hold more than INT_MAX bytes, fail cleanly instead of
+	// overflowing on huge scans
+	qint64 finalSize = (qint64) width * height * channels;
+	if ((width < 0) || (height < 0) || (channels < 0) || (finalSize > INT_MAX))
+	{
+		m_width = m_height = m_channels = 0;
+		resize(0);
+		return false;
+	}
 	resize(finalSize);
-	return (size()==finalSize);
+	return (size() == finalSize);
 }
 
 uchar *RawImage::scanLine(int row)
@@ -113,3 +124,27 @@ QImage RawImage::convertToQImage(bool cmyk, bool raw)
 	}
 	return img;
 }
+
+RawImage RawImage::subsampled(int maxSize) const
+{
+	if ((m_width <= maxSize) && (m_height <= maxSize))
+		return *this;
+	double scale = qMax(m_width, m_height) / (double) maxSize;
+	int w = qMax(1, qRound(m_width / scale));
+	int h = qMax(1, qRound(m_height / scale));
+	RawImage img(w, h, m_channels);
+	const uchar* src = (const uchar*) constData();
+	for (int y = 0; y < h; ++y)
+	{
+		int sy = qMin(m_height - 1, (int) (y * scale));
+		const uchar* srcLine = src + (qint64) sy * m_width * m_channels;
+		uchar* dst = img.scanLine(y);
+		for (int x = 0; x < w; ++x)
+		{
+			int sx = qMin(m_width - 1, (int) (x * scale));
+			memcpy(dst, srcLine + sx * m_channels, m_channels);
+			dst += m_channels;
+		}
+	}
+	return img;
+}
@@ -26,6 +26,8 @@ public:
 	uchar *scanLine(int row);
 	void setAlpha(int x, int y, int alpha);
 	QImage convertToQImage(bool cmyk, bool raw = false);
+	/** \brief Nearest neighbour reduced copy whose largest side is at most maxSize pixels */
+	RawImage subsampled(int maxSize) const;
 private:
 	int m_width;
 	int m_height;
@@ -0,0 +1,191 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QColor>
+
+#include "scblurengine.h"
+#include "util_parallel.h"
+
+namespace
+{
+	// Images smaller than this number of pixels are blurred on the calling thread only
+	const int parallelPixelThreshold = 256 * 256;
+	// Number of bytes per column strip of the vertical pass, small enough
+	// for the accumulators of a strip to stay in the L1 cache
+	const int columnStripBytes = 1024;
+	const int rowChunk = 32;
+
+	struct BlurScratch
+	{
+		std::vector<uchar> plane;
+		std::vector<uchar> temp;
+		std::vector<quint32> accumulators;
+	};
+
+	BlurScratch& blurScratch()
+	{
+		static thread_local BlurScratch scratch;
+		return scratch;
+	}
+
+	template<int CH>
+	void boxBlurRows(const uchar* src, int srcStride, uchar* dst, int dstStride, int width, int rowBegin, int rowEnd, int radius)
+	{
+		const quint32 mul = (1u << 24) / (2 * radius + 1);
+		const int wm = width - 1;
+		for (int y = rowBegin; y < rowEnd; ++y)
+		{
+			const uchar* s = src + y * srcStride;
+			uchar* d = dst + y * dstStride;
+			quint32 acc[CH];
+			for (int c = 0; c < CH; ++c)
+				acc[c] = (radius + 1) * s[c];
+			for (int i = 1; i <= radius; ++i)
+			{
+				const uchar* p = s + qMin(i, wm) * CH;
+				for (int c = 0; c < CH; ++c)
+					acc[c] += p[c];
+			}
+			for (int x = 0; x < width; ++x)
+			{
+				const uchar* pAdd = s + qMin(x + radius + 1, wm) * CH;
+				const uchar* pSub = s + qMax(x - radius, 0) * CH;
+				for (int c = 0; c < CH; ++c)
+				{
+					d[c] = (acc[c] * mul + (1u << 23)) >> 24;
+					acc[c] += pAdd[c];
+					acc[c] -= pSub[c];
+				}
+				d += CH;
+			}
+		}
+	}
+
+	// Vertical box blur of the byte columns [colBegin, colEnd). Running sums of all
+	// columns of the strip are updated row by row, so memory is accessed sequentially.
+	void boxBlurColumns(const uchar* src, int srcStride, uchar* dst, int dstStride, int height, int colBegin, int colEnd, int radius, quint32* acc)
+	{
+		const quint32 mul = (1u << 24) / (2 * radius + 1);
+		const int hm = height - 1;
+		const int count = colEnd - colBegin;
+		const uchar* s = src + colBegin;
+		for (int c = 0; c < count; ++c)
+			acc[c] = (radius + 1) * s[c];
+		for (int i = 1; i <= radius; ++i)
+		{
+			const uchar* p = src + qMin(i, hm) * srcStride + colBegin;
+			for (int c = 0; c < count; ++c)
+				acc[c] += p[c];
+		}
+		for (int y = 0; y < height; ++y)
+		{
+			uchar* d = dst + y * dstStride + colBegin;
+			const uchar* pAdd = src + qMin(y + radius + 1, hm) * srcStride + colBegin;
+			const uchar* pSub = src + qMax(y - radius, 0) * srcStride + colBegin;
+			for (int c = 0; c < count; ++c)
+			{
+				d[c] = (acc[c] * mul + (1u << 23)) >> 24;
+				acc[c] += pAdd[c];
+				acc[c] -= pSub[c];
+			}
+		}
+	}
+
+	template<int CH>
+	void blurPlane(uchar* data, int width, int height, int stride, int radius)
+	{
+		int boxes[3];
+		ScBlurEngine::boxRadii(radius, boxes);
+
+		const int rowBytes = width * CH;
+		const bool parallel = (width * height) >= parallelPixelThreshold;
+		BlurScratch& scratch = blurScratch();
+		scratch.temp.resize(static_cast<size_t>(rowBytes) * height);
+		uchar* temp = scratch.temp.data();
+
+		for (int pass = 0; pass < 3; ++pass)
+		{
+			int r = boxes[pass];
+			if (r < 1)
+				continue;
+			auto rows = [=](int rowBegin, int rowEnd)
+			{
+				boxBlurRows<CH>(data, stride, temp, rowBytes, width, rowBegin, rowEnd, r);
+			};
+			auto columns = [=](int colBegin, int colEnd)
+			{
+				std::vector<quint32>& acc = blurScratch().accumulators;
+				acc.resize(colEnd - colBegin);
+				boxBlurColumns(temp, rowBytes, data, stride, height, colBegin, colEnd, r, acc.data());
+			};
+			if (parallel)
+			{
+				parallelFor(0, height, rowChunk, rows);
+				parallelFor(0, rowBytes, columnStripBytes, columns);
+			}
+			else
+			{
+				rows(0, height);
+				for (int col = 0; col < rowBytes; col += columnStripBytes)
+					columns(col, qMin(col + columnStripBytes, rowBytes));
+			}
+		}
+	}
+}
+
+void ScBlurEngine::boxRadii(int radius, int boxes[3])
+{
+	// A stack blur of radius r is a tent filter whose variance is r * (r + 2) / 6,
+	// find three box filters with odd widths matching that variance
+	const int n = 3;
+	double sigma2 = radius * (radius + 2) / 6.0;
+	double wIdeal = sqrt(12.0 * sigma2 / n + 1.0);
+	int wl = static_cast<int>(floor(wIdeal));
+	if (wl % 2 == 0)
+		wl--;
+	int wu = wl + 2;
+	double mIdeal = (12.0 * sigma2 - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0);
+	int m = qRound(mIdeal);
+	for (int i = 0; i < n; ++i)
+		boxes[i] = ((i < m) ? (wl - 1) : (wu - 1)) / 2;
+}
+
+void ScBlurEngine::blur(uchar* data, int width, int height, int stride, int radius)
+{
+	if ((radius < 1) || (width < 1) || (height < 1))
+		return;
+	// Channels are blurred independently, so their order in memory is irrelevant
+	blurPlane<4>(data, width, height, stride, radius);
+}
+
+void ScBlurEngine::blurAlpha(uchar* data, int width, int height, int stride, int radius)
+{
+	if ((radius < 1) || (width < 1) || (height < 1))
+		return;
+	BlurScratch& scratch = blurScratch();
+	scratch.plane.resize(static_cast<size_t>(width) * height);
+	uchar* alpha = scratch.plane.data();
+	for (int y = 0; y < height; ++y)
+	{
+		const QRgb* s = reinterpret_cast<const QRgb*>(data + y * stride);
+		uchar* a = alpha + y * width;
+		for (int x = 0; x < width; ++x)
+			a[x] = qAlpha(s[x]);
+	}
+	blurPlane<1>(alpha, width, height, width, radius);
+	for (int y = 0; y < height; ++y)
+	{
+		QRgb* d = reinterpret_cast<QRgb*>(data + y * stride);
+		const uchar* a = alpha + y * width;
+		for (int x = 0; x < width; ++x)
+			d[x] = qRgba(qRed(d[x]), qGreen(d[x]), qBlue(d[x]), a[x]);
+	}
+}
@@ -0,0 +1,38 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCBLURENGINE_H
+#define SCBLURENGINE_H
+
+#include <QtGlobal>
+
+#include "scribusapi.h"
+
+/**
+ * \brief Fast blur of 32 bit images such as cairo ARGB32 surfaces.
+ *
+ * The blur is computed as three successive separable box blurs, which closely
+ * approximates the gaussian like kernel of the stack blur previously used by
+ * ScPainter. Each pass costs a constant number of operations per pixel
+ * whatever the radius. Rows and column strips are processed in parallel, inner
+ * loops run over contiguous memory so that the compiler can vectorize them, and
+ * scratch buffers are kept per thread and reused between calls.
+ */
+class SCRIBUS_API ScBlurEngine
+{
+public:
+	/** \brief Blur all four channels of an image with premultiplied or straight alpha */
+	static void blur(uchar* data, int width, int height, int stride, int radius);
+
+	/** \brief Blur only the alpha channel of an ARGB32 image, color channels are left untouched */
+	static void blurAlpha(uchar* data, int width, int height, int stride, int radius);
+
+	/** \brief Compute the radii of the three box blurs approximating a stack blur of the given radius */
+	static void boxRadii(int radius, int boxes[3]);
+};
+
+#endif
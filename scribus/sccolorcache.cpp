@@ -0,0 +1,106 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QMutexLocker>
+
+#include "sccolorcache.h"
+
+bool ScColorCacheKey::operator==(const ScColorCacheKey& other) const
+{
+	return (conversion == other.conversion) &&
+	       (model == other.model) &&
+	       (flags == other.flags) &&
+	       (values[0] == other.values[0]) &&
+	       (values[1] == other.values[1]) &&
+	       (values[2] == other.values[2]) &&
+	       (values[3] == other.values[3]) &&
+	       (shade == other.shade);
+}
+
+uint qHash(const ScColorCacheKey& key, uint seed)
+{
+	uint h = qHash(key.conversion, seed);
+	h = h * 31 + qHash(key.model, seed);
+	h = h * 31 + qHash(key.flags, seed);
+	for (int i = 0; i < 4; ++i)
+		h = h * 31 + qHash(key.values[i], seed);
+	h = h * 31 + qHash(key.shade, seed);
+	return h;
+}
+
+bool ScColorCache::find(const ScColorCacheKey& key, QColor& color) const
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_cache.constFind(key);
+	if (it == m_cache.constEnd())
+	{
+		++m_misses;
+		return false;
+	}
+	++m_hits;
+	color = it.value();
+	return true;
+}
+
+void ScColorCache::insert(const ScColorCacheKey& key, const QColor& color)
+{
+	QMutexLocker locker(&m_mutex);
+	// Documents usually use a few hundred colors at most, so when the limit
+	// is reached we are most probably looking at a huge imported gradient
+	// mesh or image based colors: simply start over in that case
+	if (m_cache.count() >= m_maxEntries)
+		m_cache.clear();
+	m_cache.insert(key, color);
+}
+
+void ScColorCache::invalidate()
+{
+	QMutexLocker locker(&m_mutex);
+	m_cache.clear();
+	++m_generation;
+	++m_invalidations;
+}
+
+uint ScColorCache::generation() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_generation;
+}
+
+ScColorCache::Statistics ScColorCache::statistics() const
+{
+	QMutexLocker locker(&m_mutex);
+	Statistics stats;
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+	stats.invalidations = m_invalidations;
+	stats.entries = m_cache.count();
+	stats.generation = m_generation;
+	return stats;
+}
+
+void ScColorCache::resetStatistics()
+{
+	QMutexLocker locker(&m_mutex);
+	m_hits = 0;
+	m_misses = 0;
+	m_invalidations = 0;
+}
+
+void ScColorCache::setMaxEntries(int maxEntries)
+{
+	QMutexLocker locker(&m_mutex);
+	m_maxEntries = qMax(1, maxEntries);
+	if (m_cache.count() > m_maxEntries)
+		m_cache.clear();
+}
+
+int ScColorCache::maxEntries() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_maxEntries;
+}
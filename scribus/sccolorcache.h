@@ -0,0 +1,106 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCCOLORCACHE_H
+#define SCCOLORCACHE_H
+
+#include <QColor>
+#include <QHash>
+#include <QMutex>
+
+#include "scribusapi.h"
+
+/**
+ * \brief Key of a memoized color conversion.
+ *
+ * Holds the raw values of a ScColor together with the requested conversion,
+ * the shade level and the document state (cms, soft proofing, gamut check)
+ * that influence the result. Keys are filled in by ScColorEngine.
+ */
+struct SCRIBUS_API ScColorCacheKey
+{
+	enum Conversion
+	{
+		DisplayColor = 0,
+		DisplayShade,
+		ColorProof,
+		ShadeColor,
+		ShadeColorProof
+	};
+
+	enum Flags
+	{
+		Spot         = 1,
+		Registration = 2,
+		HasCMS       = 4,
+		SoftProofing = 8,
+		GamutCheck   = 16,
+		DocGamut     = 32
+	};
+
+	quint8 conversion { 0 };
+	quint8 model { 0 };
+	quint16 flags { 0 };
+	double values[4] { 0.0, 0.0, 0.0, 0.0 };
+	double shade { 100.0 };
+
+	bool operator==(const ScColorCacheKey& other) const;
+};
+
+SCRIBUS_API uint qHash(const ScColorCacheKey& key, uint seed = 0);
+
+/**
+ * \brief Document level cache of color conversions to display colors.
+ *
+ * Conversions performed by ScColorEngine run a color transform per color.
+ * As the same colors are requested for every fill, stroke and gradient stop
+ * on each repaint, results are memoized here. The cache is cleared whenever
+ * the document color transforms or color list change, which also bumps the
+ * cache generation.
+ */
+class SCRIBUS_API ScColorCache
+{
+public:
+	struct Statistics
+	{
+		quint64 hits { 0 };
+		quint64 misses { 0 };
+		quint64 invalidations { 0 };
+		int entries { 0 };
+		uint generation { 0 };
+	};
+
+	ScColorCache() = default;
+	ScColorCache(const ScColorCache&) = delete;
+	ScColorCache& operator=(const ScColorCache&) = delete;
+
+	/** \brief Look up a conversion result, return true on cache hit */
+	bool find(const ScColorCacheKey& key, QColor& color) const;
+	/** \brief Store a conversion result */
+	void insert(const ScColorCacheKey& key, const QColor& color);
+	/** \brief Drop all cached conversions and start a new generation */
+	void invalidate();
+
+	uint generation() const;
+	Statistics statistics() const;
+	void resetStatistics();
+
+	/** \brief Maximum number of entries kept before the cache is flushed */
+	void setMaxEntries(int maxEntries);
+	int maxEntries() const;
+
+protected:
+	mutable QMutex m_mutex;
+	QHash<ScColorCacheKey, QColor> m_cache;
+	mutable quint64 m_hits { 0 };
+	mutable quint64 m_misses { 0 };
+	quint64 m_invalidations { 0 };
+	uint m_generation { 0 };
+	int m_maxEntries { 65536 };
+};
+
+#endif
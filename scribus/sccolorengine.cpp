@@ -24,6 +24,7 @@ for which a new license (GPL+exception) is in place.
 #include <cmath>
 
 #include "sccolorengine.h"
+#include "sccolorcache.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "colormgmt/sccolormgmtengine.h"
@@ -606,6 +607,15 @@ void ScColorEngine::getShadeColorRGB(const ScColor& color, const ScribusDoc* doc
 
 QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* doc)
 {
+	ScColorCacheKey cacheKey;
+	bool useCache = isCacheable(color, doc);
+	if (useCache)
+	{
+		QColor cached;
+		makeCacheKey(cacheKey, ScColorCacheKey::DisplayColor, color, doc);
+		if (doc->colorCache().find(cacheKey, cached))
+			return cached;
+	}
 	QColor tmp;
 	if (color.getColorModel() == colorModelRGB)
 	{
@@ -683,11 +693,22 @@ QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* do
 			tmp.setRgbF(var_R, var_G, var_B);
 		}
 	}
+	if (useCache)
+		doc->colorCache().insert(cacheKey, tmp);
 	return tmp;
 }
 
 QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* doc, double level)
 {
+	ScColorCacheKey cacheKey;
+	bool useCache = isCacheable(color, doc);
+	if (useCache)
+	{
+		QColor cached;
+		makeCacheKey(cacheKey, ScColorCacheKey::DisplayShade, color, doc, level);
+		if (doc->colorCache().find(cacheKey, cached))
+			return cached;
+	}
 	QColor tmp;
 	if (color.getColorModel() == colorModelRGB)
 	{
@@ -719,6 +740,8 @@ QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* do
 		trans.apply(inC, outC, 1);
 		tmp = QColor(outC[0] / 257, outC[1] / 257, outC[2] / 257);
 	}
+	if (useCache)
+		doc->colorCache().insert(cacheKey, tmp);
 	return tmp;
 }
 
@@ -741,6 +764,15 @@ QColor ScColorEngine::getDisplayColorGC(const ScColor& color, const ScribusDoc*
 
 QColor ScColorEngine::getColorProof(const ScColor& color, const ScribusDoc* doc, bool gamutCheck)
 {
+	ScColorCacheKey cacheKey;
+	bool useCache = isCacheable(color, doc);
+	if (useCache)
+	{
+		QColor cached;
+		makeCacheKey(cacheKey, ScColorCacheKey::ColorProof, color, doc, 100.0, gamutCheck);
+		if (doc->colorCache().find(cacheKey, cached))
+			return cached;
+	}
 	QColor tmp;
 	bool gamutChkEnabled = doc ? doc->Gamut : false;
 	bool spot = color.isSpotColor();
@@ -764,21 +796,44 @@ QColor ScColorEngine::getColorProof(const ScColor& color, const ScribusDoc* doc,
 		cmyk.k = qRound(color.m_values[3] * 255.0);
 		tmp = getColorProof(cmyk, doc, spot, gamutCheck & gamutChkEnabled);
 	}
+	if (useCache)
+		doc->colorCache().insert(cacheKey, tmp);
 	return tmp;
 }
 
 QColor ScColorEngine::getShadeColor(const ScColor& color, const ScribusDoc* doc, double level)
 {
+	ScColorCacheKey cacheKey;
+	bool useCache = isCacheable(color, doc);
+	if (useCache)
+	{
+		QColor cached;
+		makeCacheKey(cacheKey, ScColorCacheKey::ShadeColor, color, doc, level);
+		if (doc->colorCache().find(cacheKey, cached))
+			return cached;
+	}
 	RGBColor rgb;
 	rgb.r = qRound(color.m_values[0] * 255.0);
 	rgb.g = qRound(color.m_values[1] * 255.0);
 	rgb.b = qRound(color.m_values[2] * 255.0);
 	getShadeColorRGB(color, doc, rgb, level);
-	return QColor(rgb.r, rgb.g, rgb.b);
+	QColor result(rgb.r, rgb.g, rgb.b);
+	if (useCache)
+		doc->colorCache().insert(cacheKey, result);
+	return result;
 }
 
 QColor ScColorEngine::getShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level)
 {
+	ScColorCacheKey cacheKey;
+	bool useCache = isCacheable(color, doc);
+	if (useCache)
+	{
+		QColor cached;
+		makeCacheKey(cacheKey, ScColorCacheKey::ShadeColorProof, color, doc, level);
+		if (doc->colorCache().find(cacheKey, cached))
+			return cached;
+	}
 	QColor tmp;
 	bool doGC = doc ? doc->Gamut : false;
 	bool cmsUse = doc ? doc->HasCMS : false;
@@ -837,6 +892,8 @@ QColor ScColorEngine::getShadeColorProof(const ScColor& color, const ScribusDoc*
 		}
 	}
 	
+	if (useCache)
+		doc->colorCache().insert(cacheKey, tmp);
 	return tmp;
 }
 
@@ -1159,3 +1216,47 @@ void ScColorEngine::applyGCR(ScColor& color, const ScribusDoc* doc)
 		color.m_values[3] = qMin((cmyk.k + k) / 255.0, 1.0);
 	}
 }
+
+bool ScColorEngine::isCacheable(const ScColor& color, const ScribusDoc* doc)
+{
+	// Without color management only Lab colors need more than a few multiplications,
+	// looking those up would cost more than computing them
+	if (!doc)
+		return false;
+	return doc->HasCMS || (color.getColorModel() == colorModelLab);
+}
+
+void ScColorEngine::makeCacheKey(ScColorCacheKey& key, int conversion, const ScColor& color, const ScribusDoc* doc, double level, bool gamutCheck)
+{
+	key.conversion = conversion;
+	key.model = color.m_Model;
+	key.flags = 0;
+	if (color.m_Spot)
+		key.flags |= ScColorCacheKey::Spot;
+	if (color.m_Regist)
+		key.flags |= ScColorCacheKey::Registration;
+	if (gamutCheck)
+		key.flags |= ScColorCacheKey::GamutCheck;
+	if (doc)
+	{
+		if (doc->HasCMS)
+			key.flags |= ScColorCacheKey::HasCMS;
+		if (doc->SoftProofing)
+			key.flags |= ScColorCacheKey::SoftProofing;
+		if (doc->Gamut)
+			key.flags |= ScColorCacheKey::DocGamut;
+	}
+	if (color.m_Model == colorModelLab)
+	{
+		key.values[0] = color.m_L_val;
+		key.values[1] = color.m_a_val;
+		key.values[2] = color.m_b_val;
+		key.values[3] = 0.0;
+	}
+	else
+	{
+		for (int i = 0; i < 4; ++i)
+			key.values[i] = color.m_values[i];
+	}
+	key.shade = level;
+}
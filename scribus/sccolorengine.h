@@ -28,6 +28,7 @@ for which a new license (GPL+exception) is in place.
 #include "sccolor.h"
 #include "sccolorstructs.h"
 class ScribusDoc;
+struct ScColorCacheKey;
 
 class SCRIBUS_API ScColorEngine
 {
@@ -122,6 +123,12 @@ public:
 
 	/** \brief Applys Gray-Component-Removal to an ScColor */
 	static void applyGCR(ScColor& color, const ScribusDoc* doc);
+
+protected:
+	/** \brief Returns true if conversions of color are worth memoizing in the document color cache */
+	static bool isCacheable(const ScColor& color, const ScribusDoc* doc);
+	/** \brief Build the key used to memoize a color conversion in the document color cache */
+	static void makeCacheKey(ScColorCacheKey& key, int conversion, const ScColor& color, const ScribusDoc* doc, double level = 100.0, bool gamutCheck = false);
 };
 
 #endif
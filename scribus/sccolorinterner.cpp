@@ -0,0 +1,139 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "sccolorinterner.h"
+
+ScColorInternKey::ScColorInternKey(const ScColor& color, const QString& keyName)
+	: name(keyName)
+{
+	model = static_cast<quint8>(color.getColorModel());
+	if (color.isSpotColor())
+		flags |= Spot;
+	if (color.isRegistrationColor())
+		flags |= Registration;
+	if (color.getColorModel() == colorModelRGB)
+		color.getRGB(&values[0], &values[1], &values[2]);
+	else if (color.getColorModel() == colorModelCMYK)
+		color.getCMYK(&values[0], &values[1], &values[2], &values[3]);
+	else
+		color.getLab(&values[0], &values[1], &values[2]);
+}
+
+bool ScColorInternKey::operator==(const ScColorInternKey& other) const
+{
+	return (model == other.model) &&
+	       (flags == other.flags) &&
+	       (values[0] == other.values[0]) &&
+	       (values[1] == other.values[1]) &&
+	       (values[2] == other.values[2]) &&
+	       (values[3] == other.values[3]) &&
+	       (name == other.name);
+}
+
+uint qHash(const ScColorInternKey& key, uint seed)
+{
+	uint h = qHash(key.model, seed);
+	h = h * 31 + qHash(key.flags, seed);
+	for (int i = 0; i < 4; ++i)
+		h = h * 31 + qHash(key.values[i], seed);
+	h = h * 31 + qHash(key.name, seed);
+	return h;
+}
+
+ScColorInterner::ScColorInterner(ColorList* colors, QStringList* importedColors)
+	: m_colors(colors),
+	  m_importedColors(importedColors)
+{
+}
+
+void ScColorInterner::setColorList(ColorList* colors, QStringList* importedColors)
+{
+	m_colors = colors;
+	m_importedColors = importedColors;
+	clear();
+}
+
+void ScColorInterner::clear()
+{
+	m_resolved.clear();
+	m_byValue.clear();
+	m_recorded.clear();
+	m_knownCount = -1;
+}
+
+QString ScColorInterner::intern(const ScColor& color, const QString& namePrefix)
+{
+	ScColorInternKey key(color, namePrefix);
+	auto it = m_resolved.constFind(key);
+	if ((it != m_resolved.constEnd()) && m_colors->contains(it.value()))
+		return it.value();
+	// The color name is only built on a miss, it is the costly part of the lookup
+	return lookup(key, namePrefix + color.name(), color, true);
+}
+
+QString ScColorInterner::internNamed(const QString& name, const ScColor& color, bool recordImported)
+{
+	ScColorInternKey key(color, name);
+	key.flags |= ScColorInternKey::Named;
+	auto it = m_resolved.constFind(key);
+	if ((it != m_resolved.constEnd()) && m_colors->contains(it.value()))
+		return it.value();
+	return lookup(key, name, color, recordImported);
+}
+
+QString ScColorInterner::lookup(const ScColorInternKey& key, const QString& name, const ScColor& color, bool recordImported)
+{
+	QString result = tryAddColor(name, color);
+	m_resolved.insert(key, result);
+	if (recordImported && m_importedColors && (result == name) && !m_recorded.contains(name))
+	{
+		m_recorded.insert(name);
+		m_importedColors->append(name);
+	}
+	return result;
+}
+
+QString ScColorInterner::tryAddColor(const QString& name, const ScColor& color)
+{
+	// Someone else modified the list since we indexed it
+	if (m_colors->count() != m_knownCount)
+		rebuildIndex();
+
+	if (m_colors->contains(name))
+		return name;
+
+	// ScColor::operator== never matches Lab colors, neither do we
+	ScColorInternKey valueKey(color, QString());
+	if (color.getColorModel() != colorModelLab)
+	{
+		auto it = m_byValue.constFind(valueKey);
+		if ((it != m_byValue.constEnd()) && m_colors->contains(it.value()))
+			return it.value();
+	}
+
+	m_colors->insert(name, color);
+	m_knownCount = m_colors->count();
+	if ((color.getColorModel() != colorModelLab) && !m_byValue.contains(valueKey))
+		m_byValue.insert(valueKey, name);
+	return name;
+}
+
+void ScColorInterner::rebuildIndex()
+{
+	// ColorList::tryAddColor() returns the first equal color in name order,
+	// so only the first name seen for a value is kept
+	m_byValue.clear();
+	for (ColorList::const_iterator it = m_colors->constBegin(); it != m_colors->constEnd(); ++it)
+	{
+		if (it.value().getColorModel() == colorModelLab)
+			continue;
+		ScColorInternKey valueKey(it.value(), QString());
+		if (!m_byValue.contains(valueKey))
+			m_byValue.insert(valueKey, it.key());
+	}
+	m_knownCount = m_colors->count();
+}
@@ -0,0 +1,89 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCCOLORINTERNER_H
+#define SCCOLORINTERNER_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "scribusapi.h"
+#include "sccolor.h"
+
+/**
+ * \brief Key of an interned color: color model, flags, raw values and
+ * the name or name prefix the color was requested with.
+ */
+struct SCRIBUS_API ScColorInternKey
+{
+	enum Flags
+	{
+		Spot         = 1,
+		Registration = 2,
+		Named        = 4   //!< name is a full color name, not a prefix
+	};
+
+	quint8 model { 0 };
+	quint8 flags { 0 };
+	double values[4] { 0.0, 0.0, 0.0, 0.0 };
+	QString name;
+
+	ScColorInternKey() = default;
+	ScColorInternKey(const ScColor& color, const QString& name);
+
+	bool operator==(const ScColorInternKey& other) const;
+};
+
+SCRIBUS_API uint qHash(const ScColorInternKey& key, uint seed = 0);
+
+/**
+ * \brief Import time color table.
+ *
+ * Import filters resolve the color of every fill and stroke through
+ * ColorList::tryAddColor(), which builds a name and searches the whole
+ * color list for an equal color. Vector files such as maps repeat the same
+ * few colors millions of times. The interner gives the same results as
+ * tryAddColor(), but remembers them and indexes the colors of the list by
+ * value so that repeated and new colors are resolved in constant time.
+ *
+ * Colors whose name equals the requested name are appended once to the
+ * optional list of imported colors, as importers used to do by hand.
+ */
+class SCRIBUS_API ScColorInterner
+{
+public:
+	ScColorInterner(ColorList* colors = nullptr, QStringList* importedColors = nullptr);
+
+	/** \brief Set the color list colors are added to, clears the table */
+	void setColorList(ColorList* colors, QStringList* importedColors = nullptr);
+
+	/** \brief Same as tryAddColor(namePrefix + color.name(), color) */
+	QString intern(const ScColor& color, const QString& namePrefix);
+	/** \brief Same as tryAddColor(name, color) */
+	QString internNamed(const QString& name, const ScColor& color, bool recordImported = true);
+
+	/** \brief Forget all interned colors */
+	void clear();
+
+	int count() const { return m_resolved.count(); }
+
+protected:
+	QString lookup(const ScColorInternKey& key, const QString& name, const ScColor& color, bool recordImported);
+	QString tryAddColor(const QString& name, const ScColor& color);
+	void rebuildIndex();
+
+	ColorList* m_colors { nullptr };
+	QStringList* m_importedColors { nullptr };
+	int m_knownCount { -1 };
+	QHash<ScColorInternKey, QString> m_resolved;
+	QHash<ScColorInternKey, QString> m_byValue;
+	QSet<QString> m_recorded;
+};
+
+#endif
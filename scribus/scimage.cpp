@@ -12,7 +12,9 @@ for which a new license (GPL+exception) is in place.
 #include <csetjmp>
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
 #include <QImageReader>
 #include <QMessageBox>
 #include <QList>
@@ -24,6 +26,7 @@ for which a new license (GPL+exception) is in place.
 #include "rawimage.h"
 #include "scclocale.h"
 #include "sccolorengine.h"
+#include "scimagecachemanager.h"
 #include "scimagecacheproxy.h"
 #include "scstreamfilter.h"
 #include "scimage.h"
@@ -2209,7 +2212,15 @@ bool ScImage::loadPicture(ScImageCacheProxy & cache, bool & fromCache, int page,
 	else
 		fromCache = false;
 
-	return loadPicture(cache.getFilename(), page, cmSettings, requestType, gsRes, realCMYK, showMsg);
+	if (!cache.enabled())
+		return loadPicture(cache.getFilename(), page, cmSettings, requestType, gsRes, realCMYK, showMsg);
+
+	QElapsedTimer timer;
+	timer.start();
+	bool loaded = loadPicture(cache.getFilename(), page, cmSettings, requestType, gsRes, realCMYK, showMsg);
+	if (loaded)
+		ScImageCacheManager::instance().recordMiss(QFileInfo(cache.getFilename()).size(), timer.elapsed());
+	return loaded;
 }
 
 bool ScImage::saveCache(ScImageCacheProxy & cache)
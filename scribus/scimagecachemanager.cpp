@@ -22,7 +22,9 @@ for which a new license (GPL+exception) is in place.
 #include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
+#include <QMutexLocker>
 #include <QTemporaryFile>
+#include <QTextStream>
 
 #include "sclockedfile.h"
 #include "scimagecachedir.h"
@@ -295,10 +297,32 @@ on network drive
 -------------------------------------------------------------------------------
 \endverbatim
 
+
+\section ic_statistics Statistics and Adaptive Sizing
+
+The cache manager counts hits, misses, stores and evictions of the running
+session, together with the size of the original files that did not have to
+be read and an estimate of the loading time saved. The estimate is based on
+the loading time per byte of original image data measured for cache misses.
+The counters can be queried with ScImageCacheManager::statistics(), which is
+also exposed to the scripter.
+
+When Scribus exits, a summary of the session is appended to the session log
+in the application data directory. At startup, the log provides the load time
+estimate until the first miss has been measured, and the working sets (the
+total size of the distinct cache images used in a session) of the recent
+sessions. If adaptive sizing is enabled, the cache is limited to a multiple
+of the largest recent working set, but never more than the user defined limit.
+
 ******************************************************************************/
 
 namespace {
 	const int LOCKFILE_MAX_AGE_SECONDS = 3600;
+	const int SESSION_LOG_MAX_LINES = 100;
+	const int ADAPTIVE_SESSIONS = 16;      // sessions considered for adaptive sizing
+	const int ADAPTIVE_MIN_SESSIONS = 3;   // sessions needed before adapting the limit
+	const int ADAPTIVE_HEADROOM = 2;       // limit as multiple of the largest working set
+	const qint64 ADAPTIVE_MIN_SIZE = Q_INT64_C(64) * 1048576;
 }
 
 
@@ -340,6 +364,18 @@ ScImageCacheFile *ScImageCacheManager::MetaAgeList::getOldest()
 
 
 
+ScImageCacheManager::Statistics::Statistics()
+	: hits(0), misses(0), stores(0), evictions(0), bytesSaved(0),
+	  loadTimeSaved(0), workingSetSize(0), maxCacheSize(0)
+{
+}
+
+double ScImageCacheManager::Statistics::hitRate() const
+{
+	return (hits + misses) > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+}
+
+
 ScImageCacheManager & ScImageCacheManager::instance()
 {
 	static ScImageCacheManager instance;
@@ -349,7 +385,9 @@ ScImageCacheManager & ScImageCacheManager::instance()
 ScImageCacheManager::ScImageCacheManager()
 	: m_isEnabled(false), m_haveMasterLock(false), m_inCleanup(false), m_writeLockCount(0),
 	  m_compressionLevel(-1), m_maxEntries(0), m_maxSizeMiB(0), m_maxTotalSize(0),
-	  m_totalCacheSize(0), m_writeLockFile(nullptr), m_root(nullptr)
+	  m_totalCacheSize(0), m_adaptiveSizing(false), m_effectiveMaxSize(0),
+	  m_missBytes(0), m_missTime(0), m_loadRate(0.0),
+	  m_writeLockFile(nullptr), m_root(nullptr)
 {
 }
 
@@ -732,15 +770,20 @@ void ScImageCacheManager::cleanupCache()
 
 	scDebug() << "removing old cache entries";
 
-	scDebug() << "total size:" << m_totalCacheSize << "/ max:" << m_maxTotalSize;
+	updateSizeLimit();
+
+	scDebug() << "total size:" << m_totalCacheSize << "/ max:" << m_effectiveMaxSize;
 	scDebug() << "meta count:" << m_metaAge.count() << "/ max:" << m_maxEntries;
 
-	while (m_totalCacheSize > m_maxTotalSize || m_metaAge.count() > m_maxEntries)
+	while (m_totalCacheSize > m_effectiveMaxSize || m_metaAge.count() > m_maxEntries)
 	{
 		ScImageCacheFile *p = getOldestCacheEntry();
 		if (!ScImageCacheProxy::removeCacheEntry(p->path(true), true))
 			break;
-		scDebug() << "total size:" << m_totalCacheSize << "/ max:" << m_maxTotalSize;
+		m_statsMutex.lock();
+		m_stats.evictions++;
+		m_statsMutex.unlock();
+		scDebug() << "total size:" << m_totalCacheSize << "/ max:" << m_effectiveMaxSize;
 		scDebug() << "meta count:" << m_metaAge.count() << "/ max:" << m_maxEntries;
 	}
 
@@ -755,6 +798,7 @@ void ScImageCacheManager::initialize()
 
 	if (enabled())
 	{
+		readSessionLog();
 		cleanupLockDir();
 
 		scDebug() << "attempting to acquire master lock";
@@ -830,6 +874,7 @@ bool ScImageCacheManager::setMaxCacheSizeMiB(int maxCacheSizeMiB)
 		return false;
 	m_maxSizeMiB = maxCacheSizeMiB;
 	m_maxTotalSize = Q_INT64_C(1048576)*static_cast<qint64>(maxCacheSizeMiB);
+	updateSizeLimit();
 	return true;
 }
 
@@ -856,6 +901,144 @@ int ScImageCacheManager::compressionLevel() const
 	return m_compressionLevel;
 }
 
+void ScImageCacheManager::setAdaptiveSizing(bool adaptive)
+{
+	m_adaptiveSizing = adaptive;
+	updateSizeLimit();
+}
+
+void ScImageCacheManager::updateSizeLimit()
+{
+	m_effectiveMaxSize = m_maxTotalSize;
+	if (!m_adaptiveSizing || m_pastWorkingSets.count() < ADAPTIVE_MIN_SESSIONS)
+		return;
+
+	m_statsMutex.lock();
+	qint64 workingSet = m_stats.workingSetSize;
+	m_statsMutex.unlock();
+	foreach (qint64 size, m_pastWorkingSets)
+		workingSet = qMax(workingSet, size);
+
+	qint64 target = qMax(ADAPTIVE_MIN_SIZE, ADAPTIVE_HEADROOM * workingSet);
+	m_effectiveMaxSize = qMin(m_maxTotalSize, target);
+	scDebug() << "adaptive size limit:" << m_effectiveMaxSize << "working set:" << workingSet;
+}
+
+ScImageCacheManager::Statistics ScImageCacheManager::statistics() const
+{
+	QMutexLocker locker(&m_statsMutex);
+	Statistics stats(m_stats);
+	stats.maxCacheSize = m_effectiveMaxSize;
+	return stats;
+}
+
+void ScImageCacheManager::resetStatistics()
+{
+	QMutexLocker locker(&m_statsMutex);
+	m_stats = Statistics();
+	m_workingSet.clear();
+}
+
+void ScImageCacheManager::recordHit(const QString & imageFile, qint64 imageSize, qint64 sourceSize, qint64 loadTime)
+{
+	// may be called from thumbnail worker threads
+	QMutexLocker locker(&m_statsMutex);
+	double rate = (m_missBytes > 0) ? static_cast<double>(m_missTime) / static_cast<double>(m_missBytes) : m_loadRate;
+	m_stats.hits++;
+	m_stats.bytesSaved += sourceSize;
+	m_stats.loadTimeSaved += qMax(Q_INT64_C(0), static_cast<qint64>(rate * sourceSize) - loadTime);
+	if (!m_workingSet.contains(imageFile))
+	{
+		m_workingSet.insert(imageFile, imageSize);
+		m_stats.workingSetSize += imageSize;
+	}
+}
+
+void ScImageCacheManager::recordMiss(qint64 sourceSize, qint64 loadTime)
+{
+	QMutexLocker locker(&m_statsMutex);
+	m_stats.misses++;
+	m_missBytes += sourceSize;
+	m_missTime += loadTime;
+}
+
+void ScImageCacheManager::recordStore(const QString & imageFile, qint64 imageSize)
+{
+	QMutexLocker locker(&m_statsMutex);
+	m_stats.stores++;
+	m_stats.workingSetSize += imageSize - m_workingSet.value(imageFile, 0);
+	m_workingSet.insert(imageFile, imageSize);
+}
+
+QString ScImageCacheManager::sessionLogFile()
+{
+	return ScPaths::applicationDataDir() + "cache/imagecache.log";
+}
+
+void ScImageCacheManager::readSessionLog()
+{
+	QFile file(sessionLogFile());
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+
+	// Each line holds one session as a timestamp followed by key=value pairs
+	m_pastWorkingSets.clear();
+	QTextStream ts(&file);
+	while (!ts.atEnd())
+	{
+		QStringList fields = ts.readLine().split(' ', QString::SkipEmptyParts);
+		foreach (const QString& field, fields)
+		{
+			QString key = field.section('=', 0, 0);
+			QString value = field.section('=', 1);
+			if (key == "workingSet")
+				m_pastWorkingSets.append(value.toLongLong());
+			else if (key == "loadRate" && value.toDouble() > 0.0)
+				m_loadRate = value.toDouble();
+		}
+	}
+	while (m_pastWorkingSets.count() > ADAPTIVE_SESSIONS)
+		m_pastWorkingSets.removeFirst();
+}
+
+void ScImageCacheManager::writeSessionLog()
+{
+	Statistics stats = statistics();
+	if (!m_isEnabled || (stats.hits + stats.misses + stats.stores == 0))
+		return;
+
+	m_statsMutex.lock();
+	double rate = (m_missBytes > 0) ? static_cast<double>(m_missTime) / static_cast<double>(m_missBytes) : m_loadRate;
+	m_statsMutex.unlock();
+
+	QStringList lines;
+	QFile file(sessionLogFile());
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		QTextStream ts(&file);
+		while (!ts.atEnd())
+			lines.append(ts.readLine());
+		file.close();
+	}
+
+	lines.append(QString("%1 hits=%2 misses=%3 stores=%4 evictions=%5 bytesSaved=%6 timeSaved=%7 workingSet=%8 maxSize=%9 loadRate=%10")
+		.arg(QDateTime::currentDateTime().toString(Qt::ISODate))
+		.arg(stats.hits).arg(stats.misses).arg(stats.stores).arg(stats.evictions)
+		.arg(stats.bytesSaved).arg(stats.loadTimeSaved).arg(stats.workingSetSize)
+		.arg(stats.maxCacheSize).arg(rate, 0, 'g', 6));
+	while (lines.count() > SESSION_LOG_MAX_LINES)
+		lines.removeFirst();
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		scDebug() << "could not write session log" << file.fileName();
+		return;
+	}
+	QTextStream ts(&file);
+	foreach (const QString& line, lines)
+		ts << line << "\n";
+}
+
 QString ScImageCacheManager::lockDir()
 {
 	return ScPaths::imageCacheDir() + "locks/";
@@ -21,7 +21,9 @@ for which a new license (GPL+exception) is in place.
 #ifndef SCIMAGECACHEMANAGER_H
 #define SCIMAGECACHEMANAGER_H
 
+#include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QString>
 #include <QDebug>
 
@@ -43,6 +45,24 @@ class SCRIBUS_API ScImageCacheManager : public QObject
 public:
 	typedef ScImageCacheDir::AccessCounter AccessCounter;
 
+	/**
+	* @brief Cache usage counters of the running session
+	*/
+	struct Statistics
+	{
+		Statistics();
+		double hitRate() const;
+
+		qint64 hits;            //!< Images loaded from the cache
+		qint64 misses;          //!< Images loaded from their original file while the cache was enabled
+		qint64 stores;          //!< Images written to the cache
+		qint64 evictions;       //!< Cache entries removed to respect the cache limits
+		qint64 bytesSaved;      //!< Size of original image files that did not have to be read
+		qint64 loadTimeSaved;   //!< Estimated image loading time saved, in milliseconds
+		qint64 workingSetSize;  //!< Size of the distinct cache images used in this session
+		qint64 maxCacheSize;    //!< Cache size limit currently in effect
+	};
+
 	/**
 	* @brief Get image cache manager instance
 	* @return Reference to the singleton instance
@@ -90,6 +110,56 @@ public:
 	* @return Current compression level
 	*/
 	int compressionLevel() const;
+	/**
+	* @brief Enable/disable adaptive cache sizing
+	*
+	* With adaptive sizing, the cache size limit set with setMaxCacheSizeMiB()
+	* becomes an upper bound. The limit in effect is derived from the cache
+	* working sets observed in the recent sessions, so that disk space is not
+	* held for images that are never reused.
+	* @param adaptive \c true if the cache size should be adapted
+	*/
+	void setAdaptiveSizing(bool adaptive);
+	/**
+	* @brief Check if adaptive cache sizing is enabled
+	*/
+	bool adaptiveSizing() const { return m_adaptiveSizing; }
+
+	/**
+	* @brief Get the cache usage counters of the running session
+	*/
+	Statistics statistics() const;
+	/**
+	* @brief Reset the cache usage counters of the running session
+	*/
+	void resetStatistics();
+	/**
+	* @brief Record a successful cache read
+	* @param imageFile Path of the cache image relative to the image cache root directory
+	* @param imageSize Size of the cache image file
+	* @param sourceSize Size of the original image file
+	* @param loadTime Time spent reading the cache, in milliseconds
+	*/
+	void recordHit(const QString & imageFile, qint64 imageSize, qint64 sourceSize, qint64 loadTime);
+	/**
+	* @brief Record an image loaded from its original file while the cache was enabled
+	* @param sourceSize Size of the original image file
+	* @param loadTime Time spent loading the original image, in milliseconds
+	*/
+	void recordMiss(qint64 sourceSize, qint64 loadTime);
+	/**
+	* @brief Record an image written to the cache
+	* @param imageFile Path of the cache image relative to the image cache root directory
+	* @param imageSize Size of the cache image file
+	*/
+	void recordStore(const QString & imageFile, qint64 imageSize);
+	/**
+	* @brief Append the statistics of the running session to the session log
+	*
+	* The session log is also read back by initialize() to seed the load time
+	* estimates and the adaptive cache sizing.
+	*/
+	void writeSessionLog();
 
 	/**
 	* @brief Initialize the cache manager
@@ -178,6 +248,10 @@ private:
 	void cleanupCache();
 	ScImageCacheFile *getOldestCacheEntry();
 
+	static QString sessionLogFile();
+	void readSessionLog();
+	void updateSizeLimit();
+
 	bool acquireMasterLock();
 	bool releaseMasterLock();
 
@@ -190,9 +264,19 @@ private:
 	int m_maxSizeMiB;
 	qint64 m_maxTotalSize;
 	qint64 m_totalCacheSize;
+	bool m_adaptiveSizing;
+	qint64 m_effectiveMaxSize;
 
 	MetaAgeList m_metaAge;
 
+	mutable QMutex m_statsMutex;
+	Statistics m_stats;
+	QHash<QString, qint64> m_workingSet;
+	qint64 m_missBytes;
+	qint64 m_missTime;
+	double m_loadRate;                  // ms per byte of original image file
+	QList<qint64> m_pastWorkingSets;    // most recent session last
+
 	QTemporaryFile *m_writeLockFile;
 	ScImageCacheDir *m_root;
 };
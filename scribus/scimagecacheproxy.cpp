@@ -24,6 +24,7 @@ for which a new license (GPL+exception) is in place.
 #include <QByteArray>
 #include <QDateTime>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 
@@ -354,6 +355,8 @@ bool ScImageCacheProxy::load(QImage & image)
 		return false;
 
 	QString base;
+	QElapsedTimer timer;
+	timer.start();
 
 	if (!loadMetadata(&m_metadata, &m_modifier, &m_imginfo, &base))
 	{
@@ -370,6 +373,7 @@ bool ScImageCacheProxy::load(QImage & image)
 	}
 
 	scDebug() << "successfully loaded" << m_filename << "from" << fn;
+	ScImageCacheManager::instance().recordHit(imageFile(base), QFileInfo(fn).size(), m_metadata["size"].toLongLong(), timer.elapsed());
 	return true;
 }
 
@@ -588,6 +592,7 @@ bool ScImageCacheProxy::save(const QImage & image)
 
 	action.commit();
 
+	ScImageCacheManager::instance().recordStore(imgName, QFileInfo(img.name()).size());
 	return true;
 }
 
@@ -0,0 +1,164 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <cmath>
+
+#include <QtNumeric>
+
+#include "scoperatorstream.h"
+
+namespace
+{
+	const double powersOfTen[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+		1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17
+	};
+	// 2^53, all integers up to this value are exactly representable
+	const double maxExactInteger = 9007199254740992.0;
+
+	// Write value / 10^decimals, without trailing zeros in the fraction
+	int writeDigits(char* buffer, quint64 value, int decimals)
+	{
+		char digits[24];
+		int count = 0;
+		do
+		{
+			digits[count++] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+		while (value != 0);
+		while (count <= decimals)
+			digits[count++] = '0';
+		int firstDecimal = 0;
+		while ((firstDecimal < decimals) && (digits[firstDecimal] == '0'))
+			++firstDecimal;
+		int length = 0;
+		for (int i = count - 1; i >= decimals; --i)
+			buffer[length++] = digits[i];
+		if (firstDecimal < decimals)
+		{
+			buffer[length++] = '.';
+			for (int i = decimals - 1; i >= firstDecimal; --i)
+				buffer[length++] = digits[i];
+		}
+		return length;
+	}
+}
+
+ScOperatorStream::ScOperatorStream(int precision)
+	: m_precision(DefaultPrecision)
+{
+	setPrecision(precision);
+}
+
+void ScOperatorStream::setPrecision(int precision)
+{
+	m_precision = qBound(0, precision, int(MaxPrecision));
+}
+
+ScOperatorStream& ScOperatorStream::operator<<(double value)
+{
+	appendNumber(value);
+	m_buffer.append(' ');
+	return *this;
+}
+
+ScOperatorStream& ScOperatorStream::operator<<(int value)
+{
+	appendNumber(value);
+	m_buffer.append(' ');
+	return *this;
+}
+
+ScOperatorStream& ScOperatorStream::operator<<(const char* text)
+{
+	m_buffer.append(text);
+	return *this;
+}
+
+ScOperatorStream& ScOperatorStream::operator<<(const QByteArray& text)
+{
+	m_buffer.append(text);
+	return *this;
+}
+
+ScOperatorStream& ScOperatorStream::operator<<(char c)
+{
+	m_buffer.append(c);
+	return *this;
+}
+
+ScOperatorStream& ScOperatorStream::op(const char* name)
+{
+	m_buffer.append(name);
+	m_buffer.append('\n');
+	return *this;
+}
+
+void ScOperatorStream::appendNumber(double value)
+{
+	char number[NumberBufferSize];
+	m_buffer.append(number, formatNumber(number, value, m_precision));
+}
+
+void ScOperatorStream::appendNumber(int value)
+{
+	char number[NumberBufferSize];
+	m_buffer.append(number, formatNumber(number, value));
+}
+
+QByteArray ScOperatorStream::take()
+{
+	QByteArray result;
+	result.swap(m_buffer);
+	return result;
+}
+
+int ScOperatorStream::formatNumber(char* buffer, double value, int precision)
+{
+	if (!qIsFinite(value))
+	{
+		buffer[0] = '0';
+		return 1;
+	}
+	bool negative = (value < 0.0);
+	// Neither PDF nor PostScript interpreters handle larger numbers
+	double absValue = qMin(std::fabs(value), maxExactInteger);
+	int decimals = qBound(0, precision, int(MaxPrecision));
+	double scaled = std::round(absValue * powersOfTen[decimals]);
+	// Decimals beyond the precision of a double are noise
+	while ((scaled >= maxExactInteger) && (decimals > 0))
+	{
+		--decimals;
+		scaled = std::round(absValue * powersOfTen[decimals]);
+	}
+	if (scaled == 0.0)
+	{
+		buffer[0] = '0';
+		return 1;
+	}
+	int length = 0;
+	if (negative)
+		buffer[length++] = '-';
+	return length + writeDigits(buffer + length, static_cast<quint64>(scaled), decimals);
+}
+
+int ScOperatorStream::formatNumber(char* buffer, int value)
+{
+	int length = 0;
+	quint64 absValue = static_cast<quint64>(value < 0 ? -static_cast<qint64>(value) : value);
+	if (value < 0)
+		buffer[length++] = '-';
+	return length + writeDigits(buffer + length, absValue, 0);
+}
+
+QByteArray ScOperatorStream::number(double value, int precision)
+{
+	char number[NumberBufferSize];
+	return QByteArray(number, formatNumber(number, value, precision));
+}
@@ -0,0 +1,79 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCOPERATORSTREAM_H
+#define SCOPERATORSTREAM_H
+
+#include <QByteArray>
+
+#include "scribusapi.h"
+
+/**
+ * \brief Builder for PDF content streams and PostScript code.
+ *
+ * Page descriptions consist mostly of numbers followed by an operator, e.g.
+ * "10 20 m". Building them by concatenating temporary strings costs several
+ * allocations per number. The stream formats numbers directly into its
+ * buffer without allocating and without depending on the current locale.
+ *
+ * Numbers are written in fixed notation, which is the only one PDF accepts,
+ * rounded to the precision and with trailing zeros removed.
+ */
+class SCRIBUS_API ScOperatorStream
+{
+public:
+	enum
+	{
+		DefaultPrecision = 5,
+		MaxPrecision = 17,
+		//! Size of a buffer large enough for any number written by formatNumber()
+		NumberBufferSize = 48
+	};
+
+	explicit ScOperatorStream(int precision = DefaultPrecision);
+
+	/** \brief Maximum number of decimals written */
+	int precision() const { return m_precision; }
+	void setPrecision(int precision);
+
+	/** \brief Append a number followed by a space, as operand of the next operator */
+	ScOperatorStream& operator<<(double value);
+	ScOperatorStream& operator<<(int value);
+	/** \brief Append raw text */
+	ScOperatorStream& operator<<(const char* text);
+	ScOperatorStream& operator<<(const QByteArray& text);
+	ScOperatorStream& operator<<(char c);
+
+	/** \brief Append an operator and end the line */
+	ScOperatorStream& op(const char* name);
+	/** \brief Append a number without separator */
+	void appendNumber(double value);
+	void appendNumber(int value);
+
+	const QByteArray& data() const { return m_buffer; }
+	/** \brief Return the content and leave the stream empty */
+	QByteArray take();
+	void clear() { m_buffer.resize(0); }
+	void reserve(int size) { m_buffer.reserve(size); }
+	int size() const { return m_buffer.size(); }
+	bool isEmpty() const { return m_buffer.isEmpty(); }
+
+	/**
+	 * \brief Write a number to buffer, which must hold NumberBufferSize bytes.
+	 * \return number of characters written, no terminating zero is added
+	 */
+	static int formatNumber(char* buffer, double value, int precision = DefaultPrecision);
+	static int formatNumber(char* buffer, int value);
+	/** \brief Convenience for code which is not performance critical */
+	static QByteArray number(double value, int precision = DefaultPrecision);
+
+private:
+	QByteArray m_buffer;
+	int m_precision;
+};
+
+#endif
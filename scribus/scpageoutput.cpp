@@ -990,7 +990,7 @@ public:
 
 		double sizeFactor = fontSize() / 10.0;
 		QVector<FPointArray> outlines = gc.glyphClusterOutline();
-		const QList<GlyphLayout>& glyphs = gc.glyphs();
+		const QVector<GlyphLayout>& glyphs = gc.glyphs();
 		for (int i = 0; i < glyphs.count(); ++i)
 		{
 			const FPointArray& outline = outlines.at(i);
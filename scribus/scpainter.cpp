@@ -6,6 +6,7 @@ for which a new license (GPL+exception) is in place.
 */
 
 #include "scpainter.h"
+#include "scblurengine.h"
 #include "scpattern.h"
 #include "util_color.h"
 #include "util.h"
@@ -1938,126 +1939,12 @@ void ScPainter::blurAlpha(int radius)
 	if (radius < 1)
 		return;
 	cairo_surface_t *data = cairo_get_group_target(m_cr);
-	QRgb *pix = (QRgb*)cairo_image_surface_get_data(data);
-	int w   = cairo_image_surface_get_width(data);
-	int h   = cairo_image_surface_get_height(data);
-	int wm  = w-1;
-	int hm  = h-1;
-	int wh  = w*h;
-	int div = radius+radius+1;
-	int *a = new int[wh];
-	int asum, x, y, i, yp, yi, yw;
-	QRgb p;
-	int *vmin = new int[qMax(w,h)];
-	int divsum = (div+1)>>1;
-	divsum *= divsum;
-	int *dv = new int[256*divsum];
-	for (i=0; i < 256*divsum; ++i)
-	{
-		dv[i] = (i/divsum);
-	}
-	yw = yi = 0;
-	int **stack = new int*[div];
-	for (int i = 0; i < div; ++i)
-	{
-		stack[i] = new int[1];
-	}
-	int stackpointer;
-	int stackstart;
-	int *sir;
-	int rbs;
-	int r1 = radius+1;
-	int aoutsum;
-	int ainsum;
-	for (y = 0; y < h; ++y)
-	{
-		ainsum = aoutsum = asum = 0;
-		for (i = -radius; i <= radius; ++i)
-		{
-			p = pix[yi+qMin(wm,qMax(i,0))];
-			sir = stack[i+radius];
-			sir[0] = qAlpha(p);
-			rbs = r1-abs(i);
-			asum += sir[0]*rbs;
-			if (i > 0)
-				ainsum += sir[0];
-			else
-				aoutsum += sir[0];
-		}
-		stackpointer = radius;
-		for (x=0; x < w; ++x)
-		{
-			a[yi] = dv[asum];
-			asum -= aoutsum;
-			stackstart = stackpointer-radius+div;
-			sir = stack[stackstart%div];
-			aoutsum -= sir[0];
-			if (y == 0)
-				vmin[x] = qMin(x+radius+1,wm);
-			p = pix[yw+vmin[x]];
-			sir[0] = qAlpha(p);
-			ainsum += sir[0];
-			asum += ainsum;
-			stackpointer = (stackpointer+1)%div;
-			sir = stack[(stackpointer)%div];
-			aoutsum += sir[0];
-			ainsum -= sir[0];
-			++yi;
-		}
-		yw += w;
-	}
-	for (x=0; x < w; ++x)
-	{
-		ainsum = aoutsum = asum = 0;
-		yp = -radius * w;
-		for (i = -radius; i <= radius; ++i)
-		{
-			yi=qMax(0,yp)+x;
-			sir = stack[i+radius];
-			sir[0] = a[yi];
-			rbs = r1-abs(i);
-			asum += a[yi]*rbs;
-			if (i > 0)
-				ainsum += sir[0];
-			else
-				aoutsum += sir[0];
-			if (i < hm)
-			{
-				yp += w;
-			}
-		}
-		yi = x;
-		stackpointer = radius;
-		for (y=0; y < h; ++y)
-		{
-			pix[yi] = qRgba(qRed(pix[yi]), qGreen(pix[yi]), qBlue(pix[yi]), dv[asum]);
-			asum -= aoutsum;
-			stackstart = stackpointer-radius+div;
-			sir = stack[stackstart%div];
-			aoutsum -= sir[0];
-			if (x==0)
-			{
-				vmin[y] = qMin(y+r1,hm)*w;
-			}
-			p = x+vmin[y];
-			sir[0] = a[p];
-			ainsum += sir[0];
-			asum += ainsum;
-			stackpointer = (stackpointer+1)%div;
-			sir = stack[stackpointer];
-			aoutsum += sir[0];
-			ainsum -= sir[0];
-			yi += w;
-		}
-	}
-	delete [] a;
-	delete [] vmin;
-	delete [] dv;
-	for (int i = 0; i < div; ++i)
-	{
-		delete [] stack[i];
-	}
-	delete [] stack;
+	cairo_surface_flush(data);
+	uchar *pix = cairo_image_surface_get_data(data);
+	int w = cairo_image_surface_get_width(data);
+	int h = cairo_image_surface_get_height(data);
+	int stride = cairo_image_surface_get_stride(data);
+	ScBlurEngine::blurAlpha(pix, w, h, stride, radius);
 	cairo_surface_mark_dirty(data);
 }
 
@@ -2066,210 +1953,11 @@ void ScPainter::blur(int radius)
 	if (radius < 1)
 		return;
 	cairo_surface_t *data = cairo_get_group_target(m_cr);
-	QRgb *pix = (QRgb*)cairo_image_surface_get_data(data);
-	int w   = cairo_image_surface_get_width(data);
-	int h   = cairo_image_surface_get_height(data);
-	int wm  = w-1;
-	int hm  = h-1;
-	int wh  = w*h;
-	int div = radius+radius+1;
-	int *r = new int[wh];
-	int *g = new int[wh];
-	int *b = new int[wh];
-	int *a = new int[wh];
-	int rsum, gsum, bsum, asum, x, y, i, yp, yi, yw;
-	QRgb p;
-	int *vmin = new int[qMax(w,h)];
-	int divsum = (div+1)>>1;
-	divsum *= divsum;
-	int *dv = new int[256*divsum];
-	for (i=0; i < 256*divsum; ++i)
-	{
-		dv[i] = (i/divsum);
-	}
-	yw = yi = 0;
-	int **stack = new int*[div];
-	for (int i = 0; i < div; ++i)
-	{
-		stack[i] = new int[4];
-	}
-	int stackpointer;
-	int stackstart;
-	int *sir;
-	int rbs;
-	int r1 = radius+1;
-	int routsum, goutsum, boutsum, aoutsum;
-	int rinsum, ginsum, binsum, ainsum;
-	for (y = 0; y < h; ++y)
-	{
-		rinsum = ginsum = binsum = ainsum = routsum = goutsum = boutsum = aoutsum = rsum = gsum = bsum = asum = 0;
-		for (i = -radius; i <= radius; ++i)
-		{
-			p = pix[yi+qMin(wm,qMax(i,0))];
-			sir = stack[i+radius];
-			sir[0] = qRed(p);
-			sir[1] = qGreen(p);
-			sir[2] = qBlue(p);
-			sir[3] = qAlpha(p);
-			rbs = r1-abs(i);
-			rsum += sir[0]*rbs;
-			gsum += sir[1]*rbs;
-			bsum += sir[2]*rbs;
-			asum += sir[3]*rbs;
-			if (i > 0)
-			{
-				rinsum += sir[0];
-				ginsum += sir[1];
-				binsum += sir[2];
-				ainsum += sir[3];
-			}
-			else
-			{
-				routsum += sir[0];
-				goutsum += sir[1];
-				boutsum += sir[2];
-				aoutsum += sir[3];
-			}
-		}
-		stackpointer = radius;
-		for (x=0; x < w; ++x)
-		{
-			r[yi] = dv[rsum];
-			g[yi] = dv[gsum];
-			b[yi] = dv[bsum];
-			a[yi] = dv[asum];
-			rsum -= routsum;
-			gsum -= goutsum;
-			bsum -= boutsum;
-			asum -= aoutsum;
-			stackstart = stackpointer-radius+div;
-			sir = stack[stackstart%div];
-			routsum -= sir[0];
-			goutsum -= sir[1];
-			boutsum -= sir[2];
-			aoutsum -= sir[3];
-			if (y == 0)
-			{
-				vmin[x] = qMin(x+radius+1,wm);
-			}
-			p = pix[yw+vmin[x]];
-			sir[0] = qRed(p);
-			sir[1] = qGreen(p);
-			sir[2] = qBlue(p);
-			sir[3] = qAlpha(p);
-			rinsum += sir[0];
-			ginsum += sir[1];
-			binsum += sir[2];
-			ainsum += sir[3];
-			rsum += rinsum;
-			gsum += ginsum;
-			bsum += binsum;
-			asum += ainsum;
-			stackpointer = (stackpointer+1)%div;
-			sir = stack[(stackpointer)%div];
-			routsum += sir[0];
-			goutsum += sir[1];
-			boutsum += sir[2];
-			aoutsum += sir[3];
-			rinsum -= sir[0];
-			ginsum -= sir[1];
-			binsum -= sir[2];
-			ainsum -= sir[3];
-			++yi;
-		}
-		yw += w;
-	}
-	for (x=0; x < w; ++x)
-	{
-		rinsum = ginsum = binsum = ainsum = routsum = goutsum = boutsum = aoutsum = rsum = gsum = bsum = asum = 0;
-		yp =- radius * w;
-		for (i=-radius; i <= radius; ++i)
-		{
-			yi=qMax(0,yp)+x;
-			sir = stack[i+radius];
-			sir[0] = r[yi];
-			sir[1] = g[yi];
-			sir[2] = b[yi];
-			sir[3] = a[yi];
-			rbs = r1-abs(i);
-			rsum += r[yi]*rbs;
-			gsum += g[yi]*rbs;
-			bsum += b[yi]*rbs;
-			asum += a[yi]*rbs;
-			if (i > 0)
-			{
-				rinsum += sir[0];
-				ginsum += sir[1];
-				binsum += sir[2];
-				ainsum += sir[3];
-			}
-			else
-			{
-				routsum += sir[0];
-				goutsum += sir[1];
-				boutsum += sir[2];
-				aoutsum += sir[3];
-			}
-			if (i < hm)
-			{
-				yp += w;
-			}
-		}
-		yi = x;
-		stackpointer = radius;
-		for (y=0; y < h; ++y)
-		{
-			pix[yi] = qRgba(dv[rsum], dv[gsum], dv[bsum], dv[asum]);
-			rsum -= routsum;
-			gsum -= goutsum;
-			bsum -= boutsum;
-			asum -= aoutsum;
-			stackstart = stackpointer-radius+div;
-			sir = stack[stackstart%div];
-			routsum -= sir[0];
-			goutsum -= sir[1];
-			boutsum -= sir[2];
-			aoutsum -= sir[3];
-			if (x==0)
-			{
-				vmin[y] = qMin(y+r1,hm)*w;
-			}
-			p = x+vmin[y];
-			sir[0] = r[p];
-			sir[1] = g[p];
-			sir[2] = b[p];
-			sir[3] = a[p];
-			rinsum += sir[0];
-			ginsum += sir[1];
-			binsum += sir[2];
-			ainsum += sir[3];
-			rsum += rinsum;
-			gsum += ginsum;
-			bsum += binsum;
-			asum += ainsum;
-			stackpointer = (stackpointer+1)%div;
-			sir = stack[stackpointer];
-			routsum += sir[0];
-			goutsum += sir[1];
-			boutsum += sir[2];
-			aoutsum += sir[3];
-			rinsum -= sir[0];
-			ginsum -= sir[1];
-			binsum -= sir[2];
-			ainsum -= sir[3];
-			yi += w;
-		}
-	}
-	delete [] r;
-	delete [] g;
-	delete [] b;
-	delete [] a;
-	delete [] vmin;
-	delete [] dv;
-	for (int i = 0; i < div; ++i)
-	{
-		delete [] stack[i];
-	}
-	delete [] stack;
+	cairo_surface_flush(data);
+	uchar *pix = cairo_image_surface_get_data(data);
+	int w = cairo_image_surface_get_width(data);
+	int h = cairo_image_surface_get_height(data);
+	int stride = cairo_image_surface_get_stride(data);
+	ScBlurEngine::blur(pix, w, h, stride, radius);
 	cairo_surface_mark_dirty(data);
 }
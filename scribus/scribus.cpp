@@ -188,6 +188,7 @@ for which a new license (GPL+exception) is in place.
 #include "ui/inspage.h"
 #include "ui/javadocs.h"
 #include "ui/layers.h"
+#include "ui/layoutprofilepalette.h"
 #include "ui/loremipsum.h"
 #include "ui/marginwidget.h"
 #include "ui/mark2item.h"
@@ -680,6 +681,12 @@ void ScribusMainWindow::initPalettes()
 	inlinePalette->installEventFilter(this);
 	inlinePalette->hide();
 
+	layoutProfilePalette = new LayoutProfilePalette(this);
+	connect(scrActions["toolsLayoutProfile"], SIGNAL(toggled(bool)), layoutProfilePalette, SLOT(setPaletteShown(bool)));
+	connect(layoutProfilePalette, SIGNAL(paletteShown(bool)), scrActions["toolsLayoutProfile"], SLOT(setChecked(bool)));
+	layoutProfilePalette->installEventFilter(this);
+	layoutProfilePalette->hide();
+
 	undoPalette = new UndoPalette(this, "undoPalette");
 	undoPalette->installEventFilter(this);
 	m_undoManager->registerGui(undoPalette);
@@ -1220,6 +1227,7 @@ void ScribusMainWindow::addDefaultWindowMenuItems()
 	scrMenuMgr->addMenuItemString("SEPARATOR", "Windows");
 	scrMenuMgr->addMenuItemString("toolsMeasurements", "Windows");
 	scrMenuMgr->addMenuItemString("toolsPreflightVerifier", "Windows");
+	scrMenuMgr->addMenuItemString("toolsLayoutProfile", "Windows");
 	scrMenuMgr->addMenuItemString("SEPARATOR", "Windows");
 	scrMenuMgr->addMenuItemString("toolsToolbarTools", "Windows");
 	scrMenuMgr->addMenuItemString("toolsToolbarPDF", "Windows");
@@ -2003,6 +2011,7 @@ void ScribusMainWindow::closeEvent(QCloseEvent *ce)
 	charPalette->hide();
 	symbolPalette->hide();
 	inlinePalette->hide();
+	layoutProfilePalette->hide();
 
 	// Clean up plugins, THEN save prefs to disk
 	ScCore->pluginManager->cleanupPlugins();
@@ -3792,12 +3801,8 @@ bool ScribusMainWindow::loadDoc(const QString& fileName)
 		/*QTime t;
 		t.start();*/
 		doc->flag_Renumber = false;
-		for (auto iti = doc->Items->begin(); iti != doc->Items->end(); ++iti)
-		{
-			PageItem* ite = *iti;
-			if ((ite->nextInChain() == nullptr) && !ite->isNoteFrame())  //do not layout notes frames
-				ite->layout();
-		}
+		// frames far from the viewport are laid out in idle time
+		doc->layoutTextFrames();
 		if (!doc->marksList().isEmpty())
 		{
 			doc->setLoading(true);
@@ -3948,7 +3953,7 @@ void ScribusMainWindow::slotGetContent()
 		}
 		delete gt;
 		if (doc->docHyphenator->AutoCheck)
-			doc->docHyphenator->slotHyphenate(currItem);
+			doc->docHyphenator->hyphenateInBackground(currItem);
 		for (int a = 0; a < doc->Items->count(); ++a)
 		{
 			if (doc->Items->at(a)->isBookmark)
@@ -3999,7 +4004,7 @@ void ScribusMainWindow::slotGetContent2() // kk2006
 
 	ScGTPluginManager::instance()->run();
 	if (doc->docHyphenator->AutoCheck)
-		doc->docHyphenator->slotHyphenate(currItem);
+		doc->docHyphenator->hyphenateInBackground(currItem);
 	for (int a = 0; a < doc->Items->count(); ++a)
 	{
 		if (doc->Items->at(a)->isBookmark)
@@ -6733,6 +6738,7 @@ void ScribusMainWindow::slotPrefsOrg()
 		icm.setMaxCacheSizeMiB(newPrefs.imageCachePrefs.maxCacheSizeMiB);
 		icm.setMaxCacheEntries(newPrefs.imageCachePrefs.maxCacheEntries);
 		icm.setCompressionLevel(newPrefs.imageCachePrefs.compressionLevel);
+		icm.setAdaptiveSizing(newPrefs.imageCachePrefs.adaptiveSize);
 
 		m_prefsManager->SavePrefs();
 	}
@@ -6822,6 +6828,7 @@ int ScribusMainWindow::ShowSubs()
 	marksManager->startup();
 	nsEditor->startup();
 	symbolPalette->startup();
+	layoutProfilePalette->startup();
 #if QT_VERSION < 0x050600
 	if (!m_prefsManager->appPrefs.uiPrefs.tabbedPalettes.isEmpty())
 	{
@@ -6968,6 +6975,8 @@ void ScribusMainWindow::doPrintPreview()
 
 void ScribusMainWindow::printPreview()
 {
+	// the preview may show any page
+	doc->layoutDeferredTextFrames();
 	if (doc->checkerProfiles()[doc->curCheckProfile()].autoCheck)
 	{
 		if (scanDocument())
@@ -78,6 +78,7 @@ class GuideManager;
 class HelpBrowser;
 class InlinePalette;
 class LayerPalette;
+class LayoutProfilePalette;
 class MarksManager;
 class Measurements;
 class ModeToolBar;
@@ -243,6 +244,7 @@ public:
 	DownloadsPalette *downloadsPalette;
 	SymbolPalette *symbolPalette;
 	InlinePalette *inlinePalette;
+	LayoutProfilePalette *layoutProfilePalette;
 	Measurements* measurementPalette;
 	CheckDocument * docCheckerPalette;
 	UndoPalette* undoPalette;
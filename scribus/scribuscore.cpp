@@ -39,6 +39,8 @@ for which a new license (GPL+exception) is in place.
 #include "scpaths.h"
 #include "scribus.h"
 #include "scribusapp.h"
+#include "scthumbnailservice.h"
+#include "text/totalfitbreakcache.h"
 #include "ui/splash.h"
 #include "undomanager.h"
 #include "util_debug.h"
@@ -80,6 +82,10 @@ ScribusCore::~ScribusCore()
 		delete mainWindow;
 	}
 	delete pluginManager;
+	// background jobs must finish while the application still exists
+	ScThumbnailService::deleteInstance();
+	TotalFitBreakCache::deleteInstance();
+	ScImageCacheManager::instance().writeSessionLog();
 }
 
 #ifndef NDEBUG
@@ -211,6 +217,7 @@ int ScribusCore::initScribusCore(bool showSplash, bool showFontInfo, bool showPr
 	icm.setMaxCacheSizeMiB(m_prefsManager->appPrefs.imageCachePrefs.maxCacheSizeMiB);
 	icm.setMaxCacheEntries(m_prefsManager->appPrefs.imageCachePrefs.maxCacheEntries);
 	icm.setCompressionLevel(m_prefsManager->appPrefs.imageCachePrefs.compressionLevel);
+	icm.setAdaptiveSizing(m_prefsManager->appPrefs.imageCachePrefs.adaptiveSize);
 	icm.initialize();
 	return 0;
 }
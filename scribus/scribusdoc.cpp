@@ -95,6 +95,7 @@ for which a new license (GPL+exception) is in place.
 #include "tableborder.h"
 #include "text/textlayoutpainter.h"
 #include "text/textshaper.h"
+#include "textlayouttask.h"
 #include "ui/guidemanager.h"
 #include "ui/hruler.h"
 #include "ui/inserttablecolumnsdialog.h"
@@ -262,6 +263,9 @@ ScribusDoc::ScribusDoc() : UndoObject( tr("Document")), Observable<ScribusDoc>(n
 	m_alignTransaction(nullptr),
 	m_currentPage(nullptr),
 	m_docUpdater(nullptr),
+	m_itemBatchLevel(0),
+	m_itemNameIndexList(nullptr),
+	m_textLayoutTask(nullptr),
 	m_flag_notesChanged(false),
 	flag_restartMarksRenumbering(false),
 	flag_updateMarksLabels(false),
@@ -357,6 +361,9 @@ ScribusDoc::ScribusDoc(const QString& docName, int unitindex, const PageSize& pa
 	m_alignTransaction(nullptr),
 	m_currentPage(nullptr),
 	m_docUpdater(nullptr),
+	m_itemBatchLevel(0),
+	m_itemNameIndexList(nullptr),
+	m_textLayoutTask(nullptr),
 	m_flag_notesChanged(false),
 	flag_restartMarksRenumbering(false),
 	flag_updateMarksLabels(false),
@@ -576,6 +583,9 @@ void ScribusDoc::init()
 ScribusDoc::~ScribusDoc()
 {
 	m_guardedObject.nullify();
+	if ((m_textLayoutTask != nullptr) && !m_textLayoutTask->isFinished())
+		m_textLayoutTask->cancel();
+	delete m_textLayoutTask;
 	CloseCMSProfiles();
 	ScCore->fileWatcher->stop();
 	ScCore->fileWatcher->removeFile(m_documentFileName);
@@ -906,6 +916,7 @@ void ScribusDoc::CloseCMSProfiles()
 
 void ScribusDoc::SetDefaultCMSParams()
 {
+	m_colorCache.invalidate();
 	BlackPoint     = true;
 	SoftProofing   = false;
 	Gamut          = false;
@@ -1047,6 +1058,7 @@ bool ScribusDoc::OpenCMSProfiles(ProfilesL InPo, ProfilesL InPoCMYK, ProfilesL M
 					stdTransImg      && stdTransRGB       && stdTransCMYK   && stdProof        &&
 					stdProofGC       && stdProofCMYK      && stdProofCMYKGC &&
 					stdLabToRGBTrans && stdLabToCMYKTrans && stdLabToScreenTrans && stdProofLab && stdProofLabGC);
+	m_colorCache.invalidate();
 	if (!success)
 	{
 		CloseCMSProfiles();
@@ -5053,6 +5065,9 @@ void ScribusDoc::recalculateColorItem(PageItem *item)
 
 void ScribusDoc::recalculateColors()
 {
+	// Colors or color management settings have changed, cached conversions are obsolete
+	m_colorCache.invalidate();
+
 	// #12658, #13889 : disable undo temporarily, there is nothing to cancel here
 	m_undoManager->setUndoEnabled(false);
 
@@ -5397,7 +5412,8 @@ PageItem* ScribusDoc::createPageItem(const PageItem::ItemType itemType, const Pa
 int ScribusDoc::itemAdd(const PageItem::ItemType itemType, const PageItem::ItemFrameType frameType, const double x, const double y, const double b, const double h, const double w, const QString& fill, const QString& outline, PageItem::ItemKind itemKind)
 {
 	UndoTransaction activeTransaction;
-	if (UndoManager::undoEnabled()) // && !m_itemCreationTransaction)
+	// Items of a batch are recorded in the transaction of the caller if there is one
+	if (UndoManager::undoEnabled() && ((m_itemBatchLevel == 0) || !m_undoManager->isTransactionMode())) // && !m_itemCreationTransaction)
 	{
 		activeTransaction = m_undoManager->beginTransaction();
 	}
@@ -6539,28 +6555,68 @@ int ScribusDoc::currentPageNumber()
 }
 
 
-bool ScribusDoc::itemNameExists(const QString& checkItemName)
+// Walks the items recursively instead of collecting the children of every
+// group, this is called for each item named during imports of large files
+static bool itemNameExistsIn(const QList<PageItem*>& items, const QString& checkItemName)
 {
-	bool found = false;
-	QList<PageItem*> allItems;
-	int docItemCount = Items->count();
-	for (int i = 0; i < docItemCount; ++i)
+	for (int i = 0; i < items.count(); ++i)
 	{
-		PageItem *currItem = Items->at(i);
+		const PageItem *currItem = items.at(i);
 		if (checkItemName == currItem->itemName())
 			return true;
+		if (currItem->isGroup() && itemNameExistsIn(currItem->groupItemList, checkItemName))
+			return true;
+	}
+	return false;
+}
+
+static void collectItemNames(const QList<PageItem*>& items, QSet<QString>& names)
+{
+	for (int i = 0; i < items.count(); ++i)
+	{
+		const PageItem *currItem = items.at(i);
+		names.insert(currItem->itemName());
 		if (currItem->isGroup())
-		{
-			allItems = currItem->getAllChildren();
-			for (int ii = 0; ii < allItems.count(); ii++)
-			{
-				if (checkItemName == allItems.at(ii)->itemName())
-					return true;
-			}
-		}
-		allItems.clear();
+			collectItemNames(currItem->groupItemList, names);
 	}
-	return found;
+}
+
+bool ScribusDoc::itemNameExists(const QString& checkItemName)
+{
+	if (m_itemBatchLevel == 0)
+		return itemNameExistsIn(*Items, checkItemName);
+	// Names of deleted or renamed items stay in the index, at worst a number is skipped
+	if (m_itemNameIndexList != Items)
+	{
+		m_itemNameIndex.clear();
+		collectItemNames(*Items, m_itemNameIndex);
+		m_itemNameIndexList = Items;
+	}
+	return m_itemNameIndex.contains(checkItemName);
+}
+
+void ScribusDoc::registerItemName(const QString& itemName)
+{
+	if ((m_itemBatchLevel > 0) && (m_itemNameIndexList == Items))
+		m_itemNameIndex.insert(itemName);
+}
+
+void ScribusDoc::beginItemBatch(int expectedCount)
+{
+	// counts often come from file headers, reserving is only a hint and must not exhaust memory
+	static const int maxReservedItems = 1 << 20;
+	++m_itemBatchLevel;
+	if (expectedCount > 0)
+		Items->reserve(Items->count() + qMin(expectedCount, maxReservedItems));
+}
+
+void ScribusDoc::endItemBatch()
+{
+	Q_ASSERT(m_itemBatchLevel > 0);
+	if (--m_itemBatchLevel > 0)
+		return;
+	m_itemNameIndex.clear();
+	m_itemNameIndexList = nullptr;
 }
 
 
@@ -13237,6 +13293,7 @@ void ScribusDoc::changed()
 void ScribusDoc::invalidateAll()
 {
 	QList<PageItem*> allItems;
+	QList<PageItem*> textFrames;
 	for (int c = 0; c < DocItems.count(); ++c)
 	{
 		PageItem *ite = DocItems.at(c);
@@ -13248,6 +13305,8 @@ void ScribusDoc::invalidateAll()
 		{
 			ite = allItems.at(ii);
 			ite->invalidateLayout();
+			if (ite->isTextFrame() && (ite->nextInChain() == nullptr) && !ite->isNoteFrame())
+				textFrames.append(ite);
 		}
 		allItems.clear();
 	}
@@ -13266,6 +13325,75 @@ void ScribusDoc::invalidateAll()
 		allItems.clear();
 	}
 	// for now hope that frameitems get invalidated by their parents layout() method.
+	// Visible frames are laid out when drawn, get the others ready meanwhile
+	if (ScCore->usingGUI() && !isLoading())
+		scheduleTextLayout(textFrames);
+}
+
+void ScribusDoc::layoutTextFrames()
+{
+	bool deferOffscreen = ScCore->usingGUI() && (m_View != nullptr);
+	// Marks and notes are updated from the layout of all frames
+	if (!marksList().isEmpty())
+		deferOffscreen = false;
+	QRectF visibleArea;
+	int visiblePage = -1;
+	if (deferOffscreen)
+	{
+		visibleArea = m_View->visibleCanvas();
+		if (currentPage() != nullptr)
+			visiblePage = currentPage()->pageNr();
+	}
+	QList<PageItem*> offscreenFrames;
+	for (int i = 0; i < DocItems.count(); ++i)
+	{
+		PageItem* currItem = DocItems.at(i);
+		if ((currItem->nextInChain() != nullptr) || currItem->isNoteFrame())  //do not layout notes frames
+			continue;
+		bool visible = true;
+		if (deferOffscreen && currItem->isTextFrame())
+		{
+			visible = false;
+			for (PageItem* frame = currItem; frame != nullptr && !visible; frame = frame->prevInChain())
+				visible = (frame->OwnPage == visiblePage) || frame->getVisualBoundingRect().intersects(visibleArea);
+		}
+		if (visible)
+			currItem->layout();
+		else
+			offscreenFrames.append(currItem);
+	}
+	scheduleTextLayout(offscreenFrames);
+}
+
+void ScribusDoc::scheduleTextLayout(const QList<PageItem*>& frames)
+{
+	if (frames.isEmpty())
+		return;
+	if (!ScCore->usingGUI())
+	{
+		for (int i = 0; i < frames.count(); ++i)
+			frames.at(i)->layout();
+		return;
+	}
+	if ((m_textLayoutTask != nullptr) && m_textLayoutTask->isFinished())
+	{
+		m_textLayoutTask->deleteLater();
+		m_textLayoutTask = nullptr;
+	}
+	if (m_textLayoutTask == nullptr)
+	{
+		m_textLayoutTask = new TextLayoutTask(this);
+		m_textLayoutTask->addFrames(frames);
+		m_textLayoutTask->start();
+	}
+	else
+		m_textLayoutTask->addFrames(frames);
+}
+
+void ScribusDoc::layoutDeferredTextFrames()
+{
+	if (m_textLayoutTask != nullptr)
+		m_textLayoutTask->layoutRemaining();
 }
 
 void ScribusDoc::invalidateLayer(int layerID)
@@ -14798,7 +14926,7 @@ PageItem* ScribusDoc::groupObjectsSelection(Selection* customSelection)
 		currItem->gYpos = currItem->yPos() - y;
 		currItem->gWidth = w;
 		currItem->gHeight = h;
-		lowestItem = qMin(lowestItem, Items->indexOf(currItem));
+		lowestItem = qMin(lowestItem, Items->lastIndexOf(currItem));
 	}
 	double minx =  std::numeric_limits<double>::max();
 	double miny =  std::numeric_limits<double>::max();
@@ -14829,7 +14957,7 @@ PageItem* ScribusDoc::groupObjectsSelection(Selection* customSelection)
 	for (int i = 0; i < selectedItemCount; ++i)
 	{
 		currItem = itemSelection->itemAt(i);
-		int d = Items->indexOf(currItem);
+		int d = Items->lastIndexOf(currItem);
 		if (d >= 0)
 			groupItem->groupItemList.append(Items->takeAt(d));
 		else
@@ -14853,7 +14981,7 @@ PageItem* ScribusDoc::groupObjectsList(QList<PageItem*> &itemList)
 	for (int i = 0; i < selectedItemCount; ++i)
 	{
 		currItem = itemList.at(i);
-		lowestItem = qMin(lowestItem, Items->indexOf(currItem));
+		lowestItem = qMin(lowestItem, Items->lastIndexOf(currItem));
 	}
 	double minx =  std::numeric_limits<double>::max();
 	double miny =  std::numeric_limits<double>::max();
@@ -14883,7 +15011,7 @@ PageItem* ScribusDoc::groupObjectsList(QList<PageItem*> &itemList)
 	for (int i = 0; i < selectedItemCount; ++i)
 	{
 		currItem = itemList.at(i);
-		int d = Items->indexOf(currItem);
+		int d = Items->lastIndexOf(currItem);
 		if (d >= 0)
 			groupItem->groupItemList.append(Items->takeAt(d));
 		else
@@ -14930,7 +15058,7 @@ void ScribusDoc::groupObjectsToItem(PageItem* groupItem, QList<PageItem*> &itemL
 	for (uint c = 0; c < selectedItemCount; ++c)
 	{
 		currItem = itemList.at(c);
-		int d = Items->indexOf(currItem);
+		int d = Items->lastIndexOf(currItem);
 		if (d >= 0)
 			groupItem->groupItemList.append(Items->takeAt(d));
 		else
@@ -14985,7 +15113,7 @@ PageItem * ScribusDoc::itemSelection_GroupObjects(bool changeLock, bool lock, Se
 		currItem->gYpos = currItem->yPos() - y;
 		currItem->gWidth = w;
 		currItem->gHeight = h;
-		lowestItem = qMin(lowestItem, Items->indexOf(currItem));
+		lowestItem = qMin(lowestItem, Items->lastIndexOf(currItem));
 	}
 	double minx =  std::numeric_limits<double>::max();
 	double miny =  std::numeric_limits<double>::max();
@@ -15018,7 +15146,7 @@ PageItem * ScribusDoc::itemSelection_GroupObjects(bool changeLock, bool lock, Se
 	for (int i = 0; i < selectedItemCount; ++i)
 	{
 		currItem = selectedItems.at(i);
-		int d = Items->indexOf(currItem);
+		int d = Items->lastIndexOf(currItem);
 		groupItem->groupItemList.append(Items->takeAt(d));
 		currItem->Parent = groupItem;
 	}
@@ -34,6 +34,7 @@ for which a new license (GPL+exception) is in place.
 #include <QObject>
 #include <QPixmap>
 #include <QRectF>
+#include <QSet>
 #include <QStringList>
 #include <QTimer>
 #include <QFile>
@@ -53,6 +54,7 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_textframe.h"
 #include "pagestructs.h"
 #include "prefsstructs.h"
+#include "sccolorcache.h"
 #include "scguardedptr.h"
 #include "scpage.h"
 #include "sclayer.h"
@@ -82,6 +84,7 @@ class QProgressBar;
 class MarksManager;
 class NotesStyle;
 class TextNote;
+class TextLayoutTask;
 
 
 
@@ -131,6 +134,23 @@ public:
 	void invalidateLayer(int layerID);
 	void invalidateRegion(QRectF region);
 
+	/**
+	 * @brief Lay out the text frames of the document pages, e.g. after loading
+	 * With a GUI only the frames in the visible part of the canvas and on the current
+	 * page are laid out right away, the others are laid out in idle time.
+	 */
+	void layoutTextFrames();
+	/**
+	 * @brief Lay out frames in idle time, without GUI they are laid out right away
+	 */
+	void scheduleTextLayout(const QList<PageItem*>& frames);
+	/**
+	 * @brief Finish the layout of all frames waiting for idle time
+	 * Call before anything which needs the layout of the whole document,
+	 * e.g. export, printing, preflight or page count queries.
+	 */
+	void layoutDeferredTextFrames();
+
 
 	MarginStruct* scratch() { return &m_docPrefsData.displayPrefs.scratch; }
 	MarginStruct* bleeds() { return &m_docPrefsData.docSetupPrefs.bleeds; }
@@ -762,6 +782,10 @@ public:
 	void recalculateColorsList(QList<PageItem *> *itemList);
 	static void recalculateColorItem(PageItem *item);
 	void recalculateColors();
+	/**
+	 * @brief Cache of color conversions performed by ScColorEngine for this document
+	 */
+	ScColorCache& colorCache() const { return m_colorCache; }
 	/**
 	 * @brief Copies a normal page to be a master pages
 	 */
@@ -809,6 +833,21 @@ public:
 	 * @return If an item was committed and the view must emit its signal, which needs removing from here, TODO.
 	 */
 	bool itemAddCommit(PageItem* item);
+
+	/**
+	 * @brief Prepare the creation of a large number of items, e.g. by import filters.
+	 * Until the matching endItemBatch(), itemAdd() records new items in the undo transaction
+	 * already open instead of opening one per item, and new item names are checked against
+	 * an index instead of walking all items.
+	 * Layer and z-order need no deferring: a new item takes the active layer and its place
+	 * at the end of the item list, which costs the same inside and outside of a batch.
+	 * Calls may be nested.
+	 * @param expectedCount number of items about to be created, used to reserve room in the item list;
+	 * only a hint, callers should bound counts read from files by what the file can hold
+	 */
+	void beginItemBatch(int expectedCount = 0);
+	void endItemBatch();
+	bool itemBatchActive() const { return m_itemBatchLevel > 0; }
 	
 	/**
 	 * @brief Finalise item creation. Simply split off code from itemAdd
@@ -909,6 +948,10 @@ public:
 	 ** CB Moved from PageItem
 	 */
 	bool itemNameExists(const QString& itemName);
+	/**
+	 * @brief Tell the document an item took the given name, keeps the name index of item batches current
+	 */
+	void registerItemName(const QString& itemName);
 	
 	/**
 	 * @brief Set the doc into Master page mode
@@ -1393,6 +1436,11 @@ private:
 	MassObservable<ScPage*> m_pagesChanged;
 	MassObservable<QRectF> m_regionsChanged;
 	DocUpdater* m_docUpdater;
+	int m_itemBatchLevel;
+	QList<PageItem*>* m_itemNameIndexList;
+	QSet<QString> m_itemNameIndex;
+	mutable ScColorCache m_colorCache;
+	TextLayoutTask* m_textLayoutTask;
 	
 signals:
 	//Lets make our doc talk to our GUI rather than confusing all our normal stuff
@@ -28,20 +28,14 @@ ScText::~ScText()
 
 bool ScText::hasObject(ScribusDoc *doc) const
 {
-	if (this->ch == SpecialChars::OBJECT)
-		return ((embedded > 0) && (doc->FrameItems.contains(embedded)));
-	return false;
+	return ((embedded > 0) && (doc->FrameItems.contains(embedded)));
 }
 
 bool ScText::hasMark(Mark* MRK) const
 {
-	if (this->ch == SpecialChars::OBJECT)
-	{
-		if (MRK == nullptr)
-			return mark != nullptr;
-		return mark == MRK;
-	}
-	return false;
+	if (MRK == nullptr)
+		return mark != nullptr;
+	return mark == MRK;
 }
 
 QList<PageItem*> ScText::getGroupedItems(ScribusDoc *doc)
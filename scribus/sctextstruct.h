@@ -125,21 +125,28 @@ struct SCRIBUS_API GlyphLayout {
 	{ }
 };
 
+/**
+ * Style of a run of characters in a StoryText. The characters themselves are
+ * stored by ScText_Shared.
+ */
 class SCRIBUS_API ScText : public CharStyle
 {
 public:
-	ParagraphStyle* parstyle; // only for parseps
-	int embedded;
-	Mark* mark;
-	QChar ch;
+	ParagraphStyle* parstyle; // only for runs ending with a parsep
+	int embedded;             // only for inline object runs
+	Mark* mark;               // only for inline object runs
+	int computed;             // index of the computed style in the story, -1 if unknown
+	int computedPar;          // same for parstyle
 	ScText() :
 		CharStyle(),
 		parstyle(nullptr),
-		embedded(0), mark(nullptr), ch() {}
+		embedded(0), mark(nullptr),
+		computed(-1), computedPar(-1) {}
 	ScText(const ScText& other) :
 		CharStyle(other),
 		parstyle(nullptr),
-		embedded(other.embedded), mark(nullptr), ch(other.ch)
+		embedded(other.embedded), mark(nullptr),
+		computed(-1), computedPar(-1)
 	{
 		if (other.parstyle)
 			parstyle = new ParagraphStyle(*other.parstyle);
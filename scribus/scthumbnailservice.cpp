@@ -0,0 +1,285 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+
+#include "scthumbnailservice.h"
+
+#include "cmsettings.h"
+#include "fileloader.h"
+#include "loadsaveplugin.h"
+#include "plugins/formatidlist.h"
+#include "scimage.h"
+#include "scimagecacheproxy.h"
+
+class ScThumbnailWorker : public QRunnable
+{
+public:
+	explicit ScThumbnailWorker(ScThumbnailService* service) : m_service(service) {}
+
+	void run() override
+	{
+		ScThumbnailService::Job job;
+		while (m_service->takeJob(job))
+		{
+			ScThumbnailInfo info;
+			// Reading the cache only involves locked files, saving new entries
+			// updates the cache manager and is left to the main thread
+			bool fromCache = true;
+			QImage image = ScThumbnailService::loadFromCache(job, info);
+			if (image.isNull())
+			{
+				fromCache = false;
+				image = ScThumbnailService::generate(job, info);
+			}
+			QMetaObject::invokeMethod(m_service, "jobFinished", Qt::QueuedConnection,
+			                          Q_ARG(int, job.ticket), Q_ARG(QString, job.path), Q_ARG(int, job.size),
+			                          Q_ARG(QImage, image), Q_ARG(ScThumbnailInfo, info), Q_ARG(bool, fromCache));
+		}
+	}
+
+private:
+	ScThumbnailService* m_service;
+};
+
+ScThumbnailService* ScThumbnailService::m_instance = nullptr;
+
+ScThumbnailService* ScThumbnailService::instance()
+{
+	if (m_instance == nullptr)
+		m_instance = new ScThumbnailService();
+	return m_instance;
+}
+
+void ScThumbnailService::deleteInstance()
+{
+	delete m_instance;
+	m_instance = nullptr;
+}
+
+ScThumbnailService::ScThumbnailService()
+{
+	qRegisterMetaType<ScThumbnailInfo>("ScThumbnailInfo");
+	// Thumbnail generation is mostly I/O and decoding bound, leave one core to the GUI
+	m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+ScThumbnailService::~ScThumbnailService()
+{
+	m_mutex.lock();
+	m_queue.clear();
+	m_mutex.unlock();
+	m_pool.waitForDone();
+}
+
+int ScThumbnailService::request(const QString& path, int size, int priority)
+{
+	QMutexLocker locker(&m_mutex);
+	Job job;
+	job.ticket = m_nextTicket++;
+	job.path = path;
+	job.size = size;
+	job.priority = priority;
+	m_queue.append(job);
+	startWorkers();
+	return job.ticket;
+}
+
+void ScThumbnailService::setPriority(int ticket, int priority)
+{
+	QMutexLocker locker(&m_mutex);
+	for (int i = 0; i < m_queue.count(); ++i)
+	{
+		if (m_queue[i].ticket == ticket)
+		{
+			m_queue[i].priority = priority;
+			break;
+		}
+	}
+}
+
+void ScThumbnailService::cancel(int ticket)
+{
+	QMutexLocker locker(&m_mutex);
+	for (int i = 0; i < m_queue.count(); ++i)
+	{
+		if (m_queue[i].ticket == ticket)
+		{
+			m_queue.removeAt(i);
+			return;
+		}
+	}
+	if (m_running.contains(ticket))
+		m_cancelled.insert(ticket);
+}
+
+void ScThumbnailService::cancel(const QList<int>& tickets)
+{
+	for (int ticket : tickets)
+		cancel(ticket);
+}
+
+int ScThumbnailService::pendingCount() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_queue.count();
+}
+
+bool ScThumbnailService::takeJob(Job& job)
+{
+	QMutexLocker locker(&m_mutex);
+	if (m_queue.isEmpty())
+	{
+		--m_workers;
+		return false;
+	}
+	// Queues hold at most a few hundred entries, a linear scan is good enough
+	// and keeps requests of equal priority in order
+	int best = 0;
+	for (int i = 1; i < m_queue.count(); ++i)
+	{
+		if (m_queue[i].priority > m_queue[best].priority)
+			best = i;
+	}
+	job = m_queue.takeAt(best);
+	m_running.insert(job.ticket);
+	return true;
+}
+
+void ScThumbnailService::startWorkers()
+{
+	while ((m_workers < m_pool.maxThreadCount()) && (m_workers < m_queue.count()))
+	{
+		++m_workers;
+		m_pool.start(new ScThumbnailWorker(this));
+	}
+}
+
+void ScThumbnailService::jobFinished(int ticket, const QString& path, int size, const QImage& image, const ScThumbnailInfo& info, bool fromCache)
+{
+	m_mutex.lock();
+	m_running.remove(ticket);
+	bool cancelled = m_cancelled.remove(ticket);
+	m_mutex.unlock();
+
+	if (!fromCache && !image.isNull() && info.valid)
+		saveToCache(path, size, image, info);
+	if (!cancelled)
+		emit thumbnailReady(ticket, path, image, info);
+}
+
+static void addThumbnailModifiers(ScImageCacheProxy& cache, int size)
+{
+	cache.addModifier("requestType", "thumbnail");
+	cache.addModifier("thumbnailSize", QString::number(size));
+}
+
+QImage ScThumbnailService::loadFromCache(const Job& job, ScThumbnailInfo& info)
+{
+	QImage image;
+	ScImageCacheProxy cache(job.path);
+	if (!cache.enabled())
+		return image;
+	addThumbnailModifiers(cache, job.size);
+	if (!cache.canUseCachedImage() || !cache.load(image))
+		return QImage();
+	info.width = cache.getInfo("width").toInt();
+	info.height = cache.getInfo("height").toInt();
+	info.type = cache.getInfo("type").toInt();
+	info.colorspace = cache.getInfo("colorspace").toInt();
+	info.xdpi = cache.getInfo("xdpi").toInt();
+	info.ydpi = cache.getInfo("ydpi").toInt();
+	info.layers = cache.getInfo("layers").toInt();
+	info.embedded = cache.getInfo("embedded").toInt();
+	info.profileName = cache.getInfo("profileName");
+	info.valid = true;
+	cache.touch();
+	return image;
+}
+
+void ScThumbnailService::saveToCache(const QString& path, int size, const QImage& image, const ScThumbnailInfo& info)
+{
+	ScImageCacheProxy cache(path);
+	if (!cache.enabled())
+		return;
+	addThumbnailModifiers(cache, size);
+	cache.addInfo("width", QString::number(info.width));
+	cache.addInfo("height", QString::number(info.height));
+	cache.addInfo("type", QString::number(info.type));
+	cache.addInfo("colorspace", QString::number(info.colorspace));
+	cache.addInfo("xdpi", QString::number(info.xdpi));
+	cache.addInfo("ydpi", QString::number(info.ydpi));
+	cache.addInfo("layers", QString::number(info.layers));
+	cache.addInfo("embedded", QString::number(static_cast<int>(info.embedded)));
+	cache.addInfo("profileName", info.profileName);
+	cache.save(image);
+}
+
+QImage ScThumbnailService::generate(const Job& job, ScThumbnailInfo& info)
+{
+	const int size = job.size;
+	QFileInfo fi(job.path);
+	QString ext = fi.suffix().toLower();
+	QStringList allFormatsV = LoadSavePlugin::getExtensionsForPreview(FORMATID_FIRSTUSER);
+	if (allFormatsV.contains(ext.toUtf8()))
+	{
+		FileLoader fileLoader(job.path);
+		int testResult = fileLoader.testFile();
+		if ((testResult == -1) || (testResult < FORMATID_FIRSTUSER))
+			return QImage();
+		const FileFormat * fmt = LoadSavePlugin::getFormatById(testResult);
+		if (!fmt)
+			return QImage();
+		QImage im = fmt->readThumbnail(job.path);
+		if (im.isNull())
+			return QImage();
+		info.width = im.text("XSize").toDouble();
+		info.height = im.text("YSize").toDouble();
+		info.type = 6;
+		info.valid = true;
+		if ((im.width() > (size - 2)) || (im.height() > (size - 2)))
+			return im.scaled(size - 2, size - 2, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+		return im.copy();
+	}
+
+	ScImage image;
+	//no realCMYK
+	bool mode = false;
+	//no document needs to be assigned to this
+	CMSettings cms(nullptr, "", Intent_Perceptual);
+	cms.allowColorManagement(false);
+	cms.setUseEmbeddedProfile(true);
+	if (!image.loadPicture(job.path, 1, cms, ScImage::Thumbnail, 72, &mode))
+		return QImage();
+
+	if ((image.imgInfo.exifDataValid) && (!image.imgInfo.exifInfo.thumbnail.isNull()))
+	{
+		info.width = image.imgInfo.exifInfo.width;
+		info.height = image.imgInfo.exifInfo.height;
+	}
+	else
+	{
+		info.width = image.width();
+		info.height = image.height();
+	}
+	info.type = image.imgInfo.type;
+	info.colorspace = image.imgInfo.colorspace;
+	info.xdpi = image.imgInfo.xres;
+	info.ydpi = image.imgInfo.yres;
+	info.layers = image.imgInfo.layerInfo.size();
+	info.embedded = image.imgInfo.isEmbedded;
+	info.profileName = image.imgInfo.profileName;
+	info.valid = true;
+
+	if ((image.width() > (size - 2)) || (image.height() > (size - 2)))
+		return image.scaled(size - 2, size - 2, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	return image.qImage().copy();
+}
@@ -0,0 +1,129 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCTHUMBNAILSERVICE_H
+#define SCTHUMBNAILSERVICE_H
+
+#include <QImage>
+#include <QList>
+#include <QMetaType>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+#include "scribusapi.h"
+
+/**
+ * \brief Information about the image a thumbnail has been generated from
+ */
+struct SCRIBUS_API ScThumbnailInfo
+{
+	int width { 0 };
+	int height { 0 };
+	int type { 0 };
+	int colorspace { 0 };
+	int xdpi { 72 };
+	int ydpi { 72 };
+	int layers { 0 };
+	bool embedded { false };
+	QString profileName;
+	bool valid { false };
+};
+
+Q_DECLARE_METATYPE(ScThumbnailInfo)
+
+/**
+ * \brief Shared service generating image and document thumbnails in the background
+ *
+ * Requests are queued with a priority and served by a dedicated thread pool,
+ * highest priority first. Clients such as image browsers raise the priority
+ * of the items currently visible and cancel the requests of items which
+ * scrolled away. Generated thumbnails are stored in the image cache managed
+ * by ScImageCacheManager so browsing the same folder again is fast.
+ */
+class SCRIBUS_API ScThumbnailService : public QObject
+{
+	Q_OBJECT
+
+	friend class ScThumbnailWorker;
+
+public:
+	/**
+	* @brief Get thumbnail service instance
+	* @return Pointer to the singleton instance
+	*/
+	static ScThumbnailService* instance();
+	/**
+	* @brief Delete the thumbnail service instance
+	* Waits for the running workers, must be called before the application quits.
+	*/
+	static void deleteInstance();
+
+	/**
+	* @brief Queue a thumbnail request
+	* @param path Full path of the image or document
+	* @param size Size of the square the thumbnail has to fit in
+	* @param priority Requests with higher priority are served first
+	* @return Ticket identifying the request in thumbnailReady()
+	*/
+	int request(const QString& path, int size, int priority = 0);
+	/**
+	* @brief Change the priority of a pending request
+	*/
+	void setPriority(int ticket, int priority);
+	/**
+	* @brief Cancel a request, no result will be delivered for it
+	*/
+	void cancel(int ticket);
+	/**
+	* @brief Cancel several requests at once
+	*/
+	void cancel(const QList<int>& tickets);
+	/**
+	* @brief Number of requests waiting for a worker
+	*/
+	int pendingCount() const;
+
+signals:
+	void thumbnailReady(int ticket, const QString& path, const QImage& image, const ScThumbnailInfo& info);
+
+private slots:
+	void jobFinished(int ticket, const QString& path, int size, const QImage& image, const ScThumbnailInfo& info, bool fromCache);
+
+private:
+	struct Job
+	{
+		int ticket;
+		QString path;
+		int size;
+		int priority;
+	};
+
+	ScThumbnailService();
+	~ScThumbnailService();
+
+	bool takeJob(Job& job);
+	void startWorkers();
+
+	static QImage loadFromCache(const Job& job, ScThumbnailInfo& info);
+	static void saveToCache(const QString& path, int size, const QImage& image, const ScThumbnailInfo& info);
+	static QImage generate(const Job& job, ScThumbnailInfo& info);
+
+	static ScThumbnailService* m_instance;
+
+	QThreadPool m_pool;
+	mutable QMutex m_mutex;
+	QList<Job> m_queue;
+	QSet<int> m_running;
+	QSet<int> m_cancelled;
+	int m_nextTicket { 1 };
+	int m_workers { 0 };
+};
+
+#endif
@@ -178,6 +178,18 @@ bool CharStyle::equivForShaping(const CharStyle& other) const
 	return true;
 }
 
+bool CharStyle::equivValues(const CharStyle& other) const
+{
+	validate();
+	other.validate();
+	return name() == other.name() && parent() == other.parent()
+#define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT, attr_BREAKSHAPING) \
+		&& isequiv(m_##attr_NAME, other.m_##attr_NAME)
+#include "charstyle.attrdefs.cxx"
+#undef ATTRDEF
+		&& m_Effects == other.m_Effects;
+}
+
 QString CharStyle::displayName() const
 {
 	if (isDefaultStyle())
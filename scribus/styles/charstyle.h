@@ -138,6 +138,9 @@ public:
 	
 	bool equiv(const BaseStyle& other) const;
 	bool equivForShaping(const CharStyle &other) const;
+	/** returns true if both styles have the same name and parent and agree on
+		all attribute values, whether these are inherited or not */
+	bool equivValues(const CharStyle &other) const;
 
 	void applyCharStyle(const CharStyle & other);
 	void eraseCharStyle(const CharStyle & other);
@@ -92,6 +92,20 @@ bool ParagraphStyle::equiv(const BaseStyle& other) const
 }	
 
 
+bool ParagraphStyle::equivValues(const ParagraphStyle& other) const
+{
+	validate();
+	other.validate();
+	return name() == other.name() && parent() == other.parent()
+		&& m_cstyle.equivValues(other.m_cstyle)
+#define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
+		&& isequiv(m_##attr_NAME, other.m_##attr_NAME)
+#include "paragraphstyle.attrdefs.cxx"
+#undef ATTRDEF
+		;
+}
+
+
 /* hm... av
 static void updateAutoLinespacing(ParagraphStyle& that)
 {
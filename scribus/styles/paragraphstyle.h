@@ -89,6 +89,9 @@ public:
 	void update(const StyleContext*);
 	
 	bool equiv(const BaseStyle& other) const;
+	/** returns true if both styles have the same name and parent and agree on
+		all attribute values, including those of their charStyle() */
+	bool equivValues(const ParagraphStyle& other) const;
 	
 	void applyStyle(const ParagraphStyle& other);
 	void eraseStyle(const ParagraphStyle& other);
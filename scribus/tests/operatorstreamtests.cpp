@@ -0,0 +1,116 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <limits>
+
+#include <QtTest/QtTest>
+
+#include "operatorstreamtests.h"
+#include "scoperatorstream.h"
+
+namespace
+{
+	// Curve coordinates of a path heavy page, e.g. a map
+	const int pathSegments = 20000;
+
+	double coordinate(int i)
+	{
+		return (i % 5953) * 0.1371 - 17.25;
+	}
+}
+
+void OperatorStreamTests::testFormatNumber_data()
+{
+	QTest::addColumn<double>("value");
+	QTest::addColumn<int>("precision");
+	QTest::addColumn<QByteArray>("expected");
+
+	QTest::newRow("zero") << 0.0 << 5 << QByteArray("0");
+	QTest::newRow("negative zero") << -0.0 << 5 << QByteArray("0");
+	QTest::newRow("rounds to zero") << -0.000001 << 5 << QByteArray("0");
+	QTest::newRow("integer") << 595.0 << 5 << QByteArray("595");
+	QTest::newRow("negative integer") << -842.0 << 5 << QByteArray("-842");
+	QTest::newRow("trailing zeros") << 12.5 << 5 << QByteArray("12.5");
+	QTest::newRow("small") << 0.00042 << 5 << QByteArray("0.00042");
+	QTest::newRow("rounding") << 1.234567 << 5 << QByteArray("1.23457");
+	QTest::newRow("rounding carry") << 9.999999 << 5 << QByteArray("10");
+	QTest::newRow("negative fraction") << -0.25 << 5 << QByteArray("-0.25");
+	QTest::newRow("no exponent") << 1234567.0 << 5 << QByteArray("1234567");
+	QTest::newRow("precision 0") << 2.5 << 0 << QByteArray("3");
+	QTest::newRow("precision 2") << 3.14159 << 2 << QByteArray("3.14");
+	QTest::newRow("precision 12") << 1.0 / 3.0 << 12 << QByteArray("0.333333333333");
+	QTest::newRow("huge") << 1e300 << 5 << QByteArray("9007199254740992");
+	QTest::newRow("not finite") << std::numeric_limits<double>::infinity() << 5 << QByteArray("0");
+}
+
+void OperatorStreamTests::testFormatNumber()
+{
+	QFETCH(double, value);
+	QFETCH(int, precision);
+	QFETCH(QByteArray, expected);
+
+	QCOMPARE(ScOperatorStream::number(value, precision), expected);
+}
+
+void OperatorStreamTests::testRoundTrip()
+{
+	for (int i = 0; i < 10000; ++i)
+	{
+		double value = coordinate(i) / (1 + i % 7);
+		QByteArray text = ScOperatorStream::number(value);
+		QVERIFY(!text.endsWith('0') || !text.contains('.'));
+		QVERIFY(qAbs(text.toDouble() - value) <= 0.0000050001);
+	}
+}
+
+void OperatorStreamTests::testOperators()
+{
+	ScOperatorStream out;
+	out << 10.0 << -20.5;
+	out.op("m");
+	out << 1 << 0.333333;
+	out.op("l");
+	out << "q" << '\n';
+	QCOMPARE(out.data(), QByteArray("10 -20.5 m\n1 0.33333 l\nq\n"));
+
+	QByteArray content = out.take();
+	QVERIFY(out.isEmpty());
+	QCOMPARE(content.size(), 25);
+	out.appendNumber(-7);
+	QCOMPARE(out.data(), QByteArray("-7"));
+}
+
+void OperatorStreamTests::benchmarkPathStream()
+{
+	QBENCHMARK
+	{
+		ScOperatorStream out;
+		for (int i = 0; i < pathSegments; ++i)
+		{
+			out << coordinate(i) << -coordinate(i + 1) << coordinate(i + 2) << -coordinate(i + 3) << coordinate(i + 4) << -coordinate(i + 5);
+			out.op("c");
+		}
+		QVERIFY(out.size() > 0);
+	}
+}
+
+void OperatorStreamTests::benchmarkPathConcatenation()
+{
+	// The way content streams were built before ScOperatorStream, for comparison
+	QBENCHMARK
+	{
+		QByteArray out;
+		for (int i = 0; i < pathSegments; ++i)
+		{
+			out += QByteArray::number(coordinate(i), 'f', 5) + " " + QByteArray::number(-coordinate(i + 1), 'f', 5) + " ";
+			out += QByteArray::number(coordinate(i + 2), 'f', 5) + " " + QByteArray::number(-coordinate(i + 3), 'f', 5) + " ";
+			out += QByteArray::number(coordinate(i + 4), 'f', 5) + " " + QByteArray::number(-coordinate(i + 5), 'f', 5) + " c\n";
+		}
+		QVERIFY(out.size() > 0);
+	}
+}
+
+QTEST_APPLESS_MAIN(OperatorStreamTests)
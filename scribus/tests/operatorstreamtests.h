@@ -0,0 +1,30 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef OPERATORSTREAMTESTS_H
+#define OPERATORSTREAMTESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests and benchmarks for ScOperatorStream.
+ */
+class OperatorStreamTests : public QObject
+{
+	Q_OBJECT
+public:
+	OperatorStreamTests() {}
+
+private slots:
+	void testFormatNumber();
+	void testFormatNumber_data();
+	void testRoundTrip();
+	void testOperators();
+	void benchmarkPathStream();
+	void benchmarkPathConcatenation();
+};
+
+#endif // OPERATORSTREAMTESTS_H
@@ -127,3 +127,112 @@ void TestStoryText::removeCharStyle()
 	QCOMPARE(story.startOfRun(2), 5  + 26 + 1);
 	QCOMPARE(story.endOfRun(2), 11 + 26);
 }
+
+void TestStoryText::largeStory()
+{
+	StoryText story;
+	QString paragraph = QString("Lorem ipsum dolor sit amet, consectetur adipiscing elit.") + SpecialChars::PARSEP;
+	for (int i = 0; i < 1000; ++i)
+		story.insertChars(story.length(), paragraph);
+	QCOMPARE(story.length(), 1000 * paragraph.length());
+	QCOMPARE(story.nrOfParagraphs(), 1000u);
+	// one run per paragraph, not per character
+	QCOMPARE(story.nrOfRuns(), 1000u);
+
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(6, 5, cs);
+	QCOMPARE(story.nrOfRuns(), 1002u);
+	story.eraseCharStyle(6, 5, cs);
+	QCOMPARE(story.nrOfRuns(), 1000u);
+
+	QBENCHMARK {
+		story.insertChars(story.length() / 2, "x");
+	}
+	QCOMPARE(story.nrOfRuns(), 1000u);
+}
+
+void TestStoryText::storyMemory()
+{
+	StoryText story;
+	QString paragraph = QString("Lorem ipsum dolor sit amet, consectetur adipiscing elit.") + SpecialChars::PARSEP;
+	for (int i = 0; i < 1000; ++i)
+		story.insertChars(story.length(), paragraph);
+
+	// Estimated from the size of the structures, heap overhead is not counted.
+	// Before, each char was an ScText of its own, referenced from a QList.
+	const qint64 chars = story.length();
+	const qint64 before = chars * (sizeof(ScText) + sizeof(ScText*));
+	// Now each char takes a QChar and a byte of layout flags, each run an ScText,
+	// its list entry and its start, and each paragraph the position of its parsep.
+	const qint64 after = chars * (sizeof(QChar) + sizeof(char))
+			+ story.nrOfRuns() * (sizeof(ScText) + sizeof(ScText*) + sizeof(int))
+			+ story.nrOfParagraphs() * sizeof(int);
+	// paragraphs of plain text are single runs, their style costs little per char
+	QVERIFY(after * 4 < before);
+	QTest::setBenchmarkResult(double(after) / chars, QTest::BytesAllocated);
+}
+
+void TestStoryText::paragraphQueries()
+{
+	StoryText story;
+	QString paragraph = QString("Lorem ipsum dolor sit amet.") + SpecialChars::PARSEP;
+	for (int i = 0; i < 2000; ++i)
+		story.insertChars(story.length(), paragraph);
+	story.insertChars(story.length(), "trailing");
+	QCOMPARE(story.nrOfParagraphs(), 2001u);
+	QCOMPARE(story.startOfParagraph(1), paragraph.length());
+	QCOMPARE(story.endOfParagraph(0), paragraph.length() - 1);
+	QCOMPARE(story.endOfParagraph(2000), story.length());
+
+	// each query used to scan the text from the start
+	QBENCHMARK {
+		for (uint i = 0; i < 2000; ++i)
+		{
+			int start = story.startOfParagraph(i);
+			QCOMPARE(start, static_cast<int>(i) * paragraph.length());
+			QCOMPARE(story.nrOfParagraph(start), i);
+		}
+	}
+
+	story.removeChars(paragraph.length() - 1, 1);
+	QCOMPARE(story.nrOfParagraphs(), 2000u);
+	QCOMPARE(story.startOfParagraph(1), 2 * paragraph.length() - 1);
+	story.insertChars(5, SpecialChars::PARSEP);
+	QCOMPARE(story.nrOfParagraphs(), 2001u);
+	QCOMPARE(story.nrOfParagraph(6), 1u);
+	QCOMPARE(story.endOfParagraph(0), 5);
+}
+
+void TestStoryText::computedStyles()
+{
+	StoryText story;
+	story.insertChars(0,
+					  QString("0123456789") + SpecialChars::PARSEP +
+					  QString("abcdefghijklmnopqrstuvwxyz") + SpecialChars::PARSEP +
+					  QString("ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(5 + 26 + 1,  26 + 1, cs);
+
+	QCOMPARE(story.computedCharStyle(0).fontSize(), story.charStyle(0).fontSize());
+	QCOMPARE(story.computedCharStyle(5 + 26 + 1).fontSize(), 10.0);
+	// runs with equal values share one computed style
+	QCOMPARE(&story.computedCharStyle(0), &story.computedCharStyle(11 + 26 + 1 + 20));
+	QVERIFY(&story.computedCharStyle(0) != &story.computedCharStyle(5 + 26 + 1));
+
+	cs.setFontSize(20);
+	story.applyCharStyle(0, 1, cs);
+	QCOMPARE(story.computedCharStyle(0).fontSize(), 20.0);
+
+	// nothing changed in the style hierarchy, no layout needs to be invalidated
+	story.invalidateAll();
+	QSignalSpy spy(&story, SIGNAL(changed(int,int)));
+	story.invalidateAll();
+	QCOMPARE(spy.count(), 0);
+
+	ParagraphStyle ps;
+	ps.setLineSpacing(30);
+	story.setDefaultStyle(ps);
+	QCOMPARE(story.computedParagraphStyle(5).lineSpacing(), story.paragraphStyle(5).lineSpacing());
+}
@@ -27,4 +27,8 @@ private slots:
 	void removePars();
 	void applyCharStyle();
 	void removeCharStyle();
+	void largeStory();
+	void storyMemory();
+	void paragraphQueries();
+	void computedStyles();
 };
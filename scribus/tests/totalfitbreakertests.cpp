@@ -0,0 +1,84 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <QtTest/QtTest>
+
+#include "totalfitbreakertests.h"
+#include "text/totalfitbreaker.h"
+
+namespace
+{
+	// words separated by spaces of width 1 which stretch by 1 and shrink by 1/3
+	QVector<TotalFitBreaker::Item> paragraph(const QList<double>& words)
+	{
+		QVector<TotalFitBreaker::Item> items;
+		for (int i = 0; i < words.count(); ++i)
+		{
+			if (i > 0)
+				items.append(TotalFitBreaker::glue(1.0, 1.0, 1.0 / 3.0));
+			items.append(TotalFitBreaker::box(words.at(i)));
+		}
+		items.append(TotalFitBreaker::glue(0.0, TotalFitBreaker::Infinity, 0.0));
+		items.append(TotalFitBreaker::penalty(0.0, -TotalFitBreaker::Infinity));
+		return items;
+	}
+}
+
+void TotalFitBreakerTests::testOptimalBreaks()
+{
+	// Filling lines one by one gives "6 2 7 / 8 3 3 4 / 7 4 / 8", where the
+	// third line would have to stretch its only space by 8.
+	QVector<TotalFitBreaker::Item> items = paragraph(QList<double>() << 6 << 2 << 7 << 8 << 3 << 3 << 4 << 7 << 4 << 8);
+	TotalFitBreaker breaker(20.0, 20.0);
+	QVector<int> breaks = breaker.breaks(items);
+	QCOMPARE(breaks, QVector<int>() << 5 << 11 << 17 << items.count() - 1);
+
+	// stricter tolerance can't be met
+	TotalFitBreaker strict(20.0, 20.0, 1.0);
+	QVERIFY(strict.breaks(items).isEmpty());
+}
+
+void TotalFitBreakerTests::testLegalBreaks()
+{
+	QList<double> words;
+	for (int i = 0; i < 60; ++i)
+		words << 2 + (i * 7) % 6;
+	QVector<TotalFitBreaker::Item> items = paragraph(words);
+	TotalFitBreaker breaker(25.0, 30.0);
+	QVector<int> breaks = breaker.breaks(items);
+	QVERIFY(breaks.count() > 1);
+	QCOMPARE(breaks.last(), items.count() - 1);
+	for (int i = 0; i < breaks.count(); ++i)
+	{
+		const TotalFitBreaker::Item& item = items.at(breaks.at(i));
+		QVERIFY(item.type != TotalFitBreaker::Item::Box);
+		if (item.type == TotalFitBreaker::Item::Glue)
+			QCOMPARE(items.at(breaks.at(i) - 1).type, TotalFitBreaker::Item::Box);
+		if (i > 0)
+			QVERIFY(breaks.at(i) > breaks.at(i - 1));
+	}
+}
+
+void TotalFitBreakerTests::testInfeasible()
+{
+	// a word wider than the line
+	QVector<TotalFitBreaker::Item> items = paragraph(QList<double>() << 6 << 2 << 25 << 3);
+	TotalFitBreaker breaker(20.0, 20.0);
+	QVERIFY(breaker.breaks(items).isEmpty());
+	QVERIFY(breaker.breaks(QVector<TotalFitBreaker::Item>()).isEmpty());
+}
+
+void TotalFitBreakerTests::testKey()
+{
+	QVector<TotalFitBreaker::Item> items = paragraph(QList<double>() << 6 << 2 << 7 << 8);
+	QVector<TotalFitBreaker::Item> other = paragraph(QList<double>() << 6 << 2 << 7 << 9);
+	TotalFitBreaker breaker(20.0, 20.0);
+	QCOMPARE(breaker.key(items), TotalFitBreaker(20.0, 20.0).key(items));
+	QVERIFY(breaker.key(items) != breaker.key(other));
+	QVERIFY(breaker.key(items) != TotalFitBreaker(18.0, 20.0).key(items));
+}
+
+QTEST_APPLESS_MAIN(TotalFitBreakerTests)
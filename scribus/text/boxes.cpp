@@ -228,6 +228,15 @@ void LineBox::render(TextLayoutPainter *p) const
 
 void LineBox::render(ScreenPainter *p, ITextContext *ctx) const
 {
+	// Lines outside of the clip region are skipped, glyphs on a path are placed
+	// by their own matrix and can be anywhere.
+	if (type() != T_PathLine)
+	{
+		double extent = height() + naturalAsc();
+		if (!p->isVisible(QRectF(x(), y(), width(), height()).adjusted(-extent, -extent, extent, extent)))
+			return;
+	}
+
 	p->translate(x(), y());
 
 	drawBackGround(p);
@@ -8,7 +8,10 @@
 #ifndef BOXES_H
 #define BOXES_H
 
-#include <QObject>
+#include <QLineF>
+#include <QList>
+#include <QRectF>
+#include <QTransform>
 
 #include "glyphcluster.h"
 #include "sctextstruct.h"
@@ -24,10 +27,10 @@ class ScreenPainter;
  Scribus packs glyph runs into GlyphBoxes, GlyphBoxes and ObjectBoxes into LineBoxes
  and LineBoxes into GroupBox(T_Block).
  (and in the future: math atoms, tables & table cells, ...)
+ Boxes are plain objects, not QObjects: a layout creates one box per glyph
+ cluster and QObject would add a private allocation to each of them.
  */
-class Box: public QObject {
-	Q_OBJECT
-
+class Box {
 public:
 	enum BoxType {
 		T_Invalid,
@@ -168,7 +171,6 @@ protected:
 
 class GroupBox: public Box
 {
-	Q_OBJECT
 public:
 	GroupBox(BoxDirection direction)
 	{
@@ -208,7 +210,6 @@ private:
 
 class LineBox: public GroupBox
 {
-	Q_OBJECT
 public:
 	LineBox()
 		: GroupBox(D_Horizontal)
@@ -240,7 +241,6 @@ protected:
 
 class PathLineBox: public LineBox
 {
-	Q_OBJECT
 public:
 	PathLineBox()
 	{
@@ -254,7 +254,6 @@ protected:
 
 class GlyphBox: public Box
 {
-	Q_OBJECT
 public:
 	GlyphBox(const GlyphCluster& run)
 		: m_glyphRun(run)
@@ -286,7 +285,6 @@ protected:
 
 class ObjectBox: public GlyphBox
 {
-	Q_OBJECT
 public:
 	ObjectBox(const GlyphCluster& run, ITextContext* ctx)
 		: GlyphBox(run)
@@ -0,0 +1,87 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef COMPUTEDSTYLES_H
+#define COMPUTEDSTYLES_H
+
+#include <QHash>
+#include <QList>
+
+#include "styles/charstyle.h"
+#include "styles/paragraphstyle.h"
+
+
+inline uint computedStyleHash(const CharStyle& style)
+{
+	return qHash(style.font().scName()) ^ qHash(style.fontSize()) ^ qHash(style.fillColor());
+}
+
+inline uint computedStyleHash(const ParagraphStyle& style)
+{
+	return qHash(style.lineSpacing()) ^ qHash(static_cast<int>(style.alignment())) ^ computedStyleHash(style.charStyle());
+}
+
+/// makes a copy independent of the style hierarchy
+inline void detachComputedStyle(CharStyle& style)
+{
+	style.setContext(nullptr);
+}
+
+inline void detachComputedStyle(ParagraphStyle& style)
+{
+	style.setContext(nullptr);
+	style.charStyle().setContext(nullptr);
+}
+
+
+/**
+   Interned table of computed styles.
+
+   An entry is a copy of a style with all inherited attributes resolved and
+   without a StyleContext, so its getters never have to validate against the
+   style hierarchy. Styles with equal values share one entry, so comparing
+   indices is comparing values.
+
+   Entries are never removed: layouts keep pointers to them. The table only
+   grows with the number of distinct styles used in a story.
+ */
+template<class STYLE>
+class ComputedStyleTable
+{
+public:
+	ComputedStyleTable() {}
+	~ComputedStyleTable() { qDeleteAll(m_entries); }
+
+	int count() const { return m_entries.count(); }
+	const STYLE& at(int index) const { return *m_entries.at(index); }
+
+	/// returns the index of the entry with the values of style, adding one if needed
+	int intern(const STYLE& style)
+	{
+		style.validate();
+		uint key = computedStyleHash(style);
+		typename QHash<uint, int>::const_iterator it = m_lookup.constFind(key);
+		for (; it != m_lookup.constEnd() && it.key() == key; ++it)
+		{
+			if (m_entries.at(it.value())->equivValues(style))
+				return it.value();
+		}
+		STYLE* entry = new STYLE(style);
+		detachComputedStyle(*entry);
+		m_entries.append(entry);
+		m_lookup.insertMulti(key, m_entries.count() - 1);
+		return m_entries.count() - 1;
+	}
+
+private:
+	Q_DISABLE_COPY(ComputedStyleTable)
+
+	QList<STYLE*> m_entries;
+	QHash<uint, int> m_lookup;
+};
+
+#endif // COMPUTEDSTYLES_H
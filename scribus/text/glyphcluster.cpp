@@ -85,12 +85,12 @@ void GlyphCluster::clearFlag(LayoutFlags f)
 	m_flags = static_cast<LayoutFlags>(m_flags & ~f);
 }
 
-QList<GlyphLayout>& GlyphCluster::glyphs()
+QVector<GlyphLayout>& GlyphCluster::glyphs()
 {
 	return m_glyphs;
 }
 
-const QList<GlyphLayout>& GlyphCluster::glyphs() const {
+const QVector<GlyphLayout>& GlyphCluster::glyphs() const {
 	return m_glyphs;
 }
 
@@ -1,7 +1,7 @@
 #ifndef GLYPHRUN_H
 #define GLYPHRUN_H
 
-#include <QList>
+#include <QVector>
 
 #include "scribusapi.h"
 #include "sctextstruct.h"
@@ -18,8 +18,8 @@ public:
 	void setFlag(LayoutFlags f);
 	void clearFlag(LayoutFlags f);
 
-	QList<GlyphLayout>& glyphs();
-	const QList<GlyphLayout>& glyphs() const;
+	QVector<GlyphLayout>& glyphs();
+	const QVector<GlyphLayout>& glyphs() const;
 	const InlineFrame& object() const;
 
 	int firstChar() const;
@@ -49,7 +49,7 @@ public:
 private:
 	const CharStyle* m_style;
 	LayoutFlags m_flags;
-	QList<GlyphLayout> m_glyphs;
+	QVector<GlyphLayout> m_glyphs;
 	InlineFrame m_object;
 	int m_firstChar;
 	int m_lastChar;
@@ -0,0 +1,209 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "layoutprofiler.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+
+
+QAtomicInt LayoutProfiler::s_enabled(0);
+
+
+static bool slowerFrame(const LayoutProfiler::FrameProfile& a, const LayoutProfiler::FrameProfile& b)
+{
+	return a.total > b.total;
+}
+
+static QString milliseconds(qint64 nsecs)
+{
+	return QString::number(nsecs / 1000000.0, 'f', 2);
+}
+
+
+LayoutProfiler::FrameProfile::FrameProfile() :
+	id(0),
+	page(0),
+	layouts(0),
+	lines(0),
+	total(0)
+{
+	for (int i = 0; i < PhaseCount; ++i)
+		phases[i] = 0;
+}
+
+
+LayoutProfiler::LayoutProfiler() :
+	m_lastId(0)
+{
+	for (int i = 0; i < PhaseCount; ++i)
+		m_phases[i] = 0;
+}
+
+LayoutProfiler& LayoutProfiler::instance()
+{
+	static LayoutProfiler profiler;
+	return profiler;
+}
+
+void LayoutProfiler::setEnabled(bool enabled)
+{
+	s_enabled.store(enabled ? 1 : 0);
+}
+
+void LayoutProfiler::reset()
+{
+	QMutexLocker locker(&m_mutex);
+	m_frames.clear();
+	for (int i = 0; i < PhaseCount; ++i)
+		m_phases[i] = 0;
+	for (int i = 0; i < LookupCount; ++i)
+		m_lookups[i] = Lookups();
+}
+
+void LayoutProfiler::beginFrame(const void* frame, const QString& name, int page)
+{
+	QMutexLocker locker(&m_mutex);
+	FrameProfile& profile = m_frames[frame];
+	if (profile.id == 0)
+		profile.id = ++m_lastId;
+	profile.name = name;
+	profile.page = page;
+
+	Layout layout;
+	layout.frame = frame;
+	layout.nested = 0;
+	for (int i = 0; i < PhaseCount; ++i)
+		layout.phases[i] = 0;
+	layout.paragraph = -1;
+	layout.paragraphStart = 0;
+	layout.timer.start();
+	m_layouts.localData().append(layout);
+	// paragraphs of the last layout only
+	profile.paragraphs.clear();
+}
+
+void LayoutProfiler::removeFrame(const void* frame)
+{
+	// a new frame may be allocated at the same address
+	QMutexLocker locker(&m_mutex);
+	m_frames.remove(frame);
+}
+
+void LayoutProfiler::beginParagraph(int firstChar)
+{
+	QMutexLocker locker(&m_mutex);
+	QVector<Layout>& layouts = m_layouts.localData();
+	if (layouts.isEmpty())
+		return;
+	Layout& layout = layouts.last();
+	qint64 now = layout.timer.nsecsElapsed();
+	endParagraph(layout, now);
+	layout.paragraph = firstChar;
+	layout.paragraphStart = now;
+}
+
+void LayoutProfiler::endParagraph(Layout& layout, qint64 now)
+{
+	if (layout.paragraph < 0)
+		return;
+	m_frames[layout.frame].paragraphs[layout.paragraph] += now - layout.paragraphStart;
+	layout.paragraph = -1;
+}
+
+void LayoutProfiler::endFrame(int lines)
+{
+	QMutexLocker locker(&m_mutex);
+	QVector<Layout>& layouts = m_layouts.localData();
+	if (layouts.isEmpty())
+		return;
+	Layout layout = layouts.takeLast();
+	qint64 elapsed = layout.timer.nsecsElapsed();
+	endParagraph(layout, elapsed);
+	if (!layouts.isEmpty())
+		layouts.last().nested += elapsed;
+
+	// breaking is whatever was not measured separately
+	qint64 own = elapsed - layout.nested;
+	layout.phases[Breaking] = qMax(qint64(0), own - layout.phases[Shaping] - layout.phases[Boxes]);
+
+	FrameProfile& profile = m_frames[layout.frame];
+	profile.layouts += 1;
+	profile.lines = lines;
+	profile.total += own;
+	for (int i = 0; i < PhaseCount; ++i)
+	{
+		profile.phases[i] += layout.phases[i];
+		m_phases[i] += layout.phases[i];
+	}
+}
+
+void LayoutProfiler::addTime(Phase phase, qint64 nsecs)
+{
+	QMutexLocker locker(&m_mutex);
+	QVector<Layout>& layouts = m_layouts.localData();
+	if (phase == Hyphenation || layouts.isEmpty())
+		m_phases[phase] += nsecs;
+	else
+		layouts.last().phases[phase] += nsecs;
+}
+
+void LayoutProfiler::countLookup(Lookup lookup, bool hit)
+{
+	QMutexLocker locker(&m_mutex);
+	if (hit)
+		m_lookups[lookup].hits += 1;
+	else
+		m_lookups[lookup].misses += 1;
+}
+
+QList<LayoutProfiler::FrameProfile> LayoutProfiler::frames() const
+{
+	QMutexLocker locker(&m_mutex);
+	QList<FrameProfile> result = m_frames.values();
+	locker.unlock();
+	std::stable_sort(result.begin(), result.end(), slowerFrame);
+	return result;
+}
+
+qint64 LayoutProfiler::time(Phase phase) const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_phases[phase];
+}
+
+LayoutProfiler::Lookups LayoutProfiler::lookups(Lookup lookup) const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_lookups[lookup];
+}
+
+QString LayoutProfiler::report(int maxFrames) const
+{
+	QString result;
+	result += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+			.arg("frame", -24).arg("page", 5).arg("layouts", 8).arg("lines", 6)
+			.arg("total ms", 10).arg("shaping", 10).arg("breaking", 10).arg("boxes", 10);
+	QList<FrameProfile> profiles = frames();
+	for (int i = 0; i < profiles.count() && i < maxFrames; ++i)
+	{
+		const FrameProfile& profile = profiles.at(i);
+		result += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+				.arg(profile.name.left(24), -24).arg(profile.page, 5).arg(profile.layouts, 8).arg(profile.lines, 6)
+				.arg(milliseconds(profile.total), 10).arg(milliseconds(profile.phases[Shaping]), 10)
+				.arg(milliseconds(profile.phases[Breaking]), 10).arg(milliseconds(profile.phases[Boxes]), 10);
+	}
+	result += QString("\nhyphenation: %1 ms\n").arg(milliseconds(time(Hyphenation)));
+	const char* lookupNames[LookupCount] = { "shaped text cache", "total-fit break cache", "hyphenated words" };
+	for (int i = 0; i < LookupCount; ++i)
+	{
+		Lookups counts = lookups(static_cast<Lookup>(i));
+		result += QString("%1: %2 hits, %3 misses (%4%)\n").arg(lookupNames[i]).arg(counts.hits).arg(counts.misses)
+				.arg(counts.hitRate() * 100.0, 0, 'f', 1);
+	}
+	return result;
+}
@@ -0,0 +1,158 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef LAYOUTPROFILER_H
+#define LAYOUTPROFILER_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QThreadStorage>
+#include <QVector>
+
+#include "scribusapi.h"
+
+/**
+   Records where text layout spends its time.
+
+   Frames report each layout with beginFrame() and endFrame(). In between,
+   the time of the phases measured with LayoutProfileTimer and of each
+   paragraph is added to the frame being laid out; the rest of the layout
+   counts as breaking. Lookups of the caches used by layout are counted
+   globally.
+
+   Profiling is off by default, callers check isEnabled() before measuring
+   so the cost is a single test then. All methods may be called from any
+   thread, each thread has its own stack of layouts in progress.
+ */
+class SCRIBUS_API LayoutProfiler
+{
+public:
+	enum Phase
+	{
+		Shaping,     //!< TextShaper
+		Breaking,    //!< placing glyphs and finding line breaks
+		Boxes,       //!< creating the boxes of finished lines
+		Hyphenation, //!< looking up hyphenation points, not part of layout
+		PhaseCount
+	};
+
+	enum Lookup
+	{
+		ShapedTextLookup,  //!< ShapedTextCache
+		TotalFitLookup,    //!< TotalFitBreakCache
+		HyphenationLookup, //!< words hyphenated before
+		LookupCount
+	};
+
+	struct Lookups
+	{
+		Lookups() : hits(0), misses(0) {}
+		double hitRate() const { return (hits + misses > 0) ? double(hits) / (hits + misses) : 0.0; }
+
+		qint64 hits;
+		qint64 misses;
+	};
+
+	struct FrameProfile
+	{
+		FrameProfile();
+
+		int id;                        //!< identifies the frame as long as it exists
+		QString name;
+		int page;                      //!< page number starting at 1, 0 if not on a page
+		int layouts;                   //!< number of times the frame was laid out
+		int lines;                     //!< lines of the last layout
+		qint64 total;                  //!< nanoseconds in all layouts
+		qint64 phases[PhaseCount];     //!< nanoseconds in all layouts by phase
+		QMap<int, qint64> paragraphs;  //!< nanoseconds by first char of paragraph in the last layout
+	};
+
+	static LayoutProfiler& instance();
+
+	static bool isEnabled() { return s_enabled.load() != 0; }
+	void setEnabled(bool enabled);
+	/// forgets everything recorded
+	void reset();
+
+	/// frame is only used to identify the frame, the layout of frames may nest
+	void beginFrame(const void* frame, const QString& name, int page);
+	/// forgets the profile of a frame about to be deleted
+	void removeFrame(const void* frame);
+	/// the paragraph starting at firstChar is laid out next
+	void beginParagraph(int firstChar);
+	void endFrame(int lines);
+	void addTime(Phase phase, qint64 nsecs);
+	void countLookup(Lookup lookup, bool hit);
+
+	/// profiles of all frames laid out, slowest first
+	QList<FrameProfile> frames() const;
+	/// nanoseconds of all frames by phase
+	qint64 time(Phase phase) const;
+	Lookups lookups(Lookup lookup) const;
+	/// a plain text table of the slowest frames and the cache hit rates
+	QString report(int maxFrames = 20) const;
+
+private:
+	LayoutProfiler();
+	Q_DISABLE_COPY(LayoutProfiler)
+
+	/// a layout in progress
+	struct Layout
+	{
+		const void* frame;
+		QElapsedTimer timer;
+		qint64 nested;              //!< nanoseconds of layouts of other frames meanwhile
+		qint64 phases[PhaseCount];
+		int paragraph;
+		qint64 paragraphStart;
+	};
+
+	void endParagraph(Layout& layout, qint64 now);
+
+	static QAtomicInt s_enabled;
+
+	mutable QMutex m_mutex;
+	QHash<const void*, FrameProfile> m_frames;
+	int m_lastId;
+	QThreadStorage<QVector<Layout> > m_layouts;
+	qint64 m_phases[PhaseCount];
+	Lookups m_lookups[LookupCount];
+};
+
+
+/**
+   Adds the time of its lifetime to a phase of the layout in progress.
+ */
+class LayoutProfileTimer
+{
+public:
+	explicit LayoutProfileTimer(LayoutProfiler::Phase phase) : m_phase(phase), m_active(LayoutProfiler::isEnabled())
+	{
+		if (m_active)
+			m_timer.start();
+	}
+
+	~LayoutProfileTimer()
+	{
+		if (m_active)
+			LayoutProfiler::instance().addTime(m_phase, m_timer.nsecsElapsed());
+	}
+
+private:
+	Q_DISABLE_COPY(LayoutProfileTimer)
+
+	LayoutProfiler::Phase m_phase;
+	bool m_active;
+	QElapsedTimer m_timer;
+};
+
+#endif // LAYOUTPROFILER_H
@@ -25,6 +25,7 @@ ScreenPainter::ScreenPainter(ScPainter *p, PageItem *item)
 	, m_strokeColor("", -1)
 	, m_cairoFace(nullptr)
 	, m_faceIndex(-10) // ScFace::faceIndex() defaults to -1, we need a different value
+	, m_deviceClipValid(false)
 {
 	m_painter->save();
 
@@ -39,6 +40,7 @@ ScreenPainter::ScreenPainter(ScPainter *p, PageItem *item)
 
 ScreenPainter::~ScreenPainter()
 {
+	flushGlyphs();
 	if (m_cairoFace != nullptr)
 		cairo_font_face_destroy(m_cairoFace);
 	m_painter->restore();
@@ -51,18 +53,11 @@ void ScreenPainter::drawGlyph(const GlyphCluster& gc)
 #if CAIRO_HAS_FC_FONT
 	if (m_painter->fillMode() == 1 && m_painter->maskMode() <= 0 && !showControls)
 	{
-		m_painter->save();
-
-		setupState(false);
-
-		cairo_t* cr = m_painter->context();
-		double r, g, b;
-		m_painter->brush().getRgbF(&r, &g, &b);
-		cairo_set_source_rgba(cr, r, g, b, m_painter->brushOpacity());
-		m_painter->setRasterOp(m_painter->blendModeFill());
-
 		if (m_fontPath != font().fontFilePath() || m_faceIndex != font().faceIndex() || m_cairoFace == nullptr)
 		{
+			flushGlyphs();
+			if (m_cairoFace != nullptr)
+				cairo_font_face_destroy(m_cairoFace);
 			m_fontPath = font().fontFilePath();
 			m_faceIndex = font().faceIndex();
 			// A very ugly hack as we can’t use the font().ftFace() because
@@ -78,20 +73,61 @@ void ScreenPainter::drawGlyph(const GlyphCluster& gc)
 			FcPatternDestroy(pattern);
 		}
 
-		cairo_set_font_face(cr, m_cairoFace);
-		cairo_set_font_size(cr, fontSize());
+		// The transformation setupState() would apply, without touching the painter
+		QTransform ctm = m_painter->worldMatrix();
+		ctm.translate(x(), y());
+		if (scaleH() != 1.0 || scaleV() != 1.0)
+			ctm.scale(scaleH(), scaleV());
+		if (matrix() != QTransform())
+			ctm = matrix() * ctm;
+
+		QColor color;
+		if (selected())
+			color = qApp->palette().color(QPalette::Active, QPalette::HighlightedText);
+		else
+		{
+			updateColors();
+			color = m_fillQColor;
+		}
+		double opacity = m_painter->brushOpacity();
+		int blendMode = m_painter->blendModeFill();
 
+		const QRectF clip = deviceClip();
 		double current_x = 0.0;
-		for (const GlyphLayout& gl : gc.glyphs()) {
-			cairo_scale(cr, gl.scaleH, gl.scaleV);
-			cairo_glyph_t glyph = { gl.glyph, gl.xoffset + current_x, gl.yoffset };
-			cairo_show_glyphs(cr, &glyph, 1);
+		for (const GlyphLayout& gl : gc.glyphs())
+		{
+			QTransform glyphMatrix = ctm;
+			glyphMatrix.scale(gl.scaleH, gl.scaleV);
+			QPointF devicePos = glyphMatrix.map(QPointF(gl.xoffset + current_x, gl.yoffset));
 			current_x += gl.xadvance;
+
+			// glyphs outside of the clip region are skipped, allowing for two ems of extent
+			QTransform linear(glyphMatrix.m11(), glyphMatrix.m12(), glyphMatrix.m21(), glyphMatrix.m22(), 0, 0);
+			double extent = 2 * fontSize() * qMax(qAbs(linear.m11()) + qAbs(linear.m21()), qAbs(linear.m12()) + qAbs(linear.m22()));
+			if (!clip.adjusted(-extent, -extent, extent, extent).contains(devicePos))
+				continue;
+			if (!linear.isInvertible())
+				continue;
+
+			if (m_batch.face != m_cairoFace || m_batch.fontSize != fontSize() || m_batch.color != color
+				|| m_batch.opacity != opacity || m_batch.blendMode != blendMode || m_batch.matrix != linear)
+			{
+				flushGlyphs();
+				m_batch.face = m_cairoFace;
+				m_batch.fontSize = fontSize();
+				m_batch.color = color;
+				m_batch.opacity = opacity;
+				m_batch.blendMode = blendMode;
+				m_batch.matrix = linear;
+			}
+			QPointF pos = linear.inverted().map(devicePos);
+			cairo_glyph_t glyph = { gl.glyph, pos.x(), pos.y() };
+			m_batch.glyphs.append(glyph);
 		}
-		m_painter->restore();
 		return;
 	}
 #endif
+	flushGlyphs();
 	m_painter->save();
 
 	setupState(false);
@@ -215,7 +251,7 @@ void ScreenPainter::drawGlyph(const GlyphCluster& gc)
 	{
 		double sizeFactor = fontSize() / 10.0;
 		QVector<FPointArray> outlines = gc.glyphClusterOutline();
-		const QList<GlyphLayout>& glyphs = gc.glyphs();
+		const QVector<GlyphLayout>& glyphs = gc.glyphs();
 		for (int i = 0; i < glyphs.count(); ++i)
 		{
 			const FPointArray& outline = outlines.at(i);
@@ -239,6 +275,7 @@ void ScreenPainter::drawGlyphOutline(const GlyphCluster& gc, bool fill)
 {
 	if (fill)
 		drawGlyph(gc);
+	flushGlyphs();
 	m_painter->save();
 	bool fr = m_painter->fillRule();
 	m_painter->setFillRule(false);
@@ -272,6 +309,7 @@ void ScreenPainter::drawGlyphOutline(const GlyphCluster& gc, bool fill)
 
 void ScreenPainter::drawLine(QPointF start, QPointF end)
 {
+	flushGlyphs();
 	m_painter->save();
 	setupState(false);
 	m_painter->drawLine(start, end);
@@ -280,6 +318,7 @@ void ScreenPainter::drawLine(QPointF start, QPointF end)
 
 void ScreenPainter::drawRect(QRectF rect)
 {
+	flushGlyphs();
 	m_painter->save();
 	setupState(true);
 	m_painter->drawRect(rect.x(), rect.y(), rect.width(), rect.height());
@@ -294,6 +333,7 @@ void ScreenPainter::drawObject(PageItem* embedded)
 	if (!m_item->m_Doc->DoDrawing)
 		return;
 
+	flushGlyphs();
 	m_painter->save();
 	setupState(false);
 
@@ -347,6 +387,8 @@ void ScreenPainter::drawObject(PageItem* embedded)
 
 void ScreenPainter::clip(QRectF rect)
 {
+	flushGlyphs();
+	m_deviceClipValid = false;
 	m_painter->newPath();
 	m_painter->moveTo(rect.x() + x(), y());
 	m_painter->lineTo(rect.x() + x() + rect.width(), y());
@@ -358,14 +400,61 @@ void ScreenPainter::clip(QRectF rect)
 
 void ScreenPainter::saveState()
 {
+	flushGlyphs();
 	m_painter->save();
 }
 
 void ScreenPainter::restoreState()
 {
+	flushGlyphs();
+	m_deviceClipValid = false;
 	m_painter->restore();
 }
 
+bool ScreenPainter::isVisible(const QRectF& rect)
+{
+	QRectF deviceRect = m_painter->worldMatrix().mapRect(rect.translated(x(), y()));
+	return deviceClip().intersects(deviceRect);
+}
+
+void ScreenPainter::flushGlyphs()
+{
+	if (m_batch.glyphs.isEmpty())
+		return;
+
+	cairo_t* cr = m_painter->context();
+	cairo_save(cr);
+	cairo_matrix_t matrix;
+	cairo_matrix_init(&matrix, m_batch.matrix.m11(), m_batch.matrix.m12(), m_batch.matrix.m21(), m_batch.matrix.m22(), 0, 0);
+	cairo_set_matrix(cr, &matrix);
+	double r, g, b;
+	m_batch.color.getRgbF(&r, &g, &b);
+	cairo_set_source_rgba(cr, r, g, b, m_batch.opacity);
+	m_painter->setRasterOp(m_batch.blendMode);
+	cairo_set_font_face(cr, m_batch.face);
+	cairo_set_font_size(cr, m_batch.fontSize);
+	cairo_show_glyphs(cr, m_batch.glyphs.constData(), m_batch.glyphs.count());
+	cairo_restore(cr);
+
+	m_batch.glyphs.resize(0);
+}
+
+QRectF ScreenPainter::deviceClip()
+{
+	if (!m_deviceClipValid)
+	{
+		cairo_t* cr = m_painter->context();
+		double x1, y1, x2, y2;
+		cairo_save(cr);
+		cairo_identity_matrix(cr);
+		cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+		cairo_restore(cr);
+		m_deviceClip = QRectF(QPointF(x1, y1), QPointF(x2, y2));
+		m_deviceClipValid = true;
+	}
+	return m_deviceClip;
+}
+
 void ScreenPainter::setupState(bool rect)
 {
 	if (selected() && rect)
@@ -384,19 +473,7 @@ void ScreenPainter::setupState(bool rect)
 	}
 	else
 	{
-		QColor tmp;
-		if (m_fillColor != fillColor())
-		{
-			m_item->SetQColor(&tmp, fillColor().color, fillColor().shade);
-			m_fillQColor = tmp;
-			m_fillColor = fillColor();
-		}
-		if (m_strokeColor != strokeColor())
-		{
-			m_item->SetQColor(&tmp, strokeColor().color, strokeColor().shade);
-			m_fillStrokeQColor = tmp;
-			m_strokeColor = strokeColor();
-		}
+		updateColors();
 		m_painter->setBrush(m_fillQColor);
 		m_painter->setPen(m_fillStrokeQColor, strokeWidth(), Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
 	}
@@ -410,3 +487,20 @@ void ScreenPainter::setupState(bool rect)
 		m_painter->setWorldMatrix(matrix() * m_painter->worldMatrix());
 	}
 }
+
+void ScreenPainter::updateColors()
+{
+	QColor tmp;
+	if (m_fillColor != fillColor())
+	{
+		m_item->SetQColor(&tmp, fillColor().color, fillColor().shade);
+		m_fillQColor = tmp;
+		m_fillColor = fillColor();
+	}
+	if (m_strokeColor != strokeColor())
+	{
+		m_item->SetQColor(&tmp, strokeColor().color, strokeColor().shade);
+		m_fillStrokeQColor = tmp;
+		m_strokeColor = strokeColor();
+	}
+}
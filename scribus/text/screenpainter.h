@@ -10,6 +10,11 @@
 
 #include <cairo.h>
 
+#include <QColor>
+#include <QRectF>
+#include <QTransform>
+#include <QVector>
+
 #include "textlayoutpainter.h"
 
 class ScPainter;
@@ -30,8 +35,33 @@ public:
 	void saveState();
 	void restoreState();
 
+	/// Whether rect, relative to the current position, intersects the clip region.
+	bool isVisible(const QRectF& rect);
+	/// Draws the glyphs collected by drawGlyph().
+	void flushGlyphs();
+
 private:
+	/**
+	 * Consecutive glyphs with the same face, size, colour and linear
+	 * transformation, drawn with a single cairo_show_glyphs() call.
+	 * Glyph positions are in the user space of the linear transformation.
+	 */
+	struct GlyphBatch
+	{
+		cairo_font_face_t *face;
+		double fontSize;
+		QColor color;
+		double opacity;
+		int blendMode;
+		QTransform matrix;
+		QVector<cairo_glyph_t> glyphs;
+
+		GlyphBatch() : face(nullptr), fontSize(0), opacity(1.0), blendMode(0) {}
+	};
+
 	void setupState(bool rect);
+	void updateColors();
+	QRectF deviceClip();
 
 	ScPainter *m_painter;
 	PageItem *m_item;
@@ -42,6 +72,9 @@ private:
 	cairo_font_face_t *m_cairoFace;
 	QString m_fontPath;
 	int m_faceIndex;
+	GlyphBatch m_batch;
+	QRectF m_deviceClip;
+	bool m_deviceClipValid;
 };
 
 #endif // SCREENPAINTER_H
@@ -5,9 +5,11 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <algorithm>
 #include <cassert>  //added to make Fedora-5 happy
 
 //#include <QDebug>
+#include <QAtomicInt>
 
 #include "fpoint.h"
 #include "scfonts.h"
@@ -16,9 +18,18 @@ for which a new license (GPL+exception) is in place.
 #include "sctext_shared.h"
 #include "util.h"
 
+static QAtomicInt sharedCount;
+
+static quint64 newVersion()
+{
+	return static_cast<quint64>(static_cast<uint>(sharedCount.fetchAndAddRelaxed(1))) << 32;
+}
+
 ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
 	pstyleContext(nullptr),
-	refs(1), len(0), cursorPosition(0)
+	refs(1), len(0), cursorPosition(0),
+	version(newVersion()),
+	m_trailingComputed(-1)
 {
 	pstyleContext.setDefaultStyle( & defaultStyle );
 	defaultStyle.setContext( pstyles );
@@ -32,33 +43,29 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) :
 	defaultStyle(other.defaultStyle), 
 	pstyleContext(other.pstyleContext),
 	refs(1), len(0), cursorPosition(other.cursorPosition),
-	trailingStyle(other.trailingStyle)
+	trailingStyle(other.trailingStyle),
+	version(newVersion()),
+	m_trailingComputed(-1)
 {
 	pstyleContext.setDefaultStyle( &defaultStyle );
 	trailingStyle.setContext( &pstyleContext );
-	QListIterator<ScText*> it( other );
-	ScText* elem;
-	while ( it.hasNext() ) {
-		elem = it.next();
-		ScText* elem2 = new ScText(*elem);
-		append(elem2);
-		if (elem2->parstyle) {
-			elem2->parstyle->setContext( & pstyleContext);
-//				elem2->parstyle->charStyle().setContext( defaultStyle.charStyleContext() );
-			replaceCharStyleContextInParagraph(count()-1, elem2->parstyle->charStyleContext());
-		}
-	}
-	len = count();
+	copyRuns(other);
 	replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext() );
 //		qDebug() << QString("ScText_Shared(%2) %1").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 }
 
 void ScText_Shared::clear()
 {
-	while (!this->isEmpty())
-		delete this->takeFirst(); 
-	QList<ScText*>::clear();
+	qDeleteAll(m_runs);
+	m_runs.clear();
+	m_runStarts.clear();
+	m_text.clear();
+	m_flags.clear();
+	m_parseps.clear();
+	len = 0;
 	cursorPosition = 0;
+	m_trailingComputed = -1;
+	touch();
 }
 
 ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other) 
@@ -72,22 +79,7 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 		defaultStyle.setContext( other.defaultStyle.context() );
 		trailingStyle.setContext( &pstyleContext );
 		clear();
-		QListIterator<ScText*> it( other );
-		ScText* elem;
-		while ( it.hasNext() ) {
-			elem = it.next();
-			ScText* elem2 = new ScText(*elem);
-			append(elem2);
-			if (elem2->parstyle) {
-				elem2->parstyle->setContext( & pstyleContext );
-//					qDebug() << QString("StoryText::copy: * %1 align=%2").arg(elem2->parstyle->parent())
-//						   .arg(elem2->parstyle->alignment())
-//						   .arg((uint)elem2->parstyle->context()));
-					//				elem2->parstyle->charStyle().setContext( defaultStyle.charStyleContext());
-				replaceCharStyleContextInParagraph(count()-1, elem2->parstyle->charStyleContext());
-			}
-		}
-		len = count();
+		copyRuns(other);
 		cursorPosition = other.cursorPosition;
 		pstyleContext.invalidate();
 //			qDebug() << QString("StoryText::copy: %1 align=%2 %3").arg(trailingStyle.parentStyle()->name())
@@ -101,8 +93,325 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 ScText_Shared::~ScText_Shared() 
 {
 //		qDebug() << QString("~ScText_Shared() %1").arg(reinterpret_cast<uint>(this));
-	while (!this->isEmpty())
-		delete this->takeFirst(); 
+	qDeleteAll(m_runs);
+}
+
+void ScText_Shared::copyRuns(const ScText_Shared& other)
+{
+	m_text = other.m_text;
+	m_flags = other.m_flags;
+	m_runStarts = other.m_runStarts;
+	m_parseps = other.m_parseps;
+	len = m_text.length();
+	m_runs.reserve(other.m_runs.count());
+	for (int i = 0; i < other.m_runs.count(); ++i)
+		m_runs.append(new ScText(*other.m_runs.at(i)));
+
+	// let the runs of each paragraph look up defaults in the copied paragraph style
+	int paragraphStart = 0;
+	for (int i = 0; i < m_runs.count(); ++i)
+	{
+		ScText* elem = m_runs.at(i);
+		if (!elem->parstyle)
+			continue;
+		elem->parstyle->setContext( & pstyleContext);
+		for (int j = paragraphStart; j <= i; ++j)
+			m_runs.at(j)->setContext(elem->parstyle->charStyleContext());
+		paragraphStart = i + 1;
+	}
+	for (int j = paragraphStart; j < m_runs.count(); ++j)
+		m_runs.at(j)->setContext(trailingStyle.charStyleContext());
+}
+
+int ScText_Shared::runIndex(int pos) const
+{
+	assert (pos >= 0);
+	assert (pos < static_cast<int>(len));
+	return static_cast<int>(std::upper_bound(m_runStarts.constBegin(), m_runStarts.constEnd(), pos) - m_runStarts.constBegin()) - 1;
+}
+
+int ScText_Shared::parsepsBefore(int pos) const
+{
+	return static_cast<int>(std::lower_bound(m_parseps.constBegin(), m_parseps.constEnd(), pos) - m_parseps.constBegin());
+}
+
+int ScText_Shared::nextParsep(int pos) const
+{
+	int index = parsepsBefore(pos);
+	return (index < m_parseps.count()) ? m_parseps.at(index) : -1;
+}
+
+int ScText_Shared::prevParsep(int pos) const
+{
+	int index = parsepsBefore(pos);
+	return (index > 0) ? m_parseps.at(index - 1) : -1;
+}
+
+const CharStyle& ScText_Shared::computedCharStyle(int index) const
+{
+	ScText* run = m_runs.at(index);
+	if (run->computed < 0)
+		run->computed = m_computedChars.intern(*run);
+	return m_computedChars.at(run->computed);
+}
+
+const ParagraphStyle& ScText_Shared::computedParagraphStyle(int index) const
+{
+	if (index < 0)
+	{
+		if (m_trailingComputed < 0)
+			m_trailingComputed = m_computedPars.intern(trailingStyle);
+		return m_computedPars.at(m_trailingComputed);
+	}
+	ScText* run = m_runs.at(index);
+	assert(run->parstyle);
+	if (run->computedPar < 0)
+		run->computedPar = m_computedPars.intern(*run->parstyle);
+	return m_computedPars.at(run->computedPar);
+}
+
+void ScText_Shared::resetComputedStyles(int first, int last, bool trailing)
+{
+	for (int i = first; i <= last; ++i)
+	{
+		m_runs.at(i)->computed = -1;
+		m_runs.at(i)->computedPar = -1;
+	}
+	if (trailing)
+		m_trailingComputed = -1;
+}
+
+bool ScText_Shared::refreshComputedStyles(int& firstItem, int& endItem)
+{
+	firstItem = len;
+	endItem = 0;
+
+	// Paragraphs first: validating a paragraph style updates the context of its chars.
+	// As equal values share an entry, an unchanged index means unchanged values.
+	int paraStart = 0;
+	for (int i = 0; i < m_runs.count(); ++i)
+	{
+		ScText* run = m_runs.at(i);
+		if (!run->parstyle)
+			continue;
+		run->parstyle->charStyleContext()->invalidate();
+		int oldIndex = run->computedPar;
+		run->computedPar = m_computedPars.intern(*run->parstyle);
+		if (run->computedPar != oldIndex)
+		{
+			firstItem = qMin(firstItem, paraStart);
+			endItem = qMax(endItem, runEnd(i));
+		}
+		paraStart = runEnd(i);
+	}
+	trailingStyle.charStyleContext()->invalidate();
+	int oldTrailing = m_trailingComputed;
+	m_trailingComputed = m_computedPars.intern(trailingStyle);
+	if (m_trailingComputed != oldTrailing && paraStart < static_cast<int>(len))
+	{
+		firstItem = qMin(firstItem, paraStart);
+		endItem = len;
+	}
+
+	for (int i = 0; i < m_runs.count(); ++i)
+	{
+		ScText* run = m_runs.at(i);
+		int oldIndex = run->computed;
+		run->computed = m_computedChars.intern(*run);
+		if (run->computed != oldIndex)
+		{
+			firstItem = qMin(firstItem, runStart(i));
+			endItem = qMax(endItem, runEnd(i));
+		}
+	}
+	return firstItem < endItem;
+}
+
+void ScText_Shared::insertText(int pos, const QString& txt)
+{
+	int count = txt.length();
+	m_text.insert(pos, txt);
+	m_flags.insert(pos, QByteArray(count, '\0'));
+	len = m_text.length();
+
+	int index = parsepsBefore(pos);
+	for (int i = index; i < m_parseps.count(); ++i)
+		m_parseps[i] += count;
+	int i = txt.indexOf(SpecialChars::PARSEP);
+	while (i >= 0)
+	{
+		m_parseps.insert(index++, pos + i);
+		i = txt.indexOf(SpecialChars::PARSEP, i + 1);
+	}
+}
+
+void ScText_Shared::removeText(int pos, int count)
+{
+	m_text.remove(pos, count);
+	m_flags.remove(pos, count);
+	len = m_text.length();
+
+	int first = parsepsBefore(pos);
+	int last = parsepsBefore(pos + count);
+	m_parseps.remove(first, last - first);
+	for (int i = first; i < m_parseps.count(); ++i)
+		m_parseps[i] -= count;
+}
+
+bool ScText_Shared::isObjectRun(int index) const
+{
+	const ScText* elem = m_runs.at(index);
+	return elem->embedded != 0 || elem->mark != nullptr || m_text.at(m_runStarts.at(index)) == SpecialChars::OBJECT;
+}
+
+bool ScText_Shared::endsParagraph(int index) const
+{
+	return m_runs.at(index)->parstyle != nullptr || m_text.at(runEnd(index) - 1) == SpecialChars::PARSEP;
+}
+
+bool ScText_Shared::canExtendRun(int index, const ScText& style) const
+{
+	if (index < 0 || index >= m_runs.count())
+		return false;
+	if (isObjectRun(index))
+		return false;
+	const ScText* elem = m_runs.at(index);
+	return elem->context() == style.context() && *elem == style;
+}
+
+int ScText_Shared::splitRun(int pos)
+{
+	if (pos >= static_cast<int>(len))
+		return m_runs.count();
+	int index = runIndex(pos);
+	if (m_runStarts.at(index) == pos)
+		return index;
+
+	// the paragraph style stays with the parsep at the end of the run
+	ScText* head = m_runs.at(index);
+	ParagraphStyle* parstyle = head->parstyle;
+	head->parstyle = nullptr;
+	ScText* tail = new ScText(*head);
+	tail->parstyle = parstyle;
+	m_runs.insert(index + 1, tail);
+	m_runStarts.insert(index + 1, pos);
+	return index + 1;
+}
+
+void ScText_Shared::mergeRuns(int first, int last)
+{
+	first = qMax(first, 0);
+	last = qMin(last, m_runs.count() - 1);
+	for (int i = last; i > first; --i)
+	{
+		if (endsParagraph(i - 1) || isObjectRun(i) || !canExtendRun(i - 1, *m_runs.at(i)))
+			continue;
+		ScText* left = m_runs.at(i - 1);
+		ScText* right = m_runs.takeAt(i);
+		left->parstyle = right->parstyle;
+		right->parstyle = nullptr;
+		delete right;
+		m_runStarts.remove(i);
+	}
+}
+
+void ScText_Shared::insertChars(int pos, const QString& txt, const ScText& style)
+{
+	assert (pos >= 0);
+	assert (pos <= static_cast<int>(len));
+
+	int count = txt.length();
+	if (count == 0)
+		return;
+
+	bool plainText = !txt.contains(SpecialChars::PARSEP) && !txt.contains(SpecialChars::OBJECT);
+	if (plainText && pos > 0 && pos < static_cast<int>(len))
+	{
+		// typing inside a run with the same style
+		int index = runIndex(pos);
+		if (m_runStarts.at(index) < pos && canExtendRun(index, style))
+		{
+			insertText(pos, txt);
+			for (int i = index + 1; i < m_runStarts.count(); ++i)
+				m_runStarts[i] += count;
+			return;
+		}
+	}
+
+	int index = splitRun(pos);
+	insertText(pos, txt);
+	for (int i = index; i < m_runStarts.count(); ++i)
+		m_runStarts[i] += count;
+
+	// the inserted chars belong to the run before them until a new run is started
+	int start = 0;
+	while (start < count)
+	{
+		int end = start + 1;
+		if (txt.at(start) != SpecialChars::OBJECT && txt.at(start) != SpecialChars::PARSEP)
+		{
+			while (end < count && txt.at(end) != SpecialChars::OBJECT && txt.at(end) != SpecialChars::PARSEP)
+				++end;
+			if (end < count && txt.at(end) == SpecialChars::PARSEP)
+				++end;
+		}
+		int piecePos = pos + start;
+		bool isObject = (txt.at(start) == SpecialChars::OBJECT);
+		bool endsPar = (txt.at(end - 1) == SpecialChars::PARSEP);
+		bool extendsLeft = !isObject && index > 0
+				&& m_text.at(piecePos - 1) != SpecialChars::PARSEP
+				&& !m_runs.at(index - 1)->parstyle
+				&& canExtendRun(index - 1, style);
+		if (!extendsLeft)
+		{
+			if (!isObject && !endsPar && end == count && canExtendRun(index, style))
+				m_runStarts[index] = piecePos;
+			else
+			{
+				m_runs.insert(index, new ScText(style));
+				m_runStarts.insert(index, piecePos);
+				++index;
+			}
+		}
+		start = end;
+	}
+}
+
+QList<ScText*> ScText_Shared::removeChars(int pos, int count)
+{
+	QList<ScText*> removed;
+	if (count <= 0)
+		return removed;
+	assert (pos >= 0);
+	assert (pos + count <= static_cast<int>(len));
+
+	int first = splitRun(pos);
+	int last = splitRun(pos + count);
+	for (int i = first; i < last; ++i)
+		removed.append(m_runs.at(i));
+	m_runs.erase(m_runs.begin() + first, m_runs.begin() + last);
+	m_runStarts.remove(first, last - first);
+	for (int i = first; i < m_runStarts.count(); ++i)
+		m_runStarts[i] -= count;
+
+	removeText(pos, count);
+	return removed;
+}
+
+void ScText_Shared::replaceChar(int pos, QChar ch)
+{
+	assert (pos >= 0);
+	assert (pos < static_cast<int>(len));
+
+	if (m_text.at(pos) == SpecialChars::PARSEP && ch != SpecialChars::PARSEP)
+		m_parseps.remove(parsepsBefore(pos));
+	else if (m_text.at(pos) != SpecialChars::PARSEP && ch == SpecialChars::PARSEP)
+		m_parseps.insert(parsepsBefore(pos), pos);
+	m_text[pos] = ch;
+	if (ch == SpecialChars::PARSEP || ch == SpecialChars::OBJECT)
+		splitRun(pos + 1);
+	if (ch == SpecialChars::OBJECT)
+		splitRun(pos);
 }
 
 /**
@@ -113,29 +422,30 @@ ScText_Shared::~ScText_Shared()
 void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext)
 {
 	assert (pos >= 0);
-	assert (pos <= size());
+	assert (pos <= static_cast<int>(len));
 	
-	if (pos < size())
-		value(pos)->setContext(newContext);
-	for (int i=pos-1; i >=0 ; --i ) 
+	int index = m_runs.count();
+	if (pos < static_cast<int>(len))
+	{
+		index = runIndex(pos);
+		m_runs.at(index)->setContext(newContext);
+	}
+	for (int i = index - 1; i >= 0; --i)
 	{
-		if ( (at(i)->ch) == SpecialChars::PARSEP)
+		if (m_text.at(runEnd(i) - 1) == SpecialChars::PARSEP)
 			break;
-		value(i)->setContext(newContext);
+		m_runs.at(i)->setContext(newContext);
 	}
 #ifndef NDEBUG // skip assertions if we aren't debugging
 	// we are done here but will do a sanity check:
 	// assert that all chars point to the following parstyle
-	QListIterator<ScText*> it( *this );
 	const StyleContext* lastContext = nullptr;
-	while ( it.hasNext() ) {
-		ScText* elem = it.next();
+	for (int i = 0; i < m_runs.count(); ++i)
+	{
+		const ScText* elem = m_runs.at(i);
 		assert( elem );
-		if ( elem->ch.isNull() ) 
-		{
-			// nothing, see code in removeParSep
-		}
-		else if (elem->ch == SpecialChars::PARSEP)
+		assert( runStart(i) < runEnd(i) );
+		if (m_text.at(runEnd(i) - 1) == SpecialChars::PARSEP)
 		{
 			assert( elem->parstyle );
 			if ( lastContext )
@@ -157,4 +467,3 @@ void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleConte
 		assert( lastContext == trailingStyle.charStyleContext() );
 #endif
 }
-
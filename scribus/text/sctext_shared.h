@@ -1,20 +1,33 @@
 #ifndef SCTEXT_SHARED_H
 #define SCTEXT_SHARED_H
 
+#include <QByteArray>
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QVector>
 #include <cassert>
 
 //#include "text/paragraphlayout.h"
+#include "text/computedstyles.h"
 #include "text/frect.h"
 #include "style.h"
+#include "sctextstruct.h"
 #include "styles/charstyle.h"
 #include "styles/paragraphstyle.h"
 #include "styles/stylecontextproxy.h"
 
 
-class SCRIBUS_API ScText_Shared : public QList<ScText*>
+/**
+   Storage of a StoryText.
+
+   The characters are kept in one UTF-16 string and the layout flags in one
+   byte per character. Character styles are kept in runs: a run is a range of
+   characters sharing one ScText. A paragraph separator always ends its run,
+   the ScText of that run holds the paragraph style. Inline objects and marks
+   have a run of their own.
+ */
+class SCRIBUS_API ScText_Shared
 {
 public:
 	ParagraphStyle defaultStyle;
@@ -23,6 +36,11 @@ public:
 	uint len;
 	uint cursorPosition;
 	ParagraphStyle trailingStyle;
+	/**
+	   Changes with every modification of the text or its styles. The upper
+	   half identifies this ScText_Shared, the lower half counts the changes.
+	 */
+	quint64 version;
 	ScText_Shared(const StyleContext* pstyles);	
 
 	ScText_Shared(const ScText_Shared& other);
@@ -32,6 +50,8 @@ public:
 	~ScText_Shared();
 
 	void clear();
+	/// to be called after each modification
+	void touch() { ++version; }
 	
 	/**
 	   A char's stylecontext is the containing paragraph's style, 
@@ -39,6 +59,91 @@ public:
 	   in the parstyle first.
 	 */
 	void replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext);
+
+	const QString& text() const { return m_text; }
+	QChar charAt(int pos) const { return m_text.at(pos); }
+
+	int runCount() const { return m_runs.count(); }
+	/// index of the run containing the char at pos
+	int runIndex(int pos) const;
+	int runStart(int index) const { return m_runStarts.at(index); }
+	int runEnd(int index) const { return (index + 1 < m_runStarts.count()) ? m_runStarts.at(index + 1) : static_cast<int>(len); }
+	ScText* run(int index) const { return m_runs.at(index); }
+	/// style of the char at pos
+	ScText* runAt(int pos) const { return m_runs.at(runIndex(pos)); }
+
+	/**
+	   Makes pos the start of a run and returns the index of that run,
+	   or runCount() if pos is the end of the text.
+	 */
+	int splitRun(int pos);
+	/// merges runs in [first, last] with their predecessor if they have the same style
+	void mergeRuns(int first, int last);
+
+	/// inserts txt with the given style, merging with the neighbour runs where possible
+	void insertChars(int pos, const QString& txt, const ScText& style);
+	/**
+	   Removes count chars. The runs which held them are returned and must be
+	   deleted by the caller, after the paragraph style contexts have been fixed.
+	 */
+	QList<ScText*> removeChars(int pos, int count);
+	/// replaces a char, ParagraphStyle handling is left to the caller
+	void replaceChar(int pos, QChar ch);
+
+	/// number of parseps before pos, ie. the index of the paragraph containing pos
+	int parsepsBefore(int pos) const;
+	int parsepCount() const { return m_parseps.count(); }
+	/// position of the index-th parsep
+	int parsepAt(int index) const { return m_parseps.at(index); }
+	/// position of the first parsep at or after pos, -1 if there is none
+	int nextParsep(int pos) const;
+	/// position of the last parsep before pos, -1 if there is none
+	int prevParsep(int pos) const;
+
+	/**
+	   Computed style of a run, a flattened copy with all values resolved.
+	   Equal styles share one instance.
+	 */
+	const CharStyle& computedCharStyle(int index) const;
+	/// computed style of the parsep run at index, or of the trailing paragraph if index is -1
+	const ParagraphStyle& computedParagraphStyle(int index) const;
+	/// forgets the computed styles of the runs in [first, last] and of the trailing paragraph if requested
+	void resetComputedStyles(int first, int last, bool trailing);
+	/**
+	   Computes the styles of all runs again after the style hierarchy changed.
+	   Returns false if no resolved value changed, otherwise [firstItem, endItem)
+	   covers the chars whose styles changed.
+	 */
+	bool refreshComputedStyles(int& firstItem, int& endItem);
+
+	/// layout flags of a char, only ScStyle_NonUserStyles are stored
+	LayoutFlags layoutFlags(int pos) const { return unpackFlags(m_flags.at(pos)); }
+	void setLayoutFlags(int pos, int flags) { m_flags[pos] = packFlags(flags); }
+
+private:
+	QString m_text;
+	QByteArray m_flags;
+	QList<ScText*> m_runs;
+	QVector<int> m_runStarts;
+	/// sorted positions of all parseps
+	QVector<int> m_parseps;
+	mutable ComputedStyleTable<CharStyle> m_computedChars;
+	mutable ComputedStyleTable<ParagraphStyle> m_computedPars;
+	mutable int m_trailingComputed;
+
+	bool isObjectRun(int index) const;
+	bool endsParagraph(int index) const;
+	/// true if chars with style may be added to the run
+	bool canExtendRun(int index, const ScText& style) const;
+	/// deep copy of other's text and runs, the paragraph styles are set to this' context
+	void copyRuns(const ScText_Shared& other);
+	/// inserts into m_text and m_flags, keeping the parsep positions up to date
+	void insertText(int pos, const QString& txt);
+	void removeText(int pos, int count);
+
+	// ScStyle_NonUserStyles use bit 7 and bits 11 to 14
+	static char packFlags(int flags) { return static_cast<char>((flags & 0x80) | ((flags >> 11) & 0x0F)); }
+	static LayoutFlags unpackFlags(char packed) { return static_cast<LayoutFlags>((packed & 0x80) | ((packed & 0x0F) << 11)); }
 };
 
 #endif /*SCTEXT_SHARED_H*/
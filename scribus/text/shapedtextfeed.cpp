@@ -3,6 +3,7 @@
 
 #include "shapedtextfeed.h"
 #include "shapedtextcache.h"
+#include "layoutprofiler.h"
 
 
 
@@ -54,7 +55,10 @@ ShapedText ShapedTextFeed::getMore(int fromChar, int toChar)
 	if (m_cache != nullptr)
 	{
 		int len = toChar - fromChar;
-		if (!m_cache->contains(fromChar, len))
+		bool cached = m_cache->contains(fromChar, len);
+		if (LayoutProfiler::isEnabled())
+			LayoutProfiler::instance().countLookup(LayoutProfiler::ShapedTextLookup, cached);
+		if (!cached)
 		{
 			m_cache->put(m_shaper.shape(fromChar, toChar));
 		}
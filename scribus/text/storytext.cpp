@@ -329,7 +329,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs, int
 			int index = 0;
 			while ((index < strLen) && ((index + i) < storyLen))
 			{
-				if (qStr.at(index) != d->at(index + i)->ch)
+				if (qStr.at(index) != d->charAt(index + i))
 					break;
 				++index;
 			}
@@ -354,7 +354,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs, int
 			while ((index < strLen) && ((index + i + diacriticsCounter) < storyLen))
 			{
 				const QChar &qChar = qStr.at(index);
-				const QChar &curChar = d->at(index + diacriticsCounter + i)->ch;
+				const QChar curChar = d->charAt(index + diacriticsCounter + i);
 				qCharIsDiacritic   = SpecialChars::isArabicModifierLetter(qChar.unicode()) | (qChar.category() == QChar::Mark_NonSpacing);
 				curCharIsDiacritic = SpecialChars::isArabicModifierLetter(curChar.unicode()) | (curChar.category() == QChar::Mark_NonSpacing);
 				if (qCharIsDiacritic || curCharIsDiacritic)
@@ -377,7 +377,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs, int
 				foundIndex = i;
 				while ((index + i + diacriticsCounter) < storyLen)
 				{
-					const QChar &curChar = d->at(index + diacriticsCounter + i)->ch;
+					const QChar curChar = d->charAt(index + diacriticsCounter + i);
 					if (!SpecialChars::isArabicModifierLetter(curChar.unicode()) && (curChar.category() != QChar::Mark_NonSpacing))
 						break;
 					++diacriticsCounter;
@@ -400,20 +400,14 @@ int StoryText::indexOf(QChar ch, int from, Qt::CaseSensitivity cs) const
 
 	if (cs == Qt::CaseSensitive)
 	{
-		for (int i = from; i < textLength; ++i)
-		{
-			if (d->at(i)->ch == ch)
-			{
-				foundIndex = i;
-				break;
-			}
-		}
+		if (from < textLength)
+			foundIndex = d->text().indexOf(ch, from);
 	}
 	else
 	{
 		for (int i = from; i < textLength; ++i)
 		{
-			if (d->at(i)->ch.toLower() == ch)
+			if (d->charAt(i).toLower() == ch)
 			{
 				foundIndex = i;
 				break;
@@ -505,6 +499,7 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
 void StoryText::insertParSep(int pos)
 {
 	ScText* it = item(pos);
+	assert(d->runEnd(d->runIndex(pos)) == pos + 1);
 	if (!it->parstyle)
 	{
 		it->parstyle = new ParagraphStyle(paragraphStyle(pos+1));
@@ -537,7 +532,7 @@ void StoryText::removeParSep(int pos)
 	}
 	// demote this parsep so the assert code in replaceCharStyleContextInParagraph()
 	// doesn't choke:
-	it->ch = 0;
+	d->replaceChar(pos, QChar());
 	d->replaceCharStyleContextInParagraph(pos, paragraphStyle(pos+1).charStyleContext());
 }
 
@@ -557,12 +552,6 @@ void StoryText::removeChars(int pos, uint len)
 
 	for (int i = pos + static_cast<int>(len) - 1; i >= pos; --i)
 	{
-		ScText *it = d->at(i);
-		if ((it->ch == SpecialChars::PARSEP))
-			removeParSep(i);
-		d->takeAt(i);
-		d->len--;
-		delete it;
 		// #9592 : adjust m_selFirst and m_selLast, those values have to be
 		// consistent in functions such as select()
 		if (i <= m_selLast)
@@ -573,7 +562,18 @@ void StoryText::removeChars(int pos, uint len)
 			d->cursorPosition -= 1;
 	}
 
-	d->len = d->count();
+	bool removesParSep = d->text().midRef(pos, len).contains(SpecialChars::PARSEP);
+	QList<ScText*> removed = d->removeChars(pos, len);
+	// the remaining chars of the first paragraph now belong to the paragraph after the removed chars
+	if (removesParSep)
+		d->replaceCharStyleContextInParagraph(pos, paragraphStyle(pos).charStyleContext());
+	qDeleteAll(removed);
+	if (pos < length())
+	{
+		int index = d->runIndex(pos);
+		d->mergeRuns(index - 1, index);
+	}
+
 	d->cursorPosition = qMin(d->cursorPosition, d->len);
 	if (m_selFirst > m_selLast)
 	{
@@ -591,8 +591,8 @@ void StoryText::trim()
 	int pos = static_cast<int>(length()) - 1;
 	for ( int i = static_cast<int>(length()) - 1; i >= 0; --i )
 	{
-		ScText *it = d->at(i);
-		if ((it->ch == SpecialChars::PARSEP) || (it->ch.isSpace()))
+		QChar ch = d->charAt(i);
+		if ((ch == SpecialChars::PARSEP) || (ch.isSpace()))
 		{
 			pos--;
 			posCount++;
@@ -635,24 +635,30 @@ void StoryText::insertChars(int pos, const QString& txt, bool applyNeighbourStyl
 		clone.setEffects(ScStyle_Default);
 	}
 
-	for (int i = 0; i < txt.length(); ++i)
+	clone.setContext(cStyleContext);
+	insertStyledChars(pos, txt, clone);
+
+	invalidate(pos, pos + txt.length());
+}
+
+void StoryText::insertStyledChars(int pos, const QString& txt, const ScText& style)
+{
+	// paragraph separators get their style when inserted, as if the text was typed
+	int start = 0;
+	while (start < txt.length())
 	{
-		ScText * item = new ScText(clone);
-		item->ch= txt.at(i);
-		item->setContext(cStyleContext);
-		d->insert(pos + i, item);
-		d->len++;
-		if (item->ch == SpecialChars::PARSEP)
+		int end = txt.indexOf(SpecialChars::PARSEP, start);
+		end = (end < 0) ? txt.length() : end + 1;
+		d->insertChars(pos + start, txt.mid(start, end - start), style);
+		if (txt.at(end - 1) == SpecialChars::PARSEP)
 		{
 //			qDebug() << QString("new PARSEP %2 at %1").arg(pos).arg(paragraphStyle(pos).name());
-			insertParSep(pos + i);
+			insertParSep(pos + end - 1);
 		}
-		if (d->cursorPosition >= static_cast<uint>(pos + i))
-			d->cursorPosition += 1;
+		start = end;
 	}
-
-	d->len = d->count();
-	invalidate(pos, pos + txt.length());
+	if (d->cursorPosition >= static_cast<uint>(pos))
+		d->cursorPosition += txt.length();
 }
 
 void StoryText::insertCharsWithSoftHyphens(int pos, const QString& txt, bool applyNeighbourStyle)
@@ -676,40 +682,32 @@ void StoryText::insertCharsWithSoftHyphens(int pos, const QString& txt, bool app
 		clone.setEffects(ScStyle_Default);
 	}
 
+	clone.setContext(cStyleContext);
+
 	int inserted = 0;
+	int chunkStart = 0;
 	for (int i = 0; i < txt.length(); ++i) 
 	{
-		QChar ch = txt.at(i);
-		int  index  = pos + inserted;
-		bool insert = true; 
-		if (ch == SpecialChars::SHYPHEN && index > 0)
-		{
-			ScText* lastItem = this->item(index - 1);
-			// qreal SHY means user provided SHY, single SHY is automatic one
-			if (lastItem->effects() & ScStyle_HyphenationPossible)
-				lastItem->setEffects(lastItem->effects() & ~ScStyle_HyphenationPossible);
-			else
-			{
-				lastItem->setEffects(lastItem->effects() | ScStyle_HyphenationPossible);
-				insert = false;
-			}
-		}
-		if (insert)
+		if (txt.at(i) != SpecialChars::SHYPHEN)
+			continue;
+		int index = pos + inserted + (i - chunkStart);
+		if (index == 0)
+			continue;
+		insertStyledChars(pos + inserted, txt.mid(chunkStart, i - chunkStart), clone);
+		inserted += i - chunkStart;
+		chunkStart = i;
+		// qreal SHY means user provided SHY, single SHY is automatic one
+		if (hasFlag(index - 1, ScLayout_HyphenationPossible))
+			clearFlag(index - 1, ScLayout_HyphenationPossible);
+		else
 		{
-			ScText * item = new ScText(clone);
-			item->ch = ch;
-			item->setContext(cStyleContext);
-			d->insert(index, item);
-			d->len++;
-			if (item->ch == SpecialChars::PARSEP)
-				insertParSep(index);
-			if (d->cursorPosition >= static_cast<uint>(index))
-				d->cursorPosition += 1;
-			++inserted;
+			setFlag(index - 1, ScLayout_HyphenationPossible);
+			chunkStart = i + 1;
 		}
 	}
+	insertStyledChars(pos + inserted, txt.mid(chunkStart), clone);
+	inserted += txt.length() - chunkStart;
 
-	d->len = d->count();
 	invalidate(pos, pos + inserted);
 }
 
@@ -721,14 +719,13 @@ void StoryText::replaceChar(int pos, QChar ch)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	ScText* item = d->at(pos);
-	if (item->ch == ch)
+	if (d->charAt(pos) == ch)
 		return;
 	
-	if (d->at(pos)->ch == SpecialChars::PARSEP)
+	if (d->charAt(pos) == SpecialChars::PARSEP)
 		removeParSep(pos);
-	item->ch = ch;
-	if (d->at(pos)->ch == SpecialChars::PARSEP)
+	d->replaceChar(pos, ch);
+	if (d->charAt(pos) == SpecialChars::PARSEP)
 		insertParSep(pos);
 	
 	invalidate(pos, pos + 1);
@@ -778,14 +775,14 @@ void StoryText::hyphenateWord(int pos, uint len, const char* hyphens)
 //	QString dump("");
 	for (int i=pos; i < pos+signed(len); ++i)
 	{
-//		dump += d->at(i)->ch;
+//		dump += d->charAt(i);
 		if (hyphens && hyphens[i-pos] & 1)
 		{
-			d->at(i)->setEffects(d->at(i)->effects() | ScStyle_HyphenationPossible);
+			d->setLayoutFlags(i, d->layoutFlags(i) | ScLayout_HyphenationPossible);
 //			dump += "-";
 		}
 		else {
-			d->at(i)->setEffects(d->at(i)->effects() & ~ScStyle_HyphenationPossible);
+			d->setLayoutFlags(i, d->layoutFlags(i) & ~ScLayout_HyphenationPossible);
 		}
 	}
 //	qDebug() << QString("st: %1").arg(dump);
@@ -803,7 +800,7 @@ void StoryText::insertObject(int pos, int ob)
 		pos += length()+1;
 
 	insertChars(pos, SpecialChars::OBJECT);
-	const_cast<StoryText *>(this)->d->at(pos)->embedded = ob;
+	d->runAt(pos)->embedded = ob;
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -816,7 +813,7 @@ void StoryText::insertMark(Mark* Mark, int pos)
 		pos = d->cursorPosition;
 
 	insertChars(pos, SpecialChars::OBJECT, false);
-	const_cast<StoryText *>(this)->d->at(pos)->mark = Mark;
+	d->runAt(pos)->mark = Mark;
 }
 
 void StoryText::replaceObject(int pos, int ob)
@@ -825,7 +822,7 @@ void StoryText::replaceObject(int pos, int ob)
 		pos += length()+1;
 
 	replaceChar(pos, SpecialChars::OBJECT);
-	const_cast<StoryText *>(this)->d->at(pos)->embedded = ob;
+	d->runAt(pos)->embedded = ob;
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -836,25 +833,18 @@ int StoryText::length() const
 	return d->len;
 }
 
+quint64 StoryText::version() const
+{
+	return d->version;
+}
+
 QString StoryText::plainText() const
 {
 	if (length() <= 0)
 		return QString();
 
-	QChar   ch;
-	QString result;
-
-	int len = length();
-	result.reserve(len);
-
-	StoryText* that(const_cast<StoryText*>(this));
-	for (int i = 0; i < len; ++i) {
-		ch = that->d->at(i)->ch;
-		if (ch == SpecialChars::PARSEP)
-			ch = QLatin1Char('\n');
-		result += ch;
-	}
-
+	QString result(d->text());
+	result.replace(SpecialChars::PARSEP, QLatin1Char('\n'));
 	return result;
 }
 #if 0
@@ -872,7 +862,7 @@ QChar StoryText::text(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return const_cast<StoryText *>(this)->d->at(pos)->ch;
+	return d->charAt(pos);
 }
 
 QString StoryText::text(int pos, uint len) const
@@ -883,12 +873,7 @@ QString StoryText::text(int pos, uint len) const
 	assert(pos >= 0);
 	assert(pos + signed(len) <= length());
 
-	QString result;
-	StoryText* that(const_cast<StoryText*>(this));
-	for (int i = pos; i < pos+signed(len); ++i)
-		result += that->d->at(i)->ch;
-
-	return result;
+	return d->text().mid(pos, len);
 }
 
 
@@ -920,8 +905,7 @@ InlineFrame StoryText::object(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	return InlineFrame(that->d->at(pos)->embedded);
+	return InlineFrame(d->runAt(pos)->embedded);
 }
 
 
@@ -959,7 +943,7 @@ QString StoryText::textWithSoftHyphens(int pos, uint len) const
 	len = qMin((uint) (length() - pos), len);
 	for (int i = pos; i < pos+signed(len); ++i)
 	{
-		if (this->charStyle(i).effects() & ScStyle_HyphenationPossible 
+		if (hasFlag(i, ScLayout_HyphenationPossible)
 			// duplicate SHYPHEN if already present to indicate a user provided SHYPHEN:
 			|| this->text(i) == SpecialChars::SHYPHEN)
 		{
@@ -981,9 +965,8 @@ bool StoryText::hasObject(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	if (that->d->at(pos)->ch == SpecialChars::OBJECT)
-		return that->d->at(pos)->hasObject(m_doc);
+	if (d->charAt(pos) == SpecialChars::OBJECT)
+		return d->runAt(pos)->hasObject(m_doc);
 	return false;
 }
 
@@ -996,8 +979,7 @@ PageItem* StoryText::getItem(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	return that->d->at(pos)->getItem(m_doc);
+	return d->runAt(pos)->getItem(m_doc);
 }
 
 
@@ -1009,9 +991,8 @@ bool StoryText::hasMark(int pos, Mark* mrk) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	if (that->d->at(pos)->ch == SpecialChars::OBJECT)
-        return that->d->at(pos)->hasMark(mrk);
+	if (d->charAt(pos) == SpecialChars::OBJECT)
+		return d->runAt(pos)->hasMark(mrk);
 	return false;
 }
 
@@ -1023,8 +1004,7 @@ Mark* StoryText::mark(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	return that->d->at(pos)->mark;
+	return d->runAt(pos)->mark;
 }
 
 
@@ -1073,7 +1053,9 @@ void StoryText::replaceMark(int pos, Mark* mrk)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	this->d->at(pos)->mark = mrk;
+	// marks are inline objects and have a run of their own
+	assert(d->charAt(pos) == SpecialChars::OBJECT);
+	d->runAt(pos)->mark = mrk;
 }
 
 
@@ -1096,8 +1078,7 @@ LayoutFlags StoryText::flags(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	return  static_cast<LayoutFlags>((*that->d->at(pos)).effects().value & ScStyle_NonUserStyles);
+	return  static_cast<LayoutFlags>(d->layoutFlags(pos) | (d->runAt(pos)->effects().value & ScStyle_NonUserStyles));
 }
 
 bool StoryText::hasFlag(int pos, LayoutFlags flags) const
@@ -1109,7 +1090,7 @@ bool StoryText::hasFlag(int pos, LayoutFlags flags) const
 	assert(pos < length());
 	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	return (flags & d->at(pos)->effects().value) == flags;
+	return (flags & this->flags(pos)) == flags;
 }
 
 void StoryText::setFlag(int pos, LayoutFlags flags)
@@ -1121,7 +1102,7 @@ void StoryText::setFlag(int pos, LayoutFlags flags)
 	assert(pos < length());
 	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	d->at(pos)->setEffects(flags | d->at(pos)->effects().value);
+	d->setLayoutFlags(pos, flags | d->layoutFlags(pos));
 }
 
 void StoryText::clearFlag(int pos, LayoutFlags flags)
@@ -1132,7 +1113,7 @@ void StoryText::clearFlag(int pos, LayoutFlags flags)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	d->at(pos)->setEffects(~(flags & ScStyle_NonUserStyles) & d->at(pos)->effects().value);
+	d->setLayoutFlags(pos, ~(flags & ScStyle_NonUserStyles) & d->layoutFlags(pos));
 }
 
 
@@ -1163,15 +1144,15 @@ const CharStyle & StoryText::charStyle(int pos) const
 	if (text(pos) == SpecialChars::PARSEP)
 		return paragraphStyle(pos).charStyle();
 	
-	StoryText* that = const_cast<StoryText *>(this);
+	ScText* run = d->runAt(pos);
 
 	if (hasMark(pos))
 	{
 		Mark* mrk = mark(pos);
-		applyMarkCharstyle(mrk, *that->d->at(pos)); // hack to keep note charstyles current
+		applyMarkCharstyle(mrk, *run); // hack to keep note charstyles current
 	}
 	
-	return dynamic_cast<const CharStyle &> (*that->d->at(pos));
+	return dynamic_cast<const CharStyle &> (*run);
 }
 
 const ParagraphStyle & StoryText::paragraphStyle() const
@@ -1179,6 +1160,43 @@ const ParagraphStyle & StoryText::paragraphStyle() const
 	return paragraphStyle(d->cursorPosition);
 }
 
+const CharStyle& StoryText::computedCharStyle(int pos) const
+{
+	if (pos < 0)
+		pos += length();
+
+	assert(pos >= 0);
+	assert(pos <= length());
+
+	if (length() == 0)
+		return defaultStyle().charStyle();
+	if (pos == length())
+		--pos;
+
+	if (text(pos) == SpecialChars::PARSEP)
+		return computedParagraphStyle(pos).charStyle();
+
+	int index = d->runIndex(pos);
+	if (hasMark(pos))
+	{
+		// see charStyle()
+		applyMarkCharstyle(mark(pos), *d->run(index));
+		d->resetComputedStyles(index, index, false);
+	}
+	return d->computedCharStyle(index);
+}
+
+const ParagraphStyle& StoryText::computedParagraphStyle(int pos) const
+{
+	if (pos < 0)
+		pos += length();
+
+	// makes sure the parsep has a style
+	paragraphStyle(pos);
+	int parsep = d->nextParsep(pos);
+	return d->computedParagraphStyle(parsep < 0 ? -1 : d->runIndex(parsep));
+}
+
 const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 {
 	if (pos < 0)
@@ -1194,14 +1212,13 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 //	assert( that->at(pos)->cab < doc->docParagraphStyles.count() );
 //	return doc->docParagraphStyles[that->at(pos)->cab];
 	
-	while (pos < length() && that->d->at(pos)->ch != SpecialChars::PARSEP)
-		++pos;
+	pos = d->nextParsep(pos);
 
-	if (pos >= length())
+	if (pos < 0)
 		return that->d->trailingStyle;
-	if ( !that->d->at(pos)->parstyle )
+	ScText* current = d->runAt(pos);
+	if ( !current->parstyle )
 	{
-		ScText* current = that->d->at(pos);
 		qDebug("inserting default parstyle at %i", pos);
 		current->parstyle = new ParagraphStyle();
 		current->parstyle->setContext( & d->pstyleContext);
@@ -1212,8 +1229,8 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 	else {
 //		qDebug() << QString("using parstyle at %1").arg(pos);
 	}
-	assert (that->d->at(pos)->parstyle);
-	return *that->d->at(pos)->parstyle;
+	assert (current->parstyle);
+	return *current->parstyle;
 }
 
 const ParagraphStyle& StoryText::defaultStyle() const
@@ -1256,10 +1273,12 @@ void StoryText::applyCharStyle(int pos, uint len, const CharStyle& style )
 		return;
 
 //	int lastParStart = pos == 0? 0 : -1;
+	int firstRun = d->splitRun(pos);
+	int endRun = d->splitRun(pos + len);
 	ScText* itText;
-	for (uint i=pos; i < pos+len; ++i)
+	for (int i = firstRun; i < endRun; ++i)
 	{
-		itText = d->at(i);
+		itText = d->run(i);
 		// #6165 : applying style on last character applies style on whole text on next open 
 		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
 			itText->parstyle->charStyle().applyCharStyle(style);*/
@@ -1274,6 +1293,7 @@ void StoryText::applyCharStyle(int pos, uint len, const CharStyle& style )
 		}*/
 		itText->applyCharStyle(style);
 	}
+	d->mergeRuns(firstRun - 1, endRun);
 	// Does not work well, do not reenable before checking #9337, #9376 and #9428
 	/*if (pos + signed(len) == length() && lastParStart >= 0)
 	{
@@ -1297,14 +1317,17 @@ void StoryText::eraseCharStyle(int pos, uint len, const CharStyle& style )
 	if (len == 0)
 		return;
 	
+	int firstRun = d->splitRun(pos);
+	int endRun = d->splitRun(pos + len);
 	ScText* itText;
-	for (uint i=pos; i < pos+len; ++i) {
-		itText = d->at(i);
+	for (int i = firstRun; i < endRun; ++i) {
+		itText = d->run(i);
 		// FIXME?? see #6165 : should we really erase charstyle of paragraph style??
-		if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
+		if (itText->parstyle != nullptr)
 			itText->parstyle->charStyle().eraseCharStyle(style);
 		itText->eraseCharStyle(style);
 	}
+	d->mergeRuns(firstRun - 1, endRun);
 	// Does not work well, do not reenable before checking #9337, #9376 and #9428
 	/*if (pos + signed(len) == length())
 	{
@@ -1322,22 +1345,23 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	assert(pos >= 0);
 	assert(pos <= length());
 
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
-		++i;
+	int i = d->nextParsep(pos);
+	if (i < 0)
+		i = length();
 
 	if (i < length())
 	{
-		if (!d->at(i)->parstyle) {
+		ScText* itText = d->runAt(i);
+		if (!itText->parstyle) {
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
-//			d->at(i)->parstyle->setName( "para(applyStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setName( "cpara(applyStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext() );
+			itText->parstyle = new ParagraphStyle();
+			itText->parstyle->setContext( & d->pstyleContext);
+//			itText->parstyle->setName( "para(applyStyle)" ); // DON'T TRANSLATE
+//			itText->parstyle->charStyle().setName( "cpara(applyStyle)" ); // DON'T TRANSLATE
+//			itText->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext() );
 		}
 //		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->applyStyle(style);
+		itText->parstyle->applyStyle(style);
 	}
 	else {
 		// not happy about this but inserting a new PARSEP makes more trouble
@@ -1346,12 +1370,17 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	}
 	if (rmDirectFormatting)
 	{
-		--i;
-		while (i >= 0 && d->at(i)->ch != SpecialChars::PARSEP)
+		int start = d->prevParsep(i) + 1;
+		if (start < i)
 		{
-			d->at(i)->eraseDirectFormatting();
-			--i;
+			// runs end at the parsep, so its own style is erased as well
+			int firstRun = d->runIndex(start);
+			int lastRun = d->runIndex(i - 1);
+			for (int r = firstRun; r <= lastRun; ++r)
+				d->run(r)->eraseDirectFormatting();
+			d->mergeRuns(firstRun, lastRun + 1);
 		}
+		i = start - 1;
 	}
 	invalidate(pos, qMin(i, length()));
 }
@@ -1364,22 +1393,23 @@ void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
 	assert(pos >= 0);
 	assert(pos <= length());
 		
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
-		++i;
+	int i = d->nextParsep(pos);
+	if (i < 0)
+		i = length();
 
 	if (i < length())
 	{
-		if (!d->at(i)->parstyle) {
+		ScText* itText = d->runAt(i);
+		if (!itText->parstyle) {
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
-//			d->at(i)->parstyle->setName( "para(eraseStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setName( "cpara(eraseStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext());
+			itText->parstyle = new ParagraphStyle();
+			itText->parstyle->setContext( & d->pstyleContext);
+//			itText->parstyle->setName( "para(eraseStyle)" ); // DON'T TRANSLATE
+//			itText->parstyle->charStyle().setName( "cpara(eraseStyle)" ); // DON'T TRANSLATE
+//			itText->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext());
 		}
 		//		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->eraseStyle(style);
+		itText->parstyle->eraseStyle(style);
 	}
 	else {
 		// not happy about this but inserting a new PARSEP makes more trouble
@@ -1409,15 +1439,14 @@ void StoryText::setCharStyle(int pos, uint len, const CharStyle& style)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (uint i=pos; i < pos+len; ++i)
+	int firstRun = d->splitRun(pos);
+	int endRun = d->splitRun(pos + len);
+	for (int i = firstRun; i < endRun; ++i)
 	{
-		itText = d->at(i);
 		// #6165 : applying style on last character applies style on whole text on next open 
-		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
-			itText->parstyle->charStyle() = style;*/
-		itText->setStyle(style);
+		d->run(i)->setStyle(style);
 	}
+	d->mergeRuns(firstRun - 1, endRun);
 	
 	invalidate(pos, pos + len);
 }
@@ -1458,15 +1487,14 @@ void StoryText::replaceNamedResources(ResourceCollection& newNames)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (int i=0; i < len; ++i)
+	for (int i = 0; i < d->runCount(); ++i)
 	{
-		itText = d->at(i);
-		if (itText->parstyle)
-			itText->parstyle->replaceNamedResources(newNames);
-		else
-			itText->replaceNamedResources(newNames);
+		ScText* run = d->run(i);
+		if (run->parstyle)
+			run->parstyle->replaceNamedResources(newNames);
+		run->replaceNamedResources(newNames);
 	}
+	d->mergeRuns(0, d->runCount() - 1);
 	
 	invalidate(0, len);	
 }
@@ -1484,11 +1512,8 @@ void StoryText::fixLegacyFormatting()
 	if (length() == 0)
 		return;
 
-	for (int i = 0; i < length(); ++ i)
-	{
-		if (d->at(i)->ch == SpecialChars::PARSEP)
-			fixLegacyFormatting(i);
-	}
+	for (int i = 0; i < d->parsepCount(); ++i)
+		fixLegacyFormatting(d->parsepAt(i));
 	fixLegacyFormatting( length() );
 }
 
@@ -1503,23 +1528,29 @@ void StoryText::fixLegacyFormatting(int pos)
 	assert(pos >= 0);
 	assert(pos <= length());
 
-	int i = pos;
-	while (i > 0 && d->at(i - 1)->ch != SpecialChars::PARSEP)
-		--i;
+	int start = d->prevParsep(pos) + 1;
 
 	const ParagraphStyle& parStyle = this->paragraphStyle(pos);
 	parStyle.validate();
 
 	if (parStyle.hasParent())
 	{
-		int start = i;
-		while ((i < length()) && (d->at(i)->ch != SpecialChars::PARSEP))
+		int end = d->nextParsep(start);
+		if (end < 0)
+			end = length();
+		if (start < end)
 		{
-			d->at(i)->validate();
-			d->at(i)->eraseCharStyle( parStyle.charStyle() );
-			++i;
+			// the parsep shares the run of the last chars
+			int firstRun = d->runIndex(start);
+			int lastRun = d->runIndex(end - 1);
+			for (int r = firstRun; r <= lastRun; ++r)
+			{
+				d->run(r)->validate();
+				d->run(r)->eraseCharStyle( parStyle.charStyle() );
+			}
+			d->mergeRuns(firstRun, lastRun + 1);
 		}
-		invalidate(start, qMin(i + 1, length()));
+		invalidate(start, qMin(end + 1, length()));
 	}
 }
 
@@ -1530,30 +1561,16 @@ uint StoryText::nrOfParagraph() const
 
 uint StoryText::nrOfParagraph(int pos) const
 {
-	uint result = 0;
-	StoryText* that = const_cast<StoryText *>(this);
-	bool lastWasPARSEP = true;
-	pos = qMin(pos, that->length());
-	for (int i=0; i < pos; ++i)
-	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
-	return result;
+	pos = qMin(pos, length());
+	if (pos <= 0)
+		return 0;
+	return d->parsepsBefore(pos);
 }
 
 uint StoryText::nrOfParagraphs() const
 {
-	uint result = 0;
-	StoryText* that = const_cast<StoryText *>(this);
-	bool lastWasPARSEP = true;
-	for (int i=0; i < length(); ++i)
-	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
+	uint result = d->parsepCount();
+	bool lastWasPARSEP = length() == 0 || d->charAt(length() - 1) == SpecialChars::PARSEP;
 	return lastWasPARSEP ? result : result + 1;
 }
 
@@ -1567,12 +1584,8 @@ int StoryText::startOfParagraph(uint index) const
 	if (index == 0)
 		return 0;
 
-	StoryText* that = const_cast<StoryText *>(this);
-	for (int i=0; i < length(); ++i)
-	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
-			return i + 1;
-	}
+	if (index <= static_cast<uint>(d->parsepCount()))
+		return d->parsepAt(index - 1) + 1;
 	return length();
 }
 
@@ -1583,29 +1596,24 @@ int StoryText::endOfParagraph() const
 
 int StoryText::endOfParagraph(uint index) const
 {
-	++index;
-	StoryText* that = const_cast<StoryText *>(this);
-	for (int i=0; i < length(); ++i)
-	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
-			return i;
-	}
+	if (index < static_cast<uint>(d->parsepCount()))
+		return d->parsepAt(index);
 	return length();
 }
 
 uint StoryText::nrOfRuns() const
 {
-	return length();
+	return d->runCount();
 }
 
 int StoryText::startOfRun(uint index) const
 {
-	return index;
+	return d->runStart(index);
 }
 
 int StoryText::endOfRun(uint index) const
 {
-	return index + 1;
+	return d->runEnd(index);
 }
 
 // positioning. all positioning methods return char positions
@@ -1712,16 +1720,13 @@ int StoryText::nextParagraph(int pos)
 {
 	int len = length();
 	pos = qMin(len, pos+1);
-	while (pos < len && text(pos) != SpecialChars::PARSEP)
-		++pos;
-	return pos;
+	int next = d->nextParsep(pos);
+	return (next < 0) ? len : next;
 }
 int StoryText::prevParagraph(int pos)
 {
 	pos = qMax(0, pos-1);
-	while (pos > 0 && text(pos) != SpecialChars::PARSEP)
-		--pos;
-	return pos;
+	return qMax(0, d->prevParsep(pos + 1));
 }
 
 
@@ -1984,17 +1989,37 @@ void StoryText::invalidateLayout()
 void StoryText::invalidateAll()
 {
 	d->pstyleContext.invalidate();
-    invalidate(0, length());
+	// only text whose resolved styles changed needs a new layout
+	int firstItem, endItem;
+	if (!d->refreshComputedStyles(firstItem, endItem))
+		return;
+	d->touch();
+	if (!signalsBlocked())
+		emit changed(firstItem, endItem);
 }
 
 void StoryText::invalidate(int firstItem, int endItem)
 {
-	for (int i=firstItem; i < endItem; ++i)
+	int lastItem = qMin(endItem, length()) - 1;
+	if (firstItem >= 0 && firstItem <= lastItem)
+	{
+		int endRun = d->runIndex(lastItem);
+		for (int i = d->runIndex(firstItem); i <= endRun; ++i)
+		{
+			ParagraphStyle* par = d->run(i)->parstyle;
+			if (par)
+				par->charStyleContext()->invalidate();
+		}
+	}
+	if (firstItem >= 0 && length() > 0)
 	{
-		ParagraphStyle* par = item(i)->parstyle;
-		if (par)
-			par->charStyleContext()->invalidate();
+		// the chars of a paragraph depend on its style, a removal at the end changes the last one
+		int first = qMin(firstItem, length() - 1);
+		int lastParsep = d->nextParsep(qMax(first, lastItem));
+		int lastRun = (lastParsep < 0) ? d->runCount() - 1 : d->runIndex(lastParsep);
+		d->resetComputedStyles(d->runIndex(d->prevParsep(first) + 1), lastRun, lastParsep < 0);
 	}
+	d->touch();
 	if (!signalsBlocked())
 		emit changed(firstItem, endItem);
 }
@@ -2019,14 +2044,14 @@ void StoryText::validate()
 ScText*  StoryText::item(uint itm)
 {
 	assert( static_cast<int>(itm) < length() );
-	return const_cast<StoryText *>(this)->d->at(itm);
+	return d->runAt(itm);
 }
 
 
 const ScText*  StoryText::item(uint itm) const
 {
 	assert( static_cast<int>(itm) < length() );
-	return const_cast<StoryText *>(this)->d->at(itm);
+	return d->runAt(itm);
 }
 
 
@@ -136,6 +136,12 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO, public ITextSource
 	
  	// Retrieve length of story text
  	int length() const;
+	/**
+	   Changes with each modification of the text, including modifications
+	   through other StoryTexts sharing it and with blocked signals.
+	   Stories which do not share their text never have the same version.
+	 */
+	quint64 version() const;
 
 	// Get content at specific position as plain text
 	// Internal paragraph separator are converted to 
@@ -178,6 +184,11 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO, public ITextSource
 	const ParagraphStyle& paragraphStyle() const;
 	// Get paragraph style at specific position
  	const ParagraphStyle& paragraphStyle(int pos) const;
+	// Get flattened charstyle at specific position, see ScText_Shared::computedCharStyle()
+	// Cheaper to query than charStyle(), but ignores the style hierarchy (no context)
+	const CharStyle& computedCharStyle(int pos) const;
+	// Get flattened paragraph style at specific position
+	const ParagraphStyle& computedParagraphStyle(int pos) const;
  	const ParagraphStyle& defaultStyle() const;
  	void setDefaultStyle(const ParagraphStyle& style);
  	void setCharStyle(int pos, uint len, const CharStyle& style);
@@ -291,6 +302,8 @@ private:
 
 	QString textWithSoftHyphens (int pos, uint len) const;
 	void    insertCharsWithSoftHyphens(int pos, const QString& txt, bool applyNeighbourStyle = false);
+	/// inserts txt with style, creating the paragraph styles of inserted parseps
+	void    insertStyledChars(int pos, const QString& txt, const ScText& style);
 	
  	/// mark these runs as invalid, ie. need itemize and shaping
  	void invalidate(int firstRun, int lastRun);
@@ -8,6 +8,7 @@
 #include "scrptrun.h"
 
 #include "glyphcluster.h"
+#include "layoutprofiler.h"
 #include "pageitem.h"
 #include "scribusdoc.h"
 #include "storytext.h"
@@ -234,7 +235,7 @@ void TextShaper::buildText(int fromPos, int toPos, QVector<int>& smallCaps)
 			}
 		}
 
-		const CharStyle &style = m_story.charStyle(i);
+		const CharStyle &style = m_story.computedCharStyle(i);
 		int effects = style.effects() & ScStyle_UserStyles;
 		bool hasSmallCap = false;
 		if ((effects & ScStyle_AllCaps) || (effects & ScStyle_SmallCaps))
@@ -263,6 +264,7 @@ void TextShaper::buildText(int fromPos, int toPos, QVector<int>& smallCaps)
 
 ShapedText TextShaper::shape(int fromPos, int toPos)
 {
+	LayoutProfileTimer profileTimer(LayoutProfiler::Shaping);
 	m_contextNeeded = false;
 	
 	ShapedText result(ShapedText(&m_story, fromPos, toPos, m_context));
@@ -328,7 +330,7 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 
 	for (const TextRun& textRun : textRuns)
 	{
-		const CharStyle &style = m_story.charStyle(m_textMap.value(textRun.start));
+		const CharStyle &style = m_story.computedCharStyle(m_textMap.value(textRun.start));
 
 		const ScFace &scFace = style.font();
 		hb_font_t *hbFont = reinterpret_cast<hb_font_t*>(scFace.hbFont());
@@ -418,7 +420,7 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 			
 			QChar ch = m_story.text(firstChar);
 			LayoutFlags flags = m_story.flags(firstChar);
-			const CharStyle& charStyle(m_story.charStyle(firstChar));
+			const CharStyle& charStyle(m_story.computedCharStyle(firstChar));
 			const StyleFlag& effects = charStyle.effects();
 
 			QString str = m_text.mid(firstChar, lastChar-firstChar+1);
@@ -0,0 +1,96 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "totalfitbreakcache.h"
+#include "layoutprofiler.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+
+// forget all breaks beyond this number of paragraphs
+static const int MaxParagraphs = 4096;
+
+
+class TotalFitBreakJob : public QRunnable
+{
+public:
+	TotalFitBreakJob(TotalFitBreakCache* cache, quint64 key, const TotalFitBreaker& breaker, const QVector<TotalFitBreaker::Item>& items) :
+		m_cache(cache), m_key(key), m_breaker(breaker), m_items(items) {}
+
+	void run()
+	{
+		m_cache->store(m_key, m_breaker.breaks(m_items));
+		emit m_cache->breaksReady();
+	}
+
+private:
+	TotalFitBreakCache* m_cache;
+	quint64 m_key;
+	TotalFitBreaker m_breaker;
+	QVector<TotalFitBreaker::Item> m_items;
+};
+
+
+TotalFitBreakCache* TotalFitBreakCache::m_instance = nullptr;
+
+TotalFitBreakCache* TotalFitBreakCache::instance()
+{
+	if (m_instance == nullptr)
+		m_instance = new TotalFitBreakCache();
+	return m_instance;
+}
+
+void TotalFitBreakCache::deleteInstance()
+{
+	delete m_instance;
+	m_instance = nullptr;
+}
+
+TotalFitBreakCache::~TotalFitBreakCache()
+{
+	// jobs not started yet are dropped, running ones still emit breaksReady()
+	m_pool.clear();
+	m_pool.waitForDone();
+}
+
+bool TotalFitBreakCache::breaks(const TotalFitBreaker& breaker, const QVector<TotalFitBreaker::Item>& items, QVector<int>& result, bool wait)
+{
+	quint64 key = breaker.key(items);
+	{
+		QMutexLocker locker(&m_mutex);
+		QHash<quint64, QVector<int> >::const_iterator it = m_breaks.constFind(key);
+		if (LayoutProfiler::isEnabled())
+			LayoutProfiler::instance().countLookup(LayoutProfiler::TotalFitLookup, it != m_breaks.constEnd());
+		if (it != m_breaks.constEnd())
+		{
+			result = it.value();
+			return true;
+		}
+		if (!wait)
+		{
+			if (!m_pending.contains(key))
+			{
+				m_pending.insert(key);
+				m_pool.start(new TotalFitBreakJob(this, key, breaker, items));
+			}
+			return false;
+		}
+	}
+	// a pending job may compute the same breaks, that's cheaper than waiting for it
+	result = breaker.breaks(items);
+	store(key, result);
+	return true;
+}
+
+void TotalFitBreakCache::store(quint64 key, const QVector<int>& breaks)
+{
+	QMutexLocker locker(&m_mutex);
+	if (m_breaks.count() >= MaxParagraphs)
+		m_breaks.clear();
+	m_breaks.insert(key, breaks);
+	m_pending.remove(key);
+}
@@ -0,0 +1,68 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef TOTALFITBREAKCACHE_H
+#define TOTALFITBREAKCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QVector>
+
+#include "scribusapi.h"
+#include "text/totalfitbreaker.h"
+
+/**
+   Remembers the breaks TotalFitBreaker found for paragraphs.
+
+   Paragraphs are identified by TotalFitBreaker::key(), so the breaks are
+   reused whenever a paragraph with the same shaped content and line widths
+   is laid out again, e.g. while reflowing frames. Missing breaks are
+   computed by a thread pool of the cache, breaksReady() tells when to lay
+   out again.
+ */
+class SCRIBUS_API TotalFitBreakCache : public QObject
+{
+	Q_OBJECT
+
+	friend class TotalFitBreakJob;
+
+public:
+	static TotalFitBreakCache* instance();
+	/**
+	   Deletes the cache after waiting for the breaks computed in the
+	   background. Must be called before the application quits.
+	 */
+	static void deleteInstance();
+
+	/**
+	   Looks up the breaks for items. If they are unknown they are computed,
+	   in the background unless wait is true. Returns false if the breaks are
+	   not available yet.
+	 */
+	bool breaks(const TotalFitBreaker& breaker, const QVector<TotalFitBreaker::Item>& items, QVector<int>& result, bool wait = false);
+
+signals:
+	/// breaks computed in the background are available, emitted from a worker thread
+	void breaksReady();
+
+private:
+	TotalFitBreakCache() {}
+	~TotalFitBreakCache();
+	void store(quint64 key, const QVector<int>& breaks);
+
+	static TotalFitBreakCache* m_instance;
+
+	QThreadPool m_pool;
+	QMutex m_mutex;
+	QHash<quint64, QVector<int> > m_breaks;
+	QSet<quint64> m_pending;
+};
+
+#endif // TOTALFITBREAKCACHE_H
@@ -0,0 +1,213 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "totalfitbreaker.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QHash>
+#include <cmath>
+
+
+const double TotalFitBreaker::Infinity = 10000.0;
+
+// ratios beyond any tolerance, for lines which can't stretch or shrink
+static const double InfiniteRatio = 1e9;
+
+
+namespace {
+
+/// a feasible break, lines end at position
+struct Node
+{
+	int position;
+	int line;
+	int fitness;
+	// totals of the items up to the first box after the break
+	double width;
+	double stretch;
+	double shrink;
+	double demerits;
+	int previous;
+};
+
+}
+
+
+TotalFitBreaker::Item TotalFitBreaker::box(double width)
+{
+	Item item = { Item::Box, width, 0.0, 0.0, 0.0, false };
+	return item;
+}
+
+TotalFitBreaker::Item TotalFitBreaker::glue(double width, double stretch, double shrink)
+{
+	Item item = { Item::Glue, width, stretch, shrink, 0.0, false };
+	return item;
+}
+
+TotalFitBreaker::Item TotalFitBreaker::penalty(double width, double penalty, bool flagged)
+{
+	Item item = { Item::Penalty, width, 0.0, 0.0, penalty, flagged };
+	return item;
+}
+
+
+TotalFitBreaker::TotalFitBreaker(double firstLineWidth, double lineWidth, double tolerance) :
+	m_firstLineWidth(firstLineWidth),
+	m_lineWidth(lineWidth),
+	m_tolerance(tolerance),
+	m_linePenalty(10.0),
+	m_flaggedDemerits(3000.0),
+	m_fitnessDemerits(100.0)
+{}
+
+
+QVector<int> TotalFitBreaker::breaks(const QVector<Item>& items) const
+{
+	QVector<int> result;
+	int count = items.count();
+	if (count == 0)
+		return result;
+
+	// sums of the items before index
+	QVector<double> sumWidth(count + 1), sumStretch(count + 1), sumShrink(count + 1);
+	sumWidth[0] = sumStretch[0] = sumShrink[0] = 0.0;
+	for (int i = 0; i < count; ++i)
+	{
+		const Item& item = items.at(i);
+		bool isGlue = (item.type == Item::Glue);
+		sumWidth[i + 1] = sumWidth[i] + ((item.type == Item::Penalty) ? 0.0 : item.width);
+		sumStretch[i + 1] = sumStretch[i] + (isGlue ? item.stretch : 0.0);
+		sumShrink[i + 1] = sumShrink[i] + (isGlue ? item.shrink : 0.0);
+	}
+
+	QVector<Node> nodes;
+	QVector<int> active;
+	Node start = { -1, 0, 1, 0.0, 0.0, 0.0, 0.0, -1 };
+	nodes.append(start);
+	active.append(0);
+
+	for (int b = 0; b < count && !active.isEmpty(); ++b)
+	{
+		const Item& item = items.at(b);
+		bool legal = false;
+		if (item.type == Item::Penalty)
+			legal = item.penalty < Infinity;
+		else if (item.type == Item::Glue)
+			legal = (b > 0) && (items.at(b - 1).type == Item::Box);
+		if (!legal)
+			continue;
+
+		bool forced = (item.type == Item::Penalty) && (item.penalty <= -Infinity);
+		double best[4];
+		int bestNode[4];
+		for (int f = 0; f < 4; ++f)
+		{
+			best[f] = 0.0;
+			bestNode[f] = -1;
+		}
+
+		for (int k = 0; k < active.count(); )
+		{
+			const Node& a = nodes.at(active.at(k));
+			double length = sumWidth[b] - a.width;
+			if (item.type == Item::Penalty)
+				length += item.width;
+			double available = (a.line == 0) ? m_firstLineWidth : m_lineWidth;
+			double ratio = 0.0;
+			if (length < available)
+			{
+				double stretch = sumStretch[b] - a.stretch;
+				ratio = (stretch > 0.0) ? (available - length) / stretch : InfiniteRatio;
+			}
+			else if (length > available)
+			{
+				double shrink = sumShrink[b] - a.shrink;
+				ratio = (shrink > 0.0) ? (available - length) / shrink : -InfiniteRatio;
+			}
+
+			if (ratio >= -1.0 && ratio <= m_tolerance)
+			{
+				double demerits = m_linePenalty + 100.0 * std::pow(std::fabs(ratio), 3);
+				demerits *= demerits;
+				if (item.type == Item::Penalty)
+				{
+					if (item.penalty >= 0.0)
+						demerits += item.penalty * item.penalty;
+					else if (!forced)
+						demerits -= item.penalty * item.penalty;
+					if (item.flagged && a.position >= 0 && items.at(a.position).flagged)
+						demerits += m_flaggedDemerits;
+				}
+				int fitness = (ratio < -0.5) ? 0 : ((ratio <= 0.5) ? 1 : ((ratio <= 1.0) ? 2 : 3));
+				if (a.position >= 0 && qAbs(fitness - a.fitness) > 1)
+					demerits += m_fitnessDemerits;
+				demerits += a.demerits;
+				if (bestNode[fitness] < 0 || demerits < best[fitness])
+				{
+					best[fitness] = demerits;
+					bestNode[fitness] = active.at(k);
+				}
+			}
+
+			// no later break can be reached from a
+			if (ratio < -1.0 || forced)
+				active.remove(k);
+			else
+				++k;
+		}
+
+		// totals after the break, glue and penalties at the start of a line are discarded
+		int after = b;
+		while (after < count)
+		{
+			const Item& next = items.at(after);
+			if (next.type == Item::Box || (after > b && next.type == Item::Penalty && next.penalty <= -Infinity))
+				break;
+			++after;
+		}
+		for (int f = 0; f < 4; ++f)
+		{
+			if (bestNode[f] < 0)
+				continue;
+			Node node = { b, nodes.at(bestNode[f]).line + 1, f, sumWidth[after], sumStretch[after], sumShrink[after], best[f], bestNode[f] };
+			nodes.append(node);
+			active.append(nodes.count() - 1);
+		}
+	}
+
+	int last = -1;
+	for (int k = 0; k < active.count(); ++k)
+	{
+		const Node& a = nodes.at(active.at(k));
+		if (a.position == count - 1 && (last < 0 || a.demerits < nodes.at(last).demerits))
+			last = active.at(k);
+	}
+	for (int n = last; n >= 0 && nodes.at(n).position >= 0; n = nodes.at(n).previous)
+		result.prepend(nodes.at(n).position);
+	return result;
+}
+
+
+quint64 TotalFitBreaker::key(const QVector<Item>& items) const
+{
+	// widths are compared with a precision of 1/64 pt
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << qRound64(m_firstLineWidth * 64) << qRound64(m_lineWidth * 64) << qRound64(m_tolerance * 64);
+	for (int i = 0; i < items.count(); ++i)
+	{
+		const Item& item = items.at(i);
+		stream << static_cast<qint8>(item.type) << qRound64(item.width * 64);
+		if (item.type == Item::Glue)
+			stream << qRound64(item.stretch * 64) << qRound64(item.shrink * 64);
+		else if (item.type == Item::Penalty)
+			stream << qRound64(item.penalty) << item.flagged;
+	}
+	return (static_cast<quint64>(qHash(data, 0)) << 32) | qHash(data, 0x9e3779b9u);
+}
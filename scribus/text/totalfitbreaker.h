@@ -0,0 +1,72 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef TOTALFITBREAKER_H
+#define TOTALFITBREAKER_H
+
+#include <QVector>
+
+#include "scribusapi.h"
+
+/**
+   Optimal line breaking of a paragraph after Knuth and Plass.
+
+   The paragraph is described as a sequence of boxes (rigid material), glue
+   (space which may stretch or shrink) and penalties (possible breaks such as
+   hyphenation points). Instead of filling each line as much as possible,
+   the breaks minimizing the total demerits of all lines are chosen, so
+   lines are set evenly. The class only depends on its input and may be used
+   from any thread.
+ */
+class SCRIBUS_API TotalFitBreaker
+{
+public:
+	struct Item
+	{
+		enum Type { Box, Glue, Penalty };
+		Type type;
+		double width;
+		double stretch;
+		double shrink;
+		double penalty;
+		bool flagged;
+	};
+
+	/// penalty value of a forced break, a penalty of -Infinity forces a break, +Infinity forbids it
+	static const double Infinity;
+
+	static Item box(double width);
+	static Item glue(double width, double stretch, double shrink);
+	static Item penalty(double width, double penalty, bool flagged = false);
+
+	/**
+	   \param firstLineWidth available width of the first line
+	   \param lineWidth available width of the other lines
+	   \param tolerance maximum adjustment ratio of a line
+	 */
+	TotalFitBreaker(double firstLineWidth, double lineWidth, double tolerance = 2.0);
+
+	/**
+	   Returns the indices of the items at which lines end, the last one ends
+	   the paragraph. The result is empty if the paragraph can't be set within
+	   the tolerance.
+	 */
+	QVector<int> breaks(const QVector<Item>& items) const;
+
+	/// identifies items and parameters, equal keys give equal breaks
+	quint64 key(const QVector<Item>& items) const;
+
+private:
+	double m_firstLineWidth;
+	double m_lineWidth;
+	double m_tolerance;
+	double m_linePenalty;
+	double m_flaggedDemerits;
+	double m_fitnessDemerits;
+};
+
+#endif // TOTALFITBREAKER_H
@@ -0,0 +1,122 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include "textlayouttask.h"
+
+#include <QElapsedTimer>
+
+#include "pageitem.h"
+#include "scribusdoc.h"
+
+// Time spent laying out per call of next(), short enough to keep the GUI responsive
+static const int layoutSliceMsecs = 20;
+// Time between checks whether layout may go on while it has to wait
+static const int waitIntervalMsecs = 500;
+
+static bool needsLayout(PageItem* item)
+{
+	// laying out the last frame of a chain lays out all invalid frames before it
+	for (PageItem* frame = item; frame != nullptr; frame = frame->prevInChain())
+	{
+		if (frame->invalid)
+			return true;
+	}
+	return false;
+}
+
+
+TextLayoutTask::TextLayoutTask(ScribusDoc* doc) :
+	DeferredTask(doc),
+	m_doc(doc),
+	m_total(0),
+	m_laidOut(0),
+	m_started(false)
+{
+	DeferredTask::init();
+	setObjectName("TextLayoutTask");
+}
+
+TextLayoutTask::~TextLayoutTask()
+{
+	DeferredTask::cleanup();
+}
+
+void TextLayoutTask::addFrames(const QList<PageItem*>& frames)
+{
+	Q_ASSERT(!isFinished());
+	for (int i = 0; i < frames.count(); ++i)
+		m_frames.append(QPointer<PageItem>(frames.at(i)));
+	m_total += frames.count();
+}
+
+int TextLayoutTask::pendingCount() const
+{
+	return m_frames.count();
+}
+
+void TextLayoutTask::start()
+{
+	m_started = true;
+	DeferredTask::start();
+}
+
+void TextLayoutTask::next()
+{
+	// Items must not be touched while the document is being built. While a
+	// symbol or an inline frame is edited, wait instead of switching the item
+	// lists behind the back of the editor in the middle of user actions.
+	if (m_doc->isLoading() || m_doc->symbolEditMode() || m_doc->inlineEditMode())
+	{
+		setNextInterval(waitIntervalMsecs);
+		return;
+	}
+	setNextInterval(0);
+	QElapsedTimer timer;
+	timer.start();
+	while (timer.elapsed() < layoutSliceMsecs)
+	{
+		if (!layoutNextFrame())
+		{
+			DeferredTask::done();
+			return;
+		}
+	}
+	emit progress(m_total > 0 ? (100 * m_laidOut) / m_total : 100);
+}
+
+void TextLayoutTask::layoutRemaining()
+{
+	if (isFinished())
+		return;
+	while (layoutNextFrame())
+		;
+	if (m_started)
+		DeferredTask::done();
+}
+
+bool TextLayoutTask::layoutNextFrame()
+{
+	if (m_frames.isEmpty())
+		return false;
+	PageItem* item = m_frames.takeFirst().data();
+	++m_laidOut;
+	if ((item == nullptr) || !needsLayout(item))
+		return true;
+	// Queued frames are document items, the user may be editing master pages,
+	// a symbol or an inline frame meanwhile. Symbol and inline frame edit mode
+	// point the item and page lists to the edited object.
+	bool wasMasterPageMode = m_doc->masterPageMode();
+	m_doc->setMasterPageMode(false);
+	QList<PageItem*>* items = m_doc->Items;
+	QList<ScPage*>* pages = m_doc->Pages;
+	m_doc->Items = &m_doc->DocItems;
+	m_doc->Pages = &m_doc->DocPages;
+	item->layout();
+	m_doc->Items = items;
+	m_doc->Pages = pages;
+	m_doc->setMasterPageMode(wasMasterPageMode);
+	return true;
+}
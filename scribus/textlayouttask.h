@@ -0,0 +1,63 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef _TEXTLAYOUTTASK_H
+#define _TEXTLAYOUTTASK_H
+
+#include <QList>
+#include <QPointer>
+
+#include "scribusapi.h"
+#include "deferredtask.h"
+
+class PageItem;
+class ScribusDoc;
+
+/*! \brief Lays out text frames of a document in the event loop's idle time.
+Frames added with addFrames() are laid out a few at a time, each frame laying
+out its whole chain. Frames which were laid out meanwhile, e.g. because they
+were drawn, or which were deleted are skipped. Idle time layout waits while
+the document is loading or a symbol or an inline frame is edited.
+Use layoutRemaining() when the layout of all frames is needed right away.
+A TextLayoutTask is single use like any DeferredTask, frames may be added
+until it has finished.
+*/
+class SCRIBUS_API TextLayoutTask : public DeferredTask
+{
+	Q_OBJECT
+
+public:
+	TextLayoutTask(ScribusDoc* doc);
+	~TextLayoutTask();
+
+	//! \brief Queue frames for layout, a frame queued twice is laid out once.
+	void addFrames(const QList<PageItem*>& frames);
+	//! \brief Number of frames still waiting for layout.
+	int pendingCount() const;
+
+public slots:
+	//! \brief Begin laying out in idle time.
+	virtual void start();
+
+	/*! \brief Lay out all remaining frames without returning to the event loop.
+	If the task has been started, it finishes. */
+	void layoutRemaining();
+
+protected slots:
+	virtual void next();
+
+protected:
+	//! \brief Lay out the next queued frame, returns false if there is none left.
+	bool layoutNextFrame();
+
+	ScribusDoc* m_doc;
+	QList<QPointer<PageItem> > m_frames;
+	int m_total;
+	int m_laidOut;
+	bool m_started;
+};
+
+#endif
@@ -102,6 +102,14 @@ bool ScZipHandler::write(const QString& dirName)
 	return (ec == Zip::Ok);
 }
 
+bool ScZipHandler::writeFile(const QString& fileName, const QString& zipDir)
+{
+	if (m_zi == nullptr)
+		return false;
+	Zip::ErrorCode ec = m_zi->addFile(fileName, zipDir);
+	return (ec == Zip::Ok);
+}
+
 bool ScZipHandler::extract(const QString& name, const QString& path, ExtractionOption eo)
 {
 	if (m_uz == nullptr)
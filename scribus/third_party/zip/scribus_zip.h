@@ -43,6 +43,8 @@ class ScZipHandler
 		bool contains(const QString& fileName);
 		bool read(const QString& fileName, QByteArray &buf);
 		bool write(const QString& dirName);
+		/** \brief Add a single file, stored in zipDir inside the archive */
+		bool writeFile(const QString& fileName, const QString& zipDir);
 		bool extract(const QString& name, const QString& path, ExtractionOption eo);
 		QStringList files();
 	private:
@@ -0,0 +1,207 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QEvent>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "layoutprofilepalette.h"
+#include "text/layoutprofiler.h"
+
+namespace
+{
+	enum Column { NameColumn, PageColumn, LayoutsColumn, LinesColumn, TotalColumn, ShapingColumn, BreakingColumn, BoxesColumn, ColumnCount };
+
+	QString milliseconds(qint64 nsecs)
+	{
+		return QString::number(nsecs / 1000000.0, 'f', 2);
+	}
+
+	/// sorts numerical columns by value
+	class ProfileItem : public QTreeWidgetItem
+	{
+	public:
+		ProfileItem(QTreeWidget* parent) : QTreeWidgetItem(parent) {}
+		ProfileItem(QTreeWidgetItem* parent) : QTreeWidgetItem(parent) {}
+
+		bool operator<(const QTreeWidgetItem& other) const
+		{
+			int column = treeWidget() ? treeWidget()->sortColumn() : NameColumn;
+			if (column == NameColumn)
+				return QTreeWidgetItem::operator<(other);
+			return data(column, Qt::UserRole).toDouble() < other.data(column, Qt::UserRole).toDouble();
+		}
+
+		void setValue(int column, const QString& text, double value)
+		{
+			setText(column, text);
+			setData(column, Qt::UserRole, value);
+			setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+		}
+	};
+}
+
+LayoutProfilePalette::LayoutProfilePalette(QWidget* parent) : ScDockPalette(parent, "LayoutProfile", nullptr)
+{
+	setObjectName(QString::fromLocal8Bit("LayoutProfile"));
+	setSizePolicy(QSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum));
+
+	QWidget* container = new QWidget(this);
+	QVBoxLayout* layout = new QVBoxLayout(container);
+	layout->setMargin(3);
+	layout->setSpacing(3);
+
+	QHBoxLayout* buttonLayout = new QHBoxLayout();
+	m_recordButton = new QPushButton(container);
+	m_recordButton->setCheckable(true);
+	m_recordButton->setChecked(LayoutProfiler::isEnabled());
+	buttonLayout->addWidget(m_recordButton);
+	m_resetButton = new QPushButton(container);
+	buttonLayout->addWidget(m_resetButton);
+	buttonLayout->addStretch();
+	layout->addLayout(buttonLayout);
+
+	m_frameView = new QTreeWidget(container);
+	m_frameView->setColumnCount(ColumnCount);
+	m_frameView->setRootIsDecorated(true);
+	m_frameView->setSortingEnabled(true);
+	m_frameView->sortByColumn(TotalColumn, Qt::DescendingOrder);
+	m_frameView->setMinimumSize(QSize(200, 150));
+	layout->addWidget(m_frameView);
+
+	m_summary = new QLabel(container);
+	m_summary->setWordWrap(true);
+	m_summary->setTextInteractionFlags(Qt::TextSelectableByMouse);
+	layout->addWidget(m_summary);
+
+	setWidget(container);
+
+	m_refreshTimer = new QTimer(this);
+	m_refreshTimer->setInterval(1000);
+	connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(updateProfile()));
+	connect(m_recordButton, SIGNAL(toggled(bool)), this, SLOT(setRecording(bool)));
+	connect(m_resetButton, SIGNAL(clicked()), this, SLOT(resetProfile()));
+	if (LayoutProfiler::isEnabled())
+		m_refreshTimer->start();
+
+	languageChange();
+}
+
+void LayoutProfilePalette::changeEvent(QEvent *e)
+{
+	if (e->type() == QEvent::LanguageChange)
+		languageChange();
+	else
+		ScDockPalette::changeEvent(e);
+}
+
+void LayoutProfilePalette::showEvent(QShowEvent *showEvent)
+{
+	ScDockPalette::showEvent(showEvent);
+	updateProfile();
+}
+
+void LayoutProfilePalette::languageChange()
+{
+	setWindowTitle( tr( "Layout Profile" ) );
+	m_recordButton->setText( tr( "&Record" ) );
+	m_recordButton->setToolTip( tr( "Measure the layout of text frames from now on" ) );
+	m_resetButton->setText( tr( "R&eset" ) );
+	m_resetButton->setToolTip( tr( "Forget all measurements" ) );
+
+	QStringList headers;
+	headers << tr("Frame") << tr("Page") << tr("Layouts") << tr("Lines")
+			<< tr("Total ms") << tr("Shaping ms") << tr("Breaking ms") << tr("Boxes ms");
+	m_frameView->setHeaderLabels(headers);
+	updateProfile();
+}
+
+void LayoutProfilePalette::setRecording(bool recording)
+{
+	LayoutProfiler::instance().setEnabled(recording);
+	if (recording)
+		m_refreshTimer->start();
+	else
+		m_refreshTimer->stop();
+	updateProfile();
+}
+
+void LayoutProfilePalette::resetProfile()
+{
+	LayoutProfiler::instance().reset();
+	updateProfile();
+}
+
+void LayoutProfilePalette::updateProfile()
+{
+	if (!isVisible())
+		return;
+	// the scripter may have switched profiling
+	if (m_recordButton->isChecked() != LayoutProfiler::isEnabled())
+	{
+		m_recordButton->setChecked(LayoutProfiler::isEnabled());
+		return;
+	}
+
+	const LayoutProfiler& profiler(LayoutProfiler::instance());
+	QList<LayoutProfiler::FrameProfile> profiles = profiler.frames();
+	m_frameView->setUpdatesEnabled(false);
+	// sorted once all items are updated
+	m_frameView->setSortingEnabled(false);
+	QHash<int, QTreeWidgetItem*> oldItems;
+	oldItems.swap(m_frameItems);
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		const LayoutProfiler::FrameProfile& profile = profiles.at(i);
+		ProfileItem* frameItem = static_cast<ProfileItem*>(oldItems.take(profile.id));
+		if (!frameItem)
+			frameItem = new ProfileItem(m_frameView);
+		m_frameItems.insert(profile.id, frameItem);
+		frameItem->setText(NameColumn, profile.name);
+		frameItem->setValue(PageColumn, profile.page > 0 ? QString::number(profile.page) : QString("-"), profile.page);
+		frameItem->setValue(LayoutsColumn, QString::number(profile.layouts), profile.layouts);
+		frameItem->setValue(LinesColumn, QString::number(profile.lines), profile.lines);
+		frameItem->setValue(TotalColumn, milliseconds(profile.total), profile.total);
+		frameItem->setValue(ShapingColumn, milliseconds(profile.phases[LayoutProfiler::Shaping]), profile.phases[LayoutProfiler::Shaping]);
+		frameItem->setValue(BreakingColumn, milliseconds(profile.phases[LayoutProfiler::Breaking]), profile.phases[LayoutProfiler::Breaking]);
+		frameItem->setValue(BoxesColumn, milliseconds(profile.phases[LayoutProfiler::Boxes]), profile.phases[LayoutProfiler::Boxes]);
+
+		while (frameItem->childCount() > profile.paragraphs.count())
+			delete frameItem->takeChild(frameItem->childCount() - 1);
+		int child = 0;
+		QMap<int, qint64>::const_iterator it;
+		for (it = profile.paragraphs.constBegin(); it != profile.paragraphs.constEnd(); ++it, ++child)
+		{
+			ProfileItem* paragraphItem = (child < frameItem->childCount()) ? static_cast<ProfileItem*>(frameItem->child(child)) : new ProfileItem(frameItem);
+			paragraphItem->setText(NameColumn, tr("Paragraph at %1").arg(it.key()));
+			paragraphItem->setValue(TotalColumn, milliseconds(it.value()), it.value());
+		}
+	}
+	// frames deleted or forgotten by a reset
+	qDeleteAll(oldItems);
+	m_frameView->setSortingEnabled(true);
+	m_frameView->setUpdatesEnabled(true);
+	for (int i = 0; i < ColumnCount; ++i)
+		m_frameView->resizeColumnToContents(i);
+
+	QStringList summary;
+	summary << tr("Hyphenation: %1 ms").arg(milliseconds(profiler.time(LayoutProfiler::Hyphenation)));
+	QStringList lookupNames;
+	lookupNames << tr("Shaped text cache") << tr("Optimal line break cache") << tr("Hyphenated words cache");
+	for (int i = 0; i < LayoutProfiler::LookupCount; ++i)
+	{
+		LayoutProfiler::Lookups lookups = profiler.lookups(static_cast<LayoutProfiler::Lookup>(i));
+		summary << tr("%1: %2 % of %3 lookups").arg(lookupNames.at(i))
+				   .arg(lookups.hitRate() * 100.0, 0, 'f', 1).arg(lookups.hits + lookups.misses);
+	}
+	m_summary->setText(summary.join("\n"));
+}
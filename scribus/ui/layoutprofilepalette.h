@@ -0,0 +1,56 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef LAYOUTPROFILEPALETTE_H
+#define LAYOUTPROFILEPALETTE_H
+
+#include <QHash>
+
+#include "scribusapi.h"
+#include "scdockpalette.h"
+
+class QEvent;
+class QLabel;
+class QPushButton;
+class QTimer;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/*! \brief Shows where text layout spends its time, as recorded by LayoutProfiler.
+Frames are listed slowest first, with their paragraphs as children. */
+class SCRIBUS_API LayoutProfilePalette : public ScDockPalette
+{
+	Q_OBJECT
+
+public:
+	LayoutProfilePalette(QWidget* parent);
+	~LayoutProfilePalette() {};
+
+	virtual void changeEvent(QEvent *e);
+
+public slots:
+	void languageChange();
+	void updateProfile();
+
+protected:
+	virtual void showEvent(QShowEvent *showEvent);
+
+private slots:
+	void setRecording(bool recording);
+	void resetProfile();
+
+private:
+	QTreeWidget* m_frameView;
+	QLabel* m_summary;
+	QPushButton* m_recordButton;
+	QPushButton* m_resetButton;
+	QTimer* m_refreshTimer;
+	/// items of the frames shown by LayoutProfiler::FrameProfile::id, updated in place to keep expansion and selection
+	QHash<int, QTreeWidgetItem*> m_frameItems;
+};
+
+#endif
@@ -29,6 +29,7 @@ void Prefs_ImageCache::languageChange()
 	cacheSizeLimitSpinBox->setToolTip( "<qt>"+ tr("Limit the total size of all files in the image cache directory to this amount")+"</qt>" );
 	cacheEntryLimitSpinBox->setToolTip( "<qt>" + tr( "Limit the number of cache entries to this number" ) + "</qt>" );
 	compressionLevelSpinBox->setToolTip( "<qt>" + tr( "Set the level of compression for images in the cache. Higher values result in smaller cache files but also make writes to the cache slower." ) + "</qt>" );
+	adaptiveSizeCheckBox->setToolTip( "<qt>" + tr( "Keep the cache smaller than the size limit when the images used in recent sessions need less space. The size limit is never exceeded." ) + "</qt>" );
 }
 
 void Prefs_ImageCache::restoreDefaults(struct ApplicationPrefs *prefsData)
@@ -37,6 +38,7 @@ void Prefs_ImageCache::restoreDefaults(struct ApplicationPrefs *prefsData)
 	cacheSizeLimitSpinBox->setValue(prefsData->imageCachePrefs.maxCacheSizeMiB);
 	cacheEntryLimitSpinBox->setValue(prefsData->imageCachePrefs.maxCacheEntries);
 	compressionLevelSpinBox->setValue(prefsData->imageCachePrefs.compressionLevel);
+	adaptiveSizeCheckBox->setChecked(prefsData->imageCachePrefs.adaptiveSize);
 }
 
 void Prefs_ImageCache::saveGuiToPrefs(struct ApplicationPrefs *prefsData) const
@@ -45,5 +47,6 @@ void Prefs_ImageCache::saveGuiToPrefs(struct ApplicationPrefs *prefsData) const
 	prefsData->imageCachePrefs.maxCacheSizeMiB = cacheSizeLimitSpinBox->value();
 	prefsData->imageCachePrefs.maxCacheEntries = cacheEntryLimitSpinBox->value();
 	prefsData->imageCachePrefs.compressionLevel = compressionLevelSpinBox->value();
+	prefsData->imageCachePrefs.adaptiveSize = adaptiveSizeCheckBox->isChecked();
 }
 
@@ -38,6 +38,7 @@ void Prefs_Typography::languageChange()
 	strikeoutLineWidthSpinBox->setToolTip( tr( "Line width expressed as a percentage of the font size" ) );
 	smallcapsScalingSpinBox->setToolTip( tr( "Relative size of the small caps font compared to the normal font" ) );
 	automaticLineSpacingSpinBox->setToolTip( tr( "Percentage increase over the font size for the line spacing" ) );
+	optimalLineBreakingCheckBox->setToolTip( tr( "Choose the line breaks of justified paragraphs for even spacing over the whole paragraph instead of line by line" ) );
 }
 
 void Prefs_Typography::restoreDefaults(struct ApplicationPrefs *prefsData)
@@ -52,6 +53,7 @@ void Prefs_Typography::restoreDefaults(struct ApplicationPrefs *prefsData)
 	strikeoutLineWidthSpinBox->setValue(prefsData->typoPrefs.valueStrikeThruWidth / 10.0);
 	smallcapsScalingSpinBox->setValue(prefsData->typoPrefs.valueSmallCaps);
 	automaticLineSpacingSpinBox->setValue(prefsData->typoPrefs.autoLineSpacing);
+	optimalLineBreakingCheckBox->setChecked(prefsData->typoPrefs.lineBreakMode == TypoPrefs::TotalFitLineBreaking);
 }
 
 void Prefs_Typography::saveGuiToPrefs(struct ApplicationPrefs *prefsData) const
@@ -66,5 +68,6 @@ void Prefs_Typography::saveGuiToPrefs(struct ApplicationPrefs *prefsData) const
 	prefsData->typoPrefs.valueStrikeThruWidth=strikeoutLineWidthSpinBox->value() * 10.0;
 	prefsData->typoPrefs.valueSmallCaps=smallcapsScalingSpinBox->value();
 	prefsData->typoPrefs.autoLineSpacing=automaticLineSpacingSpinBox->value();
+	prefsData->typoPrefs.lineBreakMode=optimalLineBreakingCheckBox->isChecked() ? TypoPrefs::TotalFitLineBreaking : TypoPrefs::GreedyLineBreaking;
 }
 
@@ -436,6 +436,7 @@ void WordAndPara(PageItem* currItem, int *w, int *p, int *c, int *wN, int *pN, i
 
 void ReOrderText(ScribusDoc *currentDoc, ScribusView *view)
 {
+	currentDoc->layoutDeferredTextFrames();
 	double savScale = view->scale();
 	view->setScale(1.0);
 	currentDoc->RePos = true;
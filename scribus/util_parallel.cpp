@@ -0,0 +1,101 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include "util_parallel.h"
+
+namespace
+{
+	struct ParallelForState
+	{
+		std::function<void(int, int)> func;
+		int first { 0 };
+		int last { 0 };
+		int grainSize { 1 };
+		std::atomic<int> next { 0 };
+		std::atomic<int> done { 0 };
+		QMutex mutex;
+		QWaitCondition finished;
+
+		bool runChunk()
+		{
+			int chunkBegin = next.fetch_add(grainSize);
+			if (chunkBegin >= last)
+				return false;
+			int chunkEnd = std::min(chunkBegin + grainSize, last);
+			func(chunkBegin, chunkEnd);
+			int count = chunkEnd - chunkBegin;
+			if (done.fetch_add(count) + count >= last - first)
+			{
+				QMutexLocker locker(&mutex);
+				finished.wakeAll();
+			}
+			return true;
+		}
+	};
+
+	class ParallelForRunnable : public QRunnable
+	{
+	public:
+		explicit ParallelForRunnable(const std::shared_ptr<ParallelForState>& state) : m_state(state) {}
+
+		void run() override
+		{
+			while (m_state->runChunk())
+				;
+		}
+
+	private:
+		std::shared_ptr<ParallelForState> m_state;
+	};
+}
+
+int parallelThreadCount()
+{
+	return std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+}
+
+void parallelFor(int first, int last, int grainSize, const std::function<void(int, int)>& func)
+{
+	if (last <= first)
+		return;
+	grainSize = std::max(1, grainSize);
+	int chunkCount = (last - first + grainSize - 1) / grainSize;
+	int helperCount = std::min(chunkCount, parallelThreadCount()) - 1;
+	if (helperCount <= 0)
+	{
+		func(first, last);
+		return;
+	}
+
+	auto state = std::make_shared<ParallelForState>();
+	state->func = func;
+	state->first = first;
+	state->last = last;
+	state->grainSize = grainSize;
+	state->next = first;
+
+	QThreadPool* pool = QThreadPool::globalInstance();
+	for (int i = 0; i < helperCount; ++i)
+		pool->start(new ParallelForRunnable(state));
+
+	while (state->runChunk())
+		;
+
+	QMutexLocker locker(&state->mutex);
+	while (state->done.load() < last - first)
+		state->finished.wait(&state->mutex);
+}
@@ -0,0 +1,29 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef _UTIL_PARALLEL_H
+#define _UTIL_PARALLEL_H
+
+#include <functional>
+
+#include "scribusapi.h"
+
+/*! \brief Split the range [first, last) into chunks of at most grainSize elements
+   and call func(chunkBegin, chunkEnd) for each chunk using the global thread pool.
+   The calling thread takes part in the work and the function returns once all
+   chunks have been processed. As the caller never waits for a chunk which has not
+   been started yet, it is safe to call this function from a pooled thread.
+   \param first first index of the range
+   \param last index past the end of the range
+   \param grainSize maximum number of elements handled by a single call of func
+   \param func function processing a chunk, must be thread safe
+ */
+void SCRIBUS_API parallelFor(int first, int last, int grainSize, const std::function<void(int, int)>& func);
+
+/*! \brief Number of threads parallelFor() may use, including the calling thread */
+int SCRIBUS_API parallelThreadCount();
+
+#endif